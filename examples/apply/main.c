@@ -0,0 +1,173 @@
+
+/*
+ * Description: Applies a set of changes to a libxante application.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 15:31:02 2026
+ * Project: libxante apply example
+ *
+ * Copyright (c) 2017 All rights reserved
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <collections/collections.h>
+#include <xante/libxante.h>
+
+static void usage(const char *progname)
+{
+    fprintf(stdout, "Usage: %s [OPTIONS]\n\n", progname);
+    fprintf(stdout, "Applies a set of changes to a libxante application "
+                    "without running its UI.\n\n");
+
+    fprintf(stdout, "Options:\n");
+    fprintf(stdout, "  -h\t\t\tShows this help screen.\n");
+    fprintf(stdout, "  -j [filename]\t\tThe application JTF file.\n");
+    fprintf(stdout, "  -c [filename]\t\tThe changes file (JSON or "
+                    "'object_id = value' lines). Default: stdin.\n");
+
+    fprintf(stdout, "  -u [username]\t\tThe username to access the "
+                    "application.\n");
+
+    fprintf(stdout, "  -p [password]\t\tThe username's password.\n");
+    fprintf(stdout, "  -m\t\t\tDisables the application module.\n");
+    fprintf(stdout, "\n");
+}
+
+static char *read_changes(const char *filename)
+{
+    FILE *f = stdin;
+    char *buffer = NULL, *tmp = NULL;
+    size_t length = 0, size = 0, n;
+
+    if (filename != NULL) {
+        f = fopen(filename, "r");
+
+        if (NULL == f) {
+            fprintf(stderr, "Unable to open '%s'\n", filename);
+            return NULL;
+        }
+    }
+
+    do {
+        if (size - length < BUFSIZ) {
+            size += BUFSIZ * 4;
+            tmp = realloc(buffer, size + 1);
+
+            if (NULL == tmp) {
+                free(buffer);
+                buffer = NULL;
+                break;
+            }
+
+            buffer = tmp;
+        }
+
+        n = fread(buffer + length, 1, size - length, f);
+        length += n;
+    } while (n > 0);
+
+    if (buffer != NULL)
+        buffer[length] = '\0';
+
+    if (f != stdin)
+        fclose(f);
+
+    return buffer;
+}
+
+int main(int argc, char **argv)
+{
+    const char *opt = "hj:c:u:p:m\0";
+    int option, ret = 1;
+    char *jtf = NULL, *changes_file = NULL, *username = NULL, *password = NULL,
+         *changes = NULL;
+    enum xante_init_flags flags = XANTE_USE_MODULE;
+    enum xante_return_value status;
+    xante_t *xpp = NULL;
+
+    do {
+        option = getopt(argc, argv, opt);
+
+        switch (option) {
+            case 'h':
+                usage(argv[0]);
+                return 1;
+
+            case 'j':
+                jtf = optarg;
+                break;
+
+            case 'c':
+                changes_file = optarg;
+                break;
+
+            case 'u':
+                username = optarg;
+                flags |= XANTE_USE_AUTH;
+                break;
+
+            case 'p':
+                password = optarg;
+                break;
+
+            case 'm':
+                flags &= ~XANTE_USE_MODULE;
+                break;
+
+            case '?':
+                return -1;
+        }
+    } while (option != -1);
+
+    if (NULL == jtf) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    changes = read_changes(changes_file);
+
+    if (NULL == changes)
+        return 1;
+
+    xpp = xante_init(argv[0], jtf, flags, XANTE_SESSION_SINGLE, username,
+                     password);
+
+    if (NULL == xpp) {
+        fprintf(stderr, "%s\n", xante_strerror(xante_get_last_error()));
+        goto end_block;
+    }
+
+    xante_config_load(xpp);
+    status = xante_manager_apply(xpp, changes);
+
+    if (status == XANTE_RETURN_ERROR)
+        fprintf(stderr, "%s\n", xante_strerror(xante_get_last_error()));
+    else
+        ret = 0;
+
+    xante_uninit(xpp);
+
+end_block:
+    free(changes);
+
+    return ret;
+}
+
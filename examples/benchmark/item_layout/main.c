@@ -0,0 +1,485 @@
+
+/*
+ * Description: Measures walking through the items of large menus with the
+ *              previous and the current struct xante_item layouts.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 21:40:27 2026
+ * Project: libxante item layout benchmark
+ *
+ * Copyright (c) 2017 All rights reserved
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#define DEFAULT_VISITS              (8 * 1024 * 1024)
+#define STRINGS_PER_ITEM            8
+#define STRING_SIZE                 48
+#define ARENA_BLOCK_SIZE            (64 * 1024)
+
+/*
+ * The library structures can't be used here without libcollections, so
+ * these mirror their layouts, with every library object as a pointer.
+ */
+
+struct item_validator {
+    int     type;
+    int     string_length;
+    int     choices;
+    int     min;
+    int     max;
+};
+
+struct ref {
+    void    (*free)(const struct ref *);
+    int     count;
+};
+
+/* struct xante_item before the split, each item allocated on its own */
+struct previous_item {
+    int                     mode;
+    void                    *type;
+    void                    *name;
+    void                    *object_id;
+    void                    *config_block;
+    void                    *config_item;
+    void                    *brief_help;
+    void                    *descriptive_help;
+    void                    *referenced_menu;
+    void                    *default_value;
+    void                    *events;
+    void                    *min;
+    void                    *max;
+    int                     string_length;
+    struct item_validator   validator;
+    void                    *options;
+    void                    *value;
+    void                    *list_items;
+    void                    *checklist_brief_options;
+    void                    *options_index;
+    void                    *selected_options;
+    void                    *form_options;
+    void                    *tasks;
+    int                     widget_checklist_type;
+    int                     widget_type;
+    bool                    flags[4];
+    struct ref              ref;
+    bool                    cancel_update;
+    int                     geometry[2];
+    void                    *label[5];
+    bool                    button[4];
+    void                    *helper[6];
+    int                     behaviour[4];
+    int                     progress[2];
+    void                    *template;
+};
+
+/* struct item_details */
+struct current_details {
+    void                    *label[5];
+    bool                    button[4];
+    void                    *checklist_brief_options;
+    void                    *form_options;
+    void                    *tasks;
+    bool                    flags[4];
+};
+
+/* struct xante_item after the split, allocated from the JTF arena */
+struct current_item {
+    int                     widget_type;
+    int                     mode;
+    void                    *name;
+    void                    *value;
+    void                    *default_value;
+    char                    *display_value;
+    bool                    display_cached;
+    void                    *object_id;
+    void                    *referenced_menu;
+    void                    *type;
+    void                    *list_items;
+    void                    *options_index;
+    void                    *selected_options;
+    int                     widget_checklist_type;
+    bool                    cancel_update;
+    int                     behaviour[4];
+    struct ref              ref;
+    void                    *config_block;
+    void                    *config_item;
+    void                    *brief_help;
+    void                    *descriptive_help;
+    void                    *events;
+    void                    *min;
+    void                    *max;
+    int                     string_length;
+    struct item_validator   validator;
+    void                    *options;
+    int                     geometry[2];
+    int                     progress[2];
+    struct current_details  *details;
+    void                    *helper;
+    bool                    from_arena;
+    void                    *template;
+};
+
+/* A bump allocator working like src/core/arena.c */
+struct arena {
+    char    **blocks;
+    int     total_blocks;
+    size_t  used;
+};
+
+struct menu {
+    void    **items;
+    int     total_items;
+    void    **allocations;
+    int     total_allocations;
+    struct arena arena;
+};
+
+static volatile long sink;
+
+static void usage(const char *progname)
+{
+    fprintf(stdout, "Usage: %s [OPTIONS]\n\n", progname);
+    fprintf(stdout, "Measures how long it takes to walk through the items "
+                    "of large menus.\n\n");
+
+    fprintf(stdout, "Options:\n");
+    fprintf(stdout, "  -h\t\t\tShows this help screen.\n");
+    fprintf(stdout, "  -n [visits]\t\tNumber of items visited for each menu "
+                    "size. Default: %d.\n", DEFAULT_VISITS);
+
+    fprintf(stdout, "\n");
+}
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int cache_misses_open(void)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static void cache_misses_start(int fd)
+{
+    if (fd < 0)
+        return;
+
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+}
+
+static long long cache_misses_stop(int fd)
+{
+    long long misses = -1;
+
+    if (fd < 0)
+        return -1;
+
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+    if (read(fd, &misses, sizeof(misses)) != sizeof(misses))
+        return -1;
+
+    return misses;
+}
+
+static void *arena_alloc(struct arena *arena, size_t size)
+{
+    char **blocks = NULL;
+    void *p = NULL;
+
+    size = (size + 7) & ~7;
+
+    if ((arena->total_blocks == 0) || (arena->used + size > ARENA_BLOCK_SIZE)) {
+        blocks = realloc(arena->blocks,
+                         (arena->total_blocks + 1) * sizeof(char *));
+
+        if (NULL == blocks)
+            return NULL;
+
+        arena->blocks = blocks;
+        arena->blocks[arena->total_blocks] = calloc(1, ARENA_BLOCK_SIZE);
+
+        if (NULL == arena->blocks[arena->total_blocks])
+            return NULL;
+
+        arena->total_blocks++;
+        arena->used = 0;
+    }
+
+    p = arena->blocks[arena->total_blocks - 1] + arena->used;
+    arena->used += size;
+
+    return p;
+}
+
+static void menu_destroy(struct menu *menu)
+{
+    int i;
+
+    for (i = 0; i < menu->total_allocations; i++)
+        free(menu->allocations[i]);
+
+    for (i = 0; i < menu->arena.total_blocks; i++)
+        free(menu->arena.blocks[i]);
+
+    free(menu->arena.blocks);
+    free(menu->allocations);
+    free(menu->items);
+}
+
+/*
+ * The previous parser allocated every item on its own, followed by its own
+ * copy of each of its strings, so items of a menu were spread over the heap.
+ */
+static int previous_menu_create(struct menu *menu, int total_items)
+{
+    struct previous_item *item = NULL;
+    int i, j;
+
+    memset(menu, 0, sizeof(struct menu));
+    menu->items = calloc(total_items, sizeof(void *));
+    menu->allocations = calloc(total_items * (STRINGS_PER_ITEM + 1),
+                               sizeof(void *));
+
+    if ((NULL == menu->items) || (NULL == menu->allocations))
+        return -1;
+
+    for (i = 0; i < total_items; i++) {
+        item = calloc(1, sizeof(struct previous_item));
+
+        if (NULL == item)
+            return -1;
+
+        item->widget_type = i % 16;
+        item->mode = i % 3;
+        item->value = item;
+        menu->allocations[menu->total_allocations++] = item;
+        menu->items[menu->total_items++] = item;
+
+        for (j = 0; j < STRINGS_PER_ITEM; j++) {
+            menu->allocations[menu->total_allocations] = malloc(STRING_SIZE);
+
+            if (NULL == menu->allocations[menu->total_allocations])
+                return -1;
+
+            menu->total_allocations++;
+        }
+
+        item->name = menu->allocations[menu->total_allocations - 1];
+    }
+
+    return 0;
+}
+
+/*
+ * The current parser allocates an item and its details from the JTF arena,
+ * with its strings kept apart inside the intern table.
+ */
+static int current_menu_create(struct menu *menu, int total_items)
+{
+    struct current_item *item = NULL;
+    int i;
+
+    memset(menu, 0, sizeof(struct menu));
+    menu->items = calloc(total_items, sizeof(void *));
+
+    if (NULL == menu->items)
+        return -1;
+
+    for (i = 0; i < total_items; i++) {
+        item = arena_alloc(&menu->arena, sizeof(struct current_item));
+
+        if (NULL == item)
+            return -1;
+
+        item->details = arena_alloc(&menu->arena,
+                                    sizeof(struct current_details));
+
+        if (NULL == item->details)
+            return -1;
+
+        item->widget_type = i % 16;
+        item->mode = i % 3;
+        item->value = item;
+        item->name = item;
+        menu->items[menu->total_items++] = item;
+    }
+
+    return 0;
+}
+
+/* What a menu does with each of its items when it's displayed */
+static long previous_walk(const struct menu *menu)
+{
+    const struct previous_item *item = NULL;
+    long s = 0;
+    int i;
+
+    for (i = 0; i < menu->total_items; i++) {
+        item = menu->items[i];
+
+        if ((item->mode != 0) && (item->name != NULL))
+            s += item->widget_type + (item->value != NULL);
+    }
+
+    return s;
+}
+
+static long current_walk(const struct menu *menu)
+{
+    const struct current_item *item = NULL;
+    long s = 0;
+    int i;
+
+    for (i = 0; i < menu->total_items; i++) {
+        item = menu->items[i];
+
+        if ((item->mode != 0) && (item->name != NULL))
+            s += item->widget_type + (item->value != NULL);
+    }
+
+    return s;
+}
+
+static void measure(const struct menu *menu, long (*walk)(const struct menu *),
+    int passes, int fd, double *ns, double *misses)
+{
+    long long m;
+    double t;
+    int i;
+
+    /* Warms up the caches, as a menu displayed again would */
+    sink = walk(menu);
+    cache_misses_start(fd);
+    t = now();
+
+    for (i = 0; i < passes; i++)
+        sink = walk(menu);
+
+    *ns = (now() - t) / ((double)passes * menu->total_items);
+    m = cache_misses_stop(fd);
+    *misses = (m < 0) ? -1 : (double)m / ((double)passes * menu->total_items);
+}
+
+static void run(int total_items, int visits, int fd)
+{
+    struct menu previous, current;
+    double previous_ns, current_ns, previous_misses, current_misses;
+    int passes;
+
+    passes = visits / total_items;
+
+    if (passes <= 0)
+        passes = 1;
+
+    if ((previous_menu_create(&previous, total_items) < 0) ||
+        (current_menu_create(&current, total_items) < 0))
+    {
+        fprintf(stderr, "Not enough memory for %d items\n", total_items);
+        goto end_block;
+    }
+
+    measure(&previous, previous_walk, passes, fd, &previous_ns,
+            &previous_misses);
+
+    measure(&current, current_walk, passes, fd, &current_ns, &current_misses);
+
+    fprintf(stdout, "%10d %14.3f %14.3f %14.3f %14.3f\n", total_items,
+            previous_ns, current_ns, previous_misses, current_misses);
+
+end_block:
+    menu_destroy(&previous);
+    menu_destroy(&current);
+}
+
+int main(int argc, char **argv)
+{
+    const char *opt = "hn:";
+    int option, visits = DEFAULT_VISITS, total_items, fd;
+
+    do {
+        option = getopt(argc, argv, opt);
+
+        switch (option) {
+            case 'h':
+                usage(argv[0]);
+                return 1;
+
+            case 'n':
+                visits = atoi(optarg);
+                break;
+
+            case '?':
+                return -1;
+        }
+    } while (option != -1);
+
+    if (visits <= 0) {
+        usage(argv[0]);
+        return -1;
+    }
+
+    fd = cache_misses_open();
+
+    if (fd < 0)
+        fprintf(stderr, "Cache misses can't be counted here, they'll be "
+                        "shown as -1.\n");
+
+    fprintf(stdout, "Item size: %zu bytes (previous), %zu + %zu bytes "
+                    "(current)\n\n", sizeof(struct previous_item),
+                    sizeof(struct current_item),
+                    sizeof(struct current_details));
+
+    fprintf(stdout, "per item   %14s %14s %14s %14s\n", "ns (old)",
+            "ns (new)", "misses (old)", "misses (new)");
+
+    for (total_items = 256; total_items <= 1024 * 1024; total_items *= 4)
+        run(total_items, visits, fd);
+
+    if (fd >= 0)
+        close(fd);
+
+    return 0;
+}
+
@@ -0,0 +1,243 @@
+
+/*
+ * Description: Measures the dlgx line delimiters scanner against the
+ *              previous per-line implementation.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 20:55:12 2026
+ * Project: libxante line scan benchmark
+ *
+ * Copyright (c) 2017 All rights reserved
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "line_scan.h"
+
+#define DEFAULT_ITERATIONS          200
+#define LINE_BREAK                  '^'
+
+static void usage(const char *progname)
+{
+    fprintf(stdout, "Usage: %s [OPTIONS]\n\n", progname);
+    fprintf(stdout, "Measures how long it takes to find the line breaks "
+                    "of dialog texts.\n\n");
+
+    fprintf(stdout, "Options:\n");
+    fprintf(stdout, "  -h\t\t\tShows this help screen.\n");
+    fprintf(stdout, "  -n [iterations]\tNumber of runs of each text size. "
+                    "Default: %d.\n", DEFAULT_ITERATIONS);
+
+    fprintf(stdout, "  -l [length]\t\tAverage line length. Default: 60.\n");
+    fprintf(stdout, "\n");
+}
+
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* A random text with lines of about @line_length characters */
+static char *create_text(size_t size, int line_length)
+{
+    char *text = NULL;
+    size_t i;
+
+    text = malloc(size + 1);
+
+    if (NULL == text)
+        return NULL;
+
+    for (i = 0; i < size; i++) {
+        if ((rand() % line_length) == 0)
+            text[i] = ((rand() % 4) == 0) ? LINE_BREAK : '\n';
+        else
+            text[i] = 'a' + (rand() % 26);
+    }
+
+    text[size] = '\0';
+
+    return text;
+}
+
+/*
+ * The previous implementation: the offsets table was reallocated once per
+ * line break found.
+ */
+static int previous_line_offsets(const char *text, int **offsets)
+{
+    int l = 0;
+    size_t i, len;
+
+    len = strlen(text);
+    *offsets = realloc(*offsets, (l + 1) * sizeof(int));
+    (*offsets)[0] = 0;
+
+    for (i = 0; i < len; i++)
+        if (text[i] == '\n') {
+            *offsets = realloc(*offsets, (l + 2) * sizeof(int));
+            (*offsets)[l + 1] = i + 1;
+            l++;
+        }
+
+    return l;
+}
+
+/*
+ * The previous implementation: the text was duplicated and scanned once per
+ * delimiter.
+ */
+static int previous_count_delimiters(const char *text)
+{
+    char *tmp = strdup(text);
+    int c = 0;
+    size_t i;
+
+    for (i = 0; tmp[i] != '\0'; i++)
+        if (tmp[i] == '\n')
+            c++;
+
+    for (i = 0; tmp[i] != '\0'; i++)
+        if (tmp[i] == LINE_BREAK)
+            c++;
+
+    free(tmp);
+
+    return c;
+}
+
+static int current_line_offsets(const char *text, int **offsets)
+{
+    struct dlgx_line_scan scan = { NULL, 0, 0 };
+    int l;
+
+    dlgx_line_scan_push(&scan, 0);
+    l = dlgx_scan_delimiters(text, strlen(text), '\n', '\n', &scan);
+    free(*offsets);
+    *offsets = scan.offsets;
+
+    return l;
+}
+
+static int current_count_delimiters(const char *text)
+{
+    return dlgx_scan_delimiters(text, strlen(text), '\n', LINE_BREAK, NULL);
+}
+
+static void run(size_t size, int line_length, int iterations)
+{
+    char *text = NULL;
+    int *offsets = NULL, i, expected, found = 0;
+    double t, previous_offsets, current_offsets, previous_count,
+           current_count;
+
+    text = create_text(size, line_length);
+
+    if (NULL == text)
+        return;
+
+    t = now();
+
+    for (i = 0; i < iterations; i++)
+        expected = previous_line_offsets(text, &offsets);
+
+    previous_offsets = (now() - t) / iterations;
+    t = now();
+
+    for (i = 0; i < iterations; i++)
+        found = current_line_offsets(text, &offsets);
+
+    current_offsets = (now() - t) / iterations;
+
+    if (found != expected)
+        fprintf(stderr, "Line offsets mismatch: %d != %d\n", found, expected);
+
+    t = now();
+
+    for (i = 0; i < iterations; i++)
+        expected = previous_count_delimiters(text);
+
+    previous_count = (now() - t) / iterations;
+    t = now();
+
+    for (i = 0; i < iterations; i++)
+        found = current_count_delimiters(text);
+
+    current_count = (now() - t) / iterations;
+
+    if (found != expected)
+        fprintf(stderr, "Delimiters mismatch: %d != %d\n", found, expected);
+
+    fprintf(stdout, "%10zu %14.3f %14.3f %14.3f %14.3f\n", size,
+            previous_offsets / size, current_offsets / size,
+            previous_count / size, current_count / size);
+
+    free(offsets);
+    free(text);
+}
+
+int main(int argc, char **argv)
+{
+    const char *opt = "hn:l:";
+    int option, iterations = DEFAULT_ITERATIONS, line_length = 60;
+    size_t size;
+
+    do {
+        option = getopt(argc, argv, opt);
+
+        switch (option) {
+            case 'h':
+                usage(argv[0]);
+                return 1;
+
+            case 'n':
+                iterations = atoi(optarg);
+                break;
+
+            case 'l':
+                line_length = atoi(optarg);
+                break;
+
+            case '?':
+                return -1;
+        }
+    } while (option != -1);
+
+    if ((iterations <= 0) || (line_length <= 0)) {
+        usage(argv[0]);
+        return -1;
+    }
+
+    srand(1);
+    fprintf(stdout, "ns/byte    %14s %14s %14s %14s\n", "offsets (old)",
+            "offsets (new)", "count (old)", "count (new)");
+
+    for (size = 256; size <= 4 * 1024 * 1024; size *= 4)
+        run(size, line_length, iterations);
+
+    return 0;
+}
+
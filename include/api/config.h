@@ -51,7 +51,7 @@ int xante_config_load(xante_t *xpp);
  *
  * @param [in,out] xpp: The main library object.
  *
- * @return On sucess returns 0 or -1 otherwise.
+ * @return On sucess returns 0 or -1 if the file could not be written.
  */
 int xante_config_write(xante_t *xpp);
 
@@ -95,5 +95,26 @@ int xante_env_set_cfg_path(const char *pathname);
  */
 char *xante_env_cfg_path(void);
 
+/**
+ * @name xante_env_set_trace_path
+ * @brief Sets the file where the application startup trace is written.
+ *
+ * Setting it enables the trace, even without the XANTE_TRACE_STARTUP flag.
+ *
+ * @param [in] pathname: The file path.
+ *
+ * @return On success returns 0 or -1 otherwise.
+ */
+int xante_env_set_trace_path(const char *pathname);
+
+/**
+ * @name xante_env_trace_path
+ * @brief Gets the current startup trace file path.
+ *
+ * @return On success returns the path, which must be freed after used, or
+ *         NULL otherwise.
+ */
+char *xante_env_trace_path(void);
+
 #endif
 
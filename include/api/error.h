@@ -85,6 +85,10 @@ enum xante_error_code {
     XANTE_ERROR_JTF_NO_DATA_OBJECT,                 //*
     XANTE_ERROR_UNKNOWN_OBJECT_PREFIX,              //*
     XANTE_ERROR_ITEM_HAS_NO_INTERNAL_VALUE,
+    XANTE_ERROR_INVALID_ITEM_VALUE,                 //*
+    XANTE_ERROR_ITEM_NOT_EDITABLE,                  //*
+    XANTE_ERROR_INVALID_CHANGE_SET,                 //*
+    XANTE_ERROR_CONFIG_NOT_SAVED,                   //*
 
     XANTE_MAX_ERROR_CODE
 };
@@ -124,6 +124,51 @@ int xante_item_update_value(xante_item_t *item, const char *fmt, ...)
  */
 int xante_item_update_value_ex(xante_item_t *item, const char *content);
 
+/**
+ * @name xante_item_cancel_update
+ * @brief Stops a progress or a sync object running for an item.
+ *
+ * The module routine running in background is asked to stop and will not be
+ * called again.
+ *
+ * @param [in] item: The item object.
+ *
+ * @return On success returns 0 or -1 otherwise.
+ */
+int xante_item_cancel_update(xante_item_t *item);
+
+/**
+ * @name xante_item_post_progress
+ * @brief Posts a new progress value to an item running a progress object.
+ *
+ * This function may be called from any thread. The UI only wakes up when a
+ * new value arrives, and several values posted in a short period of time are
+ * displayed with a single redraw.
+ *
+ * @param [in] item: The item object.
+ * @param [in] value: The new progress value. A negative value aborts the
+ *                    progress.
+ *
+ * @return On success returns 0 or -1 otherwise.
+ */
+int xante_item_post_progress(xante_item_t *item, int value);
+
+/**
+ * @name xante_item_validate
+ * @brief Checks if a value may be assigned to an input item object.
+ *
+ * The value is checked against the item constraints from the JTF (ranges,
+ * date and time formats, string length and the options of a list or a
+ * yes/no object), without requiring an UI.
+ *
+ * @param [in] item: The item object.
+ * @param [in] value: The value, as string.
+ *
+ * @return Returns 0 if the value is valid or -1 otherwise, with the reason
+ *         available through xante_strerror.
+ */
+int xante_item_validate(const xante_item_t *item, const char *value);
+
 /**
  * @name xante_item_search
  * @brief Searches for an item inside the application environment.
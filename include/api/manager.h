@@ -64,5 +64,80 @@ enum xante_return_value xante_manager_run(xante_t *xpp);
  */
 enum xante_return_value xante_manager_single_run(xante_t *xpp, const char *jts);
 
+/**
+ * @name xante_manager_apply
+ * @brief Applies a set of changes to an application without running its UI.
+ *
+ * Every change is identified by an item object_id and goes through the same
+ * validation, value confirmation event and dynamic menu updates as if it
+ * had been made by the user. The settings file is written once, at the end,
+ * so this function must be called after xante_config_load and replaces
+ * the xante_config_write call.
+ *
+ * The changes may be a JSON array, such as
+ *
+ *   [ { "object_id": "item_id", "value": "10" }, ... ]
+ *
+ * or "object_id = value" lines, where empty lines, comments (starting with
+ * '#' or ';') and sections are ignored.
+ *
+ * Every change is checked before any of them is kept: the first invalid
+ * one stops the process, the previous ones are undone and nothing is
+ * written. The EV_ITEM_VALUE_UPDATED events are only called once the
+ * whole set is accepted. The settings are released (and EV_CONFIG_UNLOAD
+ * called) in both cases.
+ *
+ * @param [in,out] xpp: The library main object.
+ * @param [in] changes: The change set.
+ *
+ * @return Return an exit value indicating what happened inside (see enum
+ *         xante_return_value declaration). XANTE_RETURN_ERROR is returned
+ *         if a change is refused or if the settings file can't be written.
+ */
+enum xante_return_value xante_manager_apply(xante_t *xpp, const char *changes);
+
+/**
+ * @name xante_manager_register_template
+ * @brief Registers a JTS object to be run later through its name.
+ *
+ * The JTS is parsed only here. Registering a name again replaces its
+ * previous JTS, unless it is running.
+ *
+ * @param [in,out] xpp: The library main object.
+ * @param [in] name: The template name.
+ * @param [in] jts: The JTS object in a string format.
+ *
+ * @return On success returns 0 or -1 otherwise.
+ */
+int xante_manager_register_template(xante_t *xpp, const char *name,
+                                    const char *jts);
+
+/**
+ * @name xante_manager_run_template
+ * @brief Puts a registered JTS object to run with some of its properties
+ *        replaced.
+ *
+ * Any of the arguments may be NULL to keep what the JTS has. The default
+ * value and the options only apply to a JTS with a single item. The options
+ * replace the list of a checklist, radio-checklist or buildlist, and the
+ * text of other objects (one option per line).
+ *
+ * @param [in,out] xpp: The library main object.
+ * @param [in] name: The template name.
+ * @param [in] title: The object (or first menu) title.
+ * @param [in] default_value: The object default value.
+ * @param [in] options: The object options.
+ * @param [in] total_options: The number of options.
+ *
+ * @return Return an exit value indicating what happened inside (see enum
+ *         xante_return_value declaration).
+ */
+enum xante_return_value xante_manager_run_template(xante_t *xpp,
+                                                   const char *name,
+                                                   const char *title,
+                                                   const char *default_value,
+                                                   const char * const *options,
+                                                   int total_options);
+
 #endif
 
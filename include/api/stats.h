@@ -0,0 +1,102 @@
+
+/*
+ * Description: Statistics of the event functions called by an application.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 17:31:48 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef _LIBXANTE_API_STATS_H
+#define _LIBXANTE_API_STATS_H
+
+#ifndef LIBXANTE_COMPILE
+# ifndef _LIBXANTE_H
+#  error "Never use <stats.h> directly; include <libxante.h> instead."
+# endif
+#endif
+
+/**
+ * @name xante_stats_set_log_on_exit
+ * @brief Sets/Unsets the application to write its statistics to the log
+ *        file when it's finished.
+ *
+ * @param [in] xpp: The library main object.
+ * @param [in] log_on_exit: The boolean value to write or not.
+ *
+ * @return On success returns 0 or -1 otherwise.
+ */
+int xante_stats_set_log_on_exit(xante_t *xpp, bool log_on_exit);
+
+/**
+ * @name xante_stats_reset
+ * @brief Discards every statistic accounted so far.
+ *
+ * @param [in] xpp: The library main object.
+ *
+ * @return On success returns 0 or -1 otherwise.
+ */
+int xante_stats_reset(xante_t *xpp);
+
+/**
+ * @name xante_stats_event_calls
+ * @brief Gives how many times the functions of an event were called.
+ *
+ * @param [in] xpp: The library main object.
+ * @param [in] event_name: The event name.
+ *
+ * @return On success returns the number of calls or -1 otherwise.
+ */
+int xante_stats_event_calls(const xante_t *xpp, const char *event_name);
+
+/**
+ * @name xante_stats_event_latency
+ * @brief Gives a percentile of the time spent inside the functions of an
+ *        event.
+ *
+ * The value is approximated, it's the upper limit of the histogram bucket
+ * holding the percentile.
+ *
+ * @param [in] xpp: The library main object.
+ * @param [in] event_name: The event name.
+ * @param [in] percentile: The percentile, from 0 to 100.
+ *
+ * @return On success returns the latency in microseconds or -1 otherwise.
+ */
+long long xante_stats_event_latency(const xante_t *xpp, const char *event_name,
+                                    int percentile);
+
+/**
+ * @name xante_stats_info
+ * @brief Gives all event statistics in a JSON string.
+ *
+ * Every function called from an event has its counters, latencies and
+ * histogram. The number of strings shared between menus and items, and the
+ * memory it saved, are also reported.
+ *
+ * @param [in] xpp: The library main object.
+ *
+ * @return On success returns the JSON string, which must be released with
+ *         free, or NULL otherwise.
+ */
+char *xante_stats_info(const xante_t *xpp);
+
+#endif
+
@@ -0,0 +1,82 @@
+/*
+ * Description: Widgets provided by an application or its modules.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 19:12:37 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef _LIBXANTE_API_WIDGET_H
+#define _LIBXANTE_API_WIDGET_H
+
+#ifndef LIBXANTE_COMPILE
+# ifndef _LIBXANTE_H
+#  error "Never use <widget.h> directly; include <libxante.h> instead."
+# endif
+#endif
+
+/** The functions of a widget registered at runtime */
+struct xante_widget_ops {
+    /*
+     * Displays the widget for @item and returns the selected button. A new
+     * item value may be given back through @result, which is released by
+     * the library.
+     */
+    int     (*run)(xante_t *xpp, xante_item_t *item, cl_string_t **result,
+                   void *data);
+
+    /* Optional. Tells if @result may replace the item value. */
+    bool    (*validate)(xante_t *xpp, xante_item_t *item,
+                        const cl_string_t *result, void *data);
+};
+
+/**
+ * @name xante_widget_register
+ * @brief Registers a new widget type to be used by JTF items.
+ *
+ * Items with @type as their object type are displayed by @ops, like any
+ * builtin widget. A widget may be registered before xante_init or from a
+ * module initialization function. Widgets registered by a module are
+ * unregistered before it's unloaded, when the application finishes.
+ *
+ * @param [in] type: The widget type name, as used inside a JTF.
+ * @param [in] ops: The widget functions.
+ * @param [in] data: Custom data passed to the widget functions.
+ *
+ * @return On success returns the object type of the new widget or -1
+ *         otherwise.
+ */
+int xante_widget_register(const char *type, const struct xante_widget_ops *ops,
+                          void *data);
+
+/**
+ * @name xante_widget_unregister
+ * @brief Unregisters a widget type registered with xante_widget_register.
+ *
+ * Items already using it can't be displayed anymore.
+ *
+ * @param [in] type: The widget type name.
+ *
+ * @return On success returns 0 or -1 otherwise.
+ */
+int xante_widget_unregister(const char *type);
+
+#endif
+
@@ -92,6 +92,11 @@ extern "C" {
 #define XANTE_JTF_LABELS                        "labels"
 #define XANTE_JTF_FILE_REVISION                 "jtf_revision"
 #define XANTE_JTF_LANGUAGE                      "language"
+#define XANTE_JTF_TASKS                         "tasks"
+#define XANTE_JTF_INPUT_CHECK                   "input_check"
+#define XANTE_JTF_DEBOUNCE                      "debounce"
+#define XANTE_JTF_ASYNC                         "async"
+#define XANTE_JTF_ASYNC_EVENTS                  "async_events"
 
 /** String keys of supported menus */
 #define XANTE_STR_DEFAULT_MENU                  "default"
@@ -145,6 +150,8 @@ extern "C" {
 #define XANTE_STR_WIDGET_MIXEDFORM              "mixedform"
 #define XANTE_STR_WIDGET_BUILDLIST              "buildlist"
 #define XANTE_STR_WIDGET_SPREADSHEET            "spreadsheet"
+#define XANTE_STR_WIDGET_MULTI_PROGRESS         "multi-progress"
+#define XANTE_STR_GADGET_PREFIX                 "gadget"
 #define XANTE_STR_GADGET_CLOCK                  "clock"
 
 /** The access mode from a menu or a menu item */
@@ -0,0 +1,35 @@
+
+/*
+ * Description: Non-interactive application of settings changes.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 15:05:10 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+
+#ifndef _LIBXANTE_INTERNAL_APPLY_H
+#define _LIBXANTE_INTERNAL_APPLY_H
+
+/* Internal library declarations */
+int apply_changes(struct xante_app *xpp, const char *changes);
+
+#endif
+
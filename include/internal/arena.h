@@ -0,0 +1,42 @@
+
+/*
+ * Description: A region allocator, where everything is released at once.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 16:12:40 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef _LIBXANTE_INTERNAL_ARENA_H
+#define _LIBXANTE_INTERNAL_ARENA_H
+
+struct arena;
+
+/* Internal library declarations */
+struct arena *arena_create(size_t block_size);
+void arena_destroy(struct arena *arena);
+void *arena_alloc(struct arena *arena, size_t size);
+size_t arena_allocated(const struct arena *arena);
+size_t arena_position(const struct arena *arena);
+void arena_rewind(struct arena *arena, size_t position);
+void arena_reset(struct arena *arena);
+
+#endif
+
@@ -0,0 +1,52 @@
+
+/*
+ * Description: A growable set of bits, indexed by option.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 11:02:18 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef _LIBXANTE_INTERNAL_BITSET_H
+#define _LIBXANTE_INTERNAL_BITSET_H
+
+struct xante_bitset;
+
+/*
+ * Selections up to this number of options keep the int representation used
+ * by older versions, as values and inside settings files.
+ */
+#define BITSET_INT_BITS                 31
+
+/* Internal library declarations */
+struct xante_bitset *bitset_create(int bits);
+void bitset_destroy(struct xante_bitset *bitset);
+int bitset_size(const struct xante_bitset *bitset);
+void bitset_set(struct xante_bitset *bitset, int bit);
+bool bitset_test(const struct xante_bitset *bitset, int bit);
+bool bitset_is_empty(const struct xante_bitset *bitset);
+bool bitset_equals(const struct xante_bitset *a, const struct xante_bitset *b);
+cl_string_t *bitset_to_cstring(const struct xante_bitset *bitset);
+struct xante_bitset *bitset_from_cstring(const cl_string_t *value, int bits);
+bool bitset_validate_cstring(const char *value, int bits);
+int bitset_cstring_to_int(const char *value);
+
+#endif
+
@@ -31,6 +31,7 @@
 bool change_has_occourred(struct xante_app *xpp);
 void change_init(struct xante_app *xpp);
 void change_uninit(struct xante_app *xpp);
+cl_list_t *change_snapshot(struct xante_app *xpp);
 int change_add(struct xante_app *xpp, const char *item_name,
                const char *old_value, const char *new_value);
 
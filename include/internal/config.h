@@ -0,0 +1,37 @@
+
+/*
+ * Description:
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 15:02:44 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+
+#ifndef _LIBXANTE_INTERNAL_CONFIG_H
+#define _LIBXANTE_INTERNAL_CONFIG_H
+
+/* Internal library declarations */
+void config_load_menu(struct xante_app *xpp, struct xante_menu *menu);
+int config_write_changes(struct xante_app *xpp);
+void config_release(struct xante_app *xpp);
+
+#endif
+
@@ -30,8 +30,23 @@
 /* Internal library declarations */
 void dm_init(struct xante_app *xpp, cl_cfg_file_t *cfg_file);
 void dm_uninit(struct xante_app *xpp);
-void dm_update(struct xante_app *xpp, struct xante_item *selected_item);
-void dm_delete(struct xante_menu *rme_menu, int position);
+void dm_lock(const struct xante_app *xpp);
+void dm_unlock(const struct xante_app *xpp);
+void dm_materialize(struct xante_app *xpp, struct xante_menu *menu);
+void dm_materialize_all(struct xante_app *xpp);
+cl_list_node_t *dm_map_menus(const struct xante_app *xpp,
+                             int (*foo)(cl_list_node_t *, void *), void *data);
+
+struct xante_menu *dm_search_menu_by_object_id(const struct xante_app *xpp,
+                                               const char *object_id);
+
+struct xante_menu *dm_search_menu_by_name(const struct xante_app *xpp,
+                                          const char *name);
+
+bool dm_update(struct xante_app *xpp, struct xante_item *selected_item);
+void dm_delete(struct xante_app *xpp, struct xante_menu *rme_menu,
+               int position);
+
 bool dm_insert(struct xante_app *xpp, struct xante_item *item,
                const char *new_entry_name);
 
@@ -31,7 +31,10 @@
 int event_init(struct xante_app *xpp, bool use_event);
 void event_uninit(struct xante_app *xpp);
 int event_call(const char *event_name, struct xante_app *xpp, ...);
+void event_config_unload(struct xante_app *xpp);
+void event_drain(struct xante_app *xpp);
 void *event_item_custom_data(struct xante_app *xpp, struct xante_item *item);
+bool event_item_has(const struct xante_item *item, const char *event_name);
 int event_update_routine(struct xante_app *xpp, struct xante_item *item,
                          void *data);
 
@@ -0,0 +1,51 @@
+
+/*
+ * Description: A pool of worker threads to run background tasks.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 11:02:18 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef _LIBXANTE_INTERNAL_EXECUTOR_H
+#define _LIBXANTE_INTERNAL_EXECUTOR_H
+
+struct xante_task;
+
+/* Internal library declarations */
+int executor_init(struct xante_app *xpp);
+int executor_uninit(struct xante_app *xpp);
+struct xante_task *executor_submit(struct xante_app *xpp,
+                                   void (*run)(struct xante_task *, void *),
+                                   void *data, void (*free_data)(void *));
+
+void task_cancel(struct xante_task *task);
+void task_abandon(struct xante_task *task);
+int task_stop(struct xante_task *task, int timeout);
+bool task_started(struct xante_task *task);
+bool task_runnable(struct xante_task *task);
+bool task_cancelled(struct xante_task *task);
+bool task_set_flag(struct xante_task *task, bool *flag);
+bool task_sleep(struct xante_task *task, int timeout);
+int task_wait(struct xante_task *task, int timeout);
+void task_unref(struct xante_task *task);
+
+#endif
+
@@ -0,0 +1,42 @@
+
+/*
+ * Description: A table of unique strings, shared by every object needing
+ *              them.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 17:03:27 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef _LIBXANTE_INTERNAL_INTERN_H
+#define _LIBXANTE_INTERNAL_INTERN_H
+
+struct intern_table;
+
+/* Internal library declarations */
+struct intern_table *intern_create(void);
+void intern_destroy(struct intern_table *table);
+cl_string_t *intern_string(struct intern_table *table, cl_string_t *s);
+bool intern_equals(const cl_string_t *a, const cl_string_t *b);
+void intern_info(const struct intern_table *table, int *total,
+                 unsigned int *lookups, size_t *saved_bytes);
+
+#endif
+
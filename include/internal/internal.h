@@ -57,6 +57,12 @@
 /** Timeout to close a dialog */
 #define DEFAULT_INACTIVITY_TIMEOUT              120 /* seconds */
 
+/** Time to wait for a cancelled task before leaving it behind */
+#define TASK_STOP_TIMEOUT                       2000 /* milliseconds */
+
+/** Time a dialog waits for its background task to leave the queue */
+#define TASK_START_TIMEOUT                      5 /* seconds */
+
 /** Supported events */
 #define EV_INIT                                 "xapl_init"
 #define EV_UNINIT                               "xapl_uninit"
@@ -67,6 +73,7 @@
 /** Environment variables */
 #define ENV_XANTE_DB_PATH                       "XANTE_DB_PATH"
 #define ENV_XANTE_CFG_PATH                      "XANTE_CFG_PATH"
+#define ENV_XANTE_TRACE_PATH                    "XANTE_TRACE_PATH"
 
 /** Different ways of creating menus */
 enum xante_menu_creator {
@@ -95,6 +102,10 @@ struct xante_info {
     bool    esc_key;
     bool    suspend_key;
     bool    stop_key;
+
+    /* Application events called outside the UI thread */
+    bool    async_changes_saved;
+    bool    async_config_unload;
 };
 
 /** Application runtime information */
@@ -153,56 +164,128 @@ struct window_buttons {
  * much the number of function arguments.
  */
 struct parser_helper {
-    void        *min;
-    void        *max;
-    void        *brief_options_help;
-    void        *options;
-    cl_string_t *default_value;
+    void                *min;
+    void                *max;
+    void                *brief_options_help;
+    void                *options;
+    cl_string_t         *default_value;
+    void                *tasks;
+    struct arena        *arena;
+    struct intern_table *strings;
+};
+
+/*
+ * A channel where an item progress may be pushed from any thread, waking up
+ * the UI only when something changes.
+ */
+struct item_progress {
+    int         fd;
+    int         value;
+};
+
+/* The kind of content an input item accepts. */
+enum validator_type {
+    VALIDATOR_NONE,
+    VALIDATOR_INT,
+    VALIDATOR_FLOAT,
+    VALIDATOR_DATE,
+    VALIDATOR_TIME,
+    VALIDATOR_STRING,
+    VALIDATOR_CHOICE,
+    VALIDATOR_SELECTION
+};
+
+/*
+ * An input item constraints, compiled while loading the JTF so that a
+ * value can be checked straight from its raw buffer.
+ */
+struct item_validator {
+    enum validator_type type;
+    int                 string_length;
+    int                 choices;
+
+    union {
+        struct {
+            int         min;
+            int         max;
+        } i;
+
+        struct {
+            float       min;
+            float       max;
+        } f;
+    } range;
 };
 
 /* This structure holds an item's behaviour while running. */
 struct widget_behaviour {
     bool        skip_config;
+    int         check_debounce;     /** milliseconds */
+    bool        async_check;
+    bool        async_value_updated;
+};
+
+/*
+ * Item information only needed while the item's own dialog is displayed.
+ * It's kept apart from the item so walking through the items of a menu
+ * touches less memory.
+ */
+struct item_details {
+    struct window_labels    label;
+    struct window_buttons   button;
+    cl_stringlist_t         *checklist_brief_options;
+    cl_json_t               *form_options;
+    cl_list_t               *tasks;
+    struct flag_parser      flags;  /* Only read when parsing or saving */
 };
 
 /** UI Menu Item information */
 struct xante_item {
-    /* JTF objects */
+    /* Accessed every time a menu is displayed or has its items checked */
+    enum xante_object       widget_type;
     enum XanteAccessMode    mode;
-    cl_string_t             *type;
     cl_string_t             *name;
+    cl_object_t             *value;
+    cl_object_t             *default_value;
+    char                    *display_value; /* Kept until the value changes */
+    bool                    display_cached;
     cl_string_t             *object_id;
+    cl_string_t             *referenced_menu;
+    cl_string_t             *type;
+    cl_stringlist_t         *list_items;
+    struct option_index     *options_index;
+    struct option_set       *selected_options;
+    int                     widget_checklist_type;
+    bool                    cancel_update;
+    struct widget_behaviour behaviour;
+    struct cl_ref_s         ref;
+
+    /* JTF objects */
     cl_string_t             *config_block;
     cl_string_t             *config_item;
     cl_string_t             *brief_help;
     cl_string_t             *descriptive_help;
-    cl_string_t             *referenced_menu;
-    cl_object_t             *default_value;
     cl_json_t               *events;
 
     /* Ranges */
     cl_object_t             *min;
     cl_object_t             *max;
     int                     string_length;
-    cl_spec_t               *value_spec;
+    struct item_validator   validator;
 
     /* Internal */
     cl_string_t             *options;
-    cl_object_t             *value;
-    cl_stringlist_t         *list_items;
-    cl_stringlist_t         *checklist_brief_options;
-    cl_stringlist_t         *selected_items;
-    cl_json_t               *form_options;
-    int                     widget_checklist_type;
-    enum xante_object       widget_type;
-    struct flag_parser      flags;
-    struct cl_ref_s         ref;
-    bool                    cancel_update;
     struct geometry         geometry;
-    struct window_labels    label;
-    struct window_buttons   button;
-    struct parser_helper    __helper;
-    struct widget_behaviour behaviour;
+    struct item_progress    progress;
+    struct item_details     *details;
+    struct parser_helper    *__helper;  /* Only while the JTF is parsed */
+    bool                    from_arena;
+
+    /*
+     * An item replicated from a dynamic menu shares its immutable
+     * information with the item it was copied from.
+     */
+    struct xante_item       *template;
 };
 
 /** UI Menu information */
@@ -220,10 +303,19 @@ struct xante_menu {
     cl_string_t                 *dynamic_origin_block;
     cl_string_t                 *dynamic_origin_item;
 
+    /*
+     * A dynamic menu copy is created as a stub, without items, which are
+     * only created from its template when they're needed.
+     */
+    struct xante_menu           *dynamic_template;
+    int                         dynamic_copy_index;
+    bool                        dynamic_from_settings;
+
     /* Internal */
     enum xante_menu_creator     creator;
     enum xante_menu_type        menu_type;
     bool                        move_to_be_released;
+    bool                        from_arena;
     cl_list_t                   *items;
     struct cl_ref_s             ref;
     struct geometry             geometry;
@@ -237,6 +329,11 @@ struct xante_ui {
     /* Internal */
     cl_list_t               *menus;
     cl_list_t               *unreferenced_menus;
+    struct arena            *arena;         /* Menus and items from the JTF */
+    struct intern_table     *strings;       /* Strings shared between them */
+    struct dm_registry      *dynamic_menus; /* Copies of dynamic menus */
+    struct arena            *session_arena; /* Content of open dialogs */
+    int                     stub_menus;     /* Copies not materialized yet */
 };
 
 struct xante_log {
@@ -247,6 +344,7 @@ struct xante_module {
     cl_plugin_t             *module;
     cl_plugin_info_t        *info;
     cl_stringlist_t         *functions;
+    bool                    in_use;     /* Kept loaded at exit */
 };
 
 struct xante_config {
@@ -283,6 +381,10 @@ struct xante_app {
     struct xante_changes    changes;
     struct xante_module     module;
     struct xante_auth       auth;
+    struct xante_executor   *executor;
+    struct jts_cache        *jts_cache;
+    struct event_pool       *event_pool;
+    struct xante_stats      *stats;
     struct cl_ref_s         ref;
 };
 
@@ -290,6 +392,8 @@ struct xante_app {
 struct xante_jts {
     cl_list_t           *menus;
     struct xante_item   *object;
+    bool                cached;
+    struct jts_binding  *binding;
 };
 
 /* Just gives us the right item value */
@@ -309,21 +413,30 @@ struct xante_jts {
 #include "widgets.h"
 #include "gadgets.h"
 
+#include "apply.h"
+#include "arena.h"
 #include "auth.h"
+#include "bitset.h"
 #include "changes.h"
+#include "config.h"
 #include "dm.h"
 #include "event.h"
+#include "executor.h"
 #include "instance.h"
+#include "intern.h"
 #include "internal.h"
 #include "item.h"
 #include "jtf.h"
 #include "log.h"
 #include "manager.h"
 #include "menu.h"
+#include "option_set.h"
 #include "runtime.h"
 #include "session.h"
+#include "stats.h"
 #include "jts.h"
 #include "utils.h"
+#include "validator.h"
 
 #endif
 
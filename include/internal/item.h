@@ -31,7 +31,16 @@
 void xante_item_destroy(void *a);
 void xante_item_ref(struct xante_item *item);
 void xante_item_unref(struct xante_item *item);
-struct xante_item *xante_item_create(void);
+struct xante_item *xante_item_create(struct arena *arena);
+int item_progress_open(struct xante_item *item);
+int item_progress_value(const struct xante_item *item);
+bool item_progress_wait(struct xante_item *item, int timeout);
+void item_set_value(struct xante_item *item, cl_object_t *value);
+void item_value_updated(struct xante_item *item);
+void item_display_lock(void);
+void item_display_unlock(void);
+const char *item_display_value(struct xante_item *item);
+struct xante_item *item_snapshot(const struct xante_item *item);
 
 #endif
 
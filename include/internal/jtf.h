@@ -28,8 +28,12 @@
 #define _LIBXANTE_INTERNAL_JTF_H
 
 /* Internal library declarations */
-struct xante_item *jtf_parse_item(const cl_json_t *item, bool single_instance);
-struct xante_menu *jtf_parse_menu(const cl_json_t *menu);
+struct xante_item *jtf_parse_item(const cl_json_t *item, bool single_instance,
+                                  struct arena *arena,
+                                  struct intern_table *strings);
+
+struct xante_menu *jtf_parse_menu(const cl_json_t *menu, struct arena *arena,
+                                  struct intern_table *strings);
 int jtf_parse_application_info(const char *pathname, struct xante_app *xpp);
 int jtf_parse_application(const char *pathname, struct xante_app *xpp);
 void jtf_release_info(struct xante_app *xpp);
@@ -27,9 +27,26 @@
 #ifndef _LIBXANTE_INTERNAL_JTS_H
 #define _LIBXANTE_INTERNAL_JTS_H
 
+/* The arguments of a template run */
+struct jts_arguments {
+    const char          *title;
+    const char          *default_value;
+    const char * const  *options;
+    int                 total_options;
+};
+
 /* Internal library declarations */
 struct xante_jts *jts_load(const char *jts);
 void jts_unload(struct xante_jts *jts);
+int jts_cache_init(struct xante_app *xpp);
+void jts_cache_uninit(struct xante_app *xpp);
+struct xante_jts *jts_cache_get(struct xante_app *xpp, const char *jts);
+void jts_cache_put(struct xante_app *xpp, struct xante_jts *jts);
+int jts_template_register(struct xante_app *xpp, const char *name,
+                          const char *jts);
+
+struct xante_jts *jts_template_get(struct xante_app *xpp, const char *name,
+                                   const struct jts_arguments *args);
 
 #endif
 
@@ -31,7 +31,8 @@
 void xante_menu_ref(struct xante_menu *menu);
 void xante_menu_unref(struct xante_menu *menu);
 void xante_menu_destroy(void *a);
-struct xante_menu *xante_menu_create(enum xante_menu_creator creator);
+struct xante_menu *xante_menu_create(enum xante_menu_creator creator,
+                                     struct arena *arena);
 struct xante_menu *xante_menu_head(const cl_list_t *menus);
 struct xante_menu *xante_menu_search_by_name(const cl_list_t *menus,
                                              const char *menu_name);
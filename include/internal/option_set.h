@@ -0,0 +1,57 @@
+
+/*
+ * Description: Interned options of an item and ordered sets of them.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 12:20:44 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef _LIBXANTE_INTERNAL_OPTION_SET_H
+#define _LIBXANTE_INTERNAL_OPTION_SET_H
+
+struct option_index;
+struct option_set;
+
+/* Internal library declarations */
+struct option_index *option_index_create(int total);
+struct option_index *option_index_ref(struct option_index *index);
+void option_index_unref(struct option_index *index);
+int option_index_add(struct option_index *index, const cl_string_t *name);
+int option_index_lookup(const struct option_index *index, const char *name,
+                        int length);
+
+const char *option_index_name(const struct option_index *index, int id);
+int option_index_size(const struct option_index *index);
+
+struct option_set *option_set_create(int total);
+void option_set_destroy(struct option_set *set);
+bool option_set_add(struct option_set *set, int id);
+bool option_set_contains(const struct option_set *set, int id);
+int option_set_size(const struct option_set *set);
+bool option_set_equals(const struct option_set *a, const struct option_set *b);
+struct option_set *option_set_from_cstring(const struct option_index *index,
+                                           const cl_string_t *value);
+
+cl_string_t *option_set_to_cstring(const struct option_index *index,
+                                   const struct option_set *set);
+
+#endif
+
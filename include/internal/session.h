@@ -32,6 +32,14 @@ void session_init(struct xante_app *xpp, struct xante_item *item,
                      session_t *session);
 
 void session_uninit(session_t *session);
+enum xante_object session_registered_widget_type(const char *name,
+                                                 size_t length);
+
+bool session_is_registered_widget(enum xante_object type);
+void session_widgets_owner(const void *owner);
+void session_unregister_widgets(const void *owner);
+void *session_alloc(session_t *session, size_t size);
+char *session_strdup(session_t *session, const char *s);
 
 #endif
 
@@ -0,0 +1,54 @@
+
+/*
+ * Description: Internal statistics of an application.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 17:12:40 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef _LIBXANTE_INTERNAL_STATS_H
+#define _LIBXANTE_INTERNAL_STATS_H
+
+#include <time.h>
+
+/** Where an event function was found */
+enum stats_origin {
+    STATS_ORIGIN_INTERNAL,      /* The internal dispatch table */
+    STATS_ORIGIN_MODULE,        /* The application module */
+    STATS_ORIGIN_EXTERNAL       /* Another module */
+};
+
+struct xante_stats;
+
+/* Internal library declarations */
+int stats_init(struct xante_app *xpp);
+void stats_uninit(struct xante_app *xpp);
+void stats_event_start(struct timespec *start);
+void stats_event_record(struct xante_app *xpp, const char *event_name,
+                        const char *function, enum stats_origin origin,
+                        const struct timespec *start, bool failed);
+
+void stats_phase_begin(struct xante_app *xpp, const char *name);
+void stats_phase_end(struct xante_app *xpp);
+int stats_trace_export(struct xante_app *xpp, const char *pathname);
+
+#endif
+
@@ -0,0 +1,54 @@
+
+/*
+ * Description: Typed validation of an input item content.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 14:07:51 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef _LIBXANTE_INTERNAL_VALIDATOR_H
+#define _LIBXANTE_INTERNAL_VALIDATOR_H
+
+/* The reasons a value may be refused by a validator */
+enum validator_status {
+    VALIDATOR_OK,
+    VALIDATOR_INVALID_FORMAT,
+    VALIDATOR_OUT_OF_RANGE,
+    VALIDATOR_TOO_LONG,
+    VALIDATOR_INVALID_DAY,
+    VALIDATOR_INVALID_MONTH,
+    VALIDATOR_INVALID_YEAR,
+    VALIDATOR_INVALID_HOUR,
+    VALIDATOR_INVALID_MINUTE,
+    VALIDATOR_INVALID_SECOND
+};
+
+/* Internal library declarations */
+void validator_compile(struct item_validator *validator,
+                       const struct xante_item *item);
+
+enum validator_status validator_check(const struct item_validator *validator,
+                                      const char *value);
+
+const char *validator_strerror(enum validator_status status);
+
+#endif
+
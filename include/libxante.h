@@ -80,6 +80,7 @@ enum xante_object {
     XANTE_WIDGET_MIXEDFORM,
     XANTE_WIDGET_BUILDLIST,
     XANTE_WIDGET_SPREADSHEET,
+    XANTE_WIDGET_MULTI_PROGRESS,
 
     /* UI gadgets */
     XANTE_GADGET_CLOCK
@@ -124,6 +125,8 @@ enum xante_init_flags {
     XANTE_USE_AUTH          = (1 << 1), // Enable/Disable database authentication.
     XANTE_SINGLE_INSTANCE   = (1 << 2), // Enable/Disable application single
                                         // instance mode.
+    XANTE_TRACE_STARTUP     = (1 << 3), // Enable/Disable writing the startup
+                                        // phases as a trace file.
 };
 
 /** Return values of an application */
@@ -186,7 +189,9 @@ struct xante_change_entry {
 #include "api/manager.h"
 #include "api/menu.h"
 #include "api/runtime.h"
+#include "api/stats.h"
 #include "api/utils.h"
+#include "api/widget.h"
 
 #else   // __cplusplus
 
@@ -65,6 +65,7 @@ const (
 	Mixedform
 	Buildlist
 	Spreadsheet
+	MultiProgress
 	Clock
 )
 
@@ -116,3 +117,53 @@ func (x *XanteApp) Dialog(dialog string) {
 
 	C.xante_manager_single_run(x.data, cDialog)
 }
+
+// RegisterTemplate parses a dialog once, so it can be run several times
+// through its @name with RunTemplate.
+func (x *XanteApp) RegisterTemplate(name string, dialog string) int {
+	cName := C.CString(name)
+	defer C.free(unsafe.Pointer(cName))
+
+	cDialog := C.CString(dialog)
+	defer C.free(unsafe.Pointer(cDialog))
+
+	return int(C.xante_manager_register_template(x.data, cName, cDialog))
+}
+
+// RunTemplate runs a dialog previously registered with RegisterTemplate,
+// replacing its title, default value and options. Empty strings and a nil
+// @options keep what the dialog has.
+func (x *XanteApp) RunTemplate(name string, title string, defaultValue string,
+	options []string) {
+	var cTitle, cDefaultValue *C.char
+	var cOptions **C.char
+
+	cName := C.CString(name)
+	defer C.free(unsafe.Pointer(cName))
+
+	if title != "" {
+		cTitle = C.CString(title)
+		defer C.free(unsafe.Pointer(cTitle))
+	}
+
+	if defaultValue != "" {
+		cDefaultValue = C.CString(defaultValue)
+		defer C.free(unsafe.Pointer(cDefaultValue))
+	}
+
+	if options != nil {
+		cOptions = (**C.char)(C.malloc(C.size_t(len(options)+1) *
+			C.size_t(unsafe.Sizeof(cTitle))))
+
+		defer C.free(unsafe.Pointer(cOptions))
+		list := (*[1 << 28]*C.char)(unsafe.Pointer(cOptions))[:len(options):len(options)]
+
+		for i, option := range options {
+			list[i] = C.CString(option)
+			defer C.free(unsafe.Pointer(list[i]))
+		}
+	}
+
+	C.xante_manager_run_template(x.data, cName, cTitle, cDefaultValue,
+		cOptions, C.int(len(options)))
+}
@@ -0,0 +1,601 @@
+
+/*
+ * Description: Non-interactive application of settings changes.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 15:09:37 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+
+#include "libxante.h"
+
+#define CHANGE_OBJECT_ID                "object_id"
+#define CHANGE_VALUE                    "value"
+
+/*
+ * Every item of the application indexed by its object_id, so a change set
+ * with thousands of entries doesn't need to walk through all menus for each
+ * one of them.
+ */
+struct item_index {
+    struct option_index *ids;
+    struct xante_item   **items;
+    int                 total;
+    bool                outdated;
+};
+
+struct index_builder {
+    struct item_index   *index;
+    int                 total;
+};
+
+/*
+ * A change already made to an item, kept until the whole set is accepted.
+ * Items are referenced by their object_id since dynamic menus may be
+ * replaced by the following changes.
+ */
+struct applied_change {
+    cl_string_t         *object_id;
+    cl_object_t         *old_value;
+    cl_string_t         *name;
+    cl_string_t         *old_text;
+    cl_string_t         *new_text;
+    bool                dm_updated;
+};
+
+struct apply_journal {
+    struct applied_change   *changes;
+    int                     total;
+    int                     allocated;
+};
+
+/*
+ *
+ * Internal functions
+ *
+ */
+
+static int count_menu_items(cl_list_node_t *node, void *a)
+{
+    struct xante_menu *menu = cl_list_node_content(node);
+    struct index_builder *builder = (struct index_builder *)a;
+
+    if (menu->items != NULL)
+        builder->total += cl_list_size(menu->items);
+
+    return 0;
+}
+
+static int index_item(cl_list_node_t *node, void *a)
+{
+    struct xante_item *item = cl_list_node_content(node);
+    struct item_index *index = (struct item_index *)a;
+    int id;
+
+    if (NULL == item->object_id)
+        return 0;
+
+    id = option_index_add(index->ids, item->object_id);
+
+    if (id >= 0)
+        index->items[id] = item;
+
+    return 0;
+}
+
+static int index_menu_items(cl_list_node_t *node, void *a)
+{
+    struct xante_menu *menu = cl_list_node_content(node);
+
+    if (menu->items != NULL)
+        cl_list_map(menu->items, index_item, a);
+
+    return 0;
+}
+
+static void item_index_clear(struct item_index *index)
+{
+    if (index->ids != NULL)
+        option_index_unref(index->ids);
+
+    if (index->items != NULL)
+        free(index->items);
+
+    index->ids = NULL;
+    index->items = NULL;
+    index->total = 0;
+}
+
+static int item_index_build(struct item_index *index, struct xante_app *xpp)
+{
+    struct index_builder builder = {
+        .index = index,
+        .total = 0,
+    };
+
+    item_index_clear(index);
+    dm_materialize_all(xpp);
+    cl_list_map(xpp->ui.menus, count_menu_items, &builder);
+    dm_map_menus(xpp, count_menu_items, &builder);
+    index->ids = option_index_create(max(1, builder.total));
+    index->items = calloc(max(1, builder.total), sizeof(struct xante_item *));
+
+    if ((NULL == index->ids) || (NULL == index->items)) {
+        item_index_clear(index);
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return -1;
+    }
+
+    index->total = builder.total;
+    index->outdated = false;
+    cl_list_map(xpp->ui.menus, index_menu_items, index);
+    dm_map_menus(xpp, index_menu_items, index);
+
+    return 0;
+}
+
+static struct xante_item *item_index_find(struct item_index *index,
+    struct xante_app *xpp, const char *object_id, int length)
+{
+    int id;
+
+    /* Dynamic menus may have been created or removed by previous changes */
+    if (index->outdated == true)
+        if (item_index_build(index, xpp) < 0)
+            return NULL;
+
+    id = option_index_lookup(index->ids, object_id, length);
+
+    return (id < 0) ? NULL : index->items[id];
+}
+
+static struct xante_item *item_index_lookup(struct item_index *index,
+    struct xante_app *xpp, const char *object_id, int length)
+{
+    struct xante_item *item = NULL;
+    char name[256] = {0};
+
+    item = item_index_find(index, xpp, object_id, length);
+
+    if ((NULL == item) && (index->outdated == false)) {
+        snprintf(name, sizeof(name), "%.*s", length, object_id);
+        errno_set(XANTE_ERROR_ITEM_NOT_FOUND);
+        errno_store_additional_content(name);
+    }
+
+    return item;
+}
+
+static struct applied_change *journal_push(struct apply_journal *journal)
+{
+    struct applied_change *changes = NULL;
+    int allocated;
+
+    if (journal->total == journal->allocated) {
+        allocated = max(16, journal->allocated * 2);
+        changes = realloc(journal->changes,
+                          allocated * sizeof(struct applied_change));
+
+        if (NULL == changes) {
+            errno_set(XANTE_ERROR_NO_MEMORY);
+            return NULL;
+        }
+
+        journal->changes = changes;
+        journal->allocated = allocated;
+    }
+
+    changes = &journal->changes[journal->total++];
+    memset(changes, 0, sizeof(struct applied_change));
+
+    return changes;
+}
+
+static void applied_change_release(struct applied_change *change)
+{
+    if (change->object_id != NULL)
+        cl_string_unref(change->object_id);
+
+    if (change->old_value != NULL)
+        cl_object_unref(change->old_value);
+
+    if (change->name != NULL)
+        cl_string_unref(change->name);
+
+    if (change->old_text != NULL)
+        cl_string_unref(change->old_text);
+
+    if (change->new_text != NULL)
+        cl_string_unref(change->new_text);
+}
+
+/*
+ * Keeps every change made: they are added to the internal changes list and
+ * the module is told about them, in the same order they were made.
+ */
+static void journal_commit(struct apply_journal *journal,
+    struct xante_app *xpp, struct item_index *index)
+{
+    struct applied_change *change = NULL;
+    struct xante_item *item = NULL;
+    int i;
+
+    for (i = 0; i < journal->total; i++) {
+        change = &journal->changes[i];
+        change_add(xpp, cl_string_valueof(change->name),
+                   cl_string_valueof(change->old_text),
+                   cl_string_valueof(change->new_text));
+
+        item = item_index_find(index, xpp, cl_string_valueof(change->object_id),
+                               cl_string_length(change->object_id));
+
+        /* It may be inside a dynamic menu removed by a later change */
+        if (item != NULL)
+            event_call(EV_ITEM_VALUE_UPDATED, xpp, item);
+    }
+}
+
+/*
+ * Puts back the previous value of every changed item, from the last change
+ * to the first, so the dynamic menus end up as they were.
+ */
+static void journal_rollback(struct apply_journal *journal,
+    struct xante_app *xpp, struct item_index *index)
+{
+    struct applied_change *change = NULL;
+    struct xante_item *item = NULL;
+    int i;
+
+    for (i = journal->total - 1; i >= 0; i--) {
+        change = &journal->changes[i];
+        item = item_index_find(index, xpp, cl_string_valueof(change->object_id),
+                               cl_string_length(change->object_id));
+
+        if (NULL == item)
+            continue;
+
+        item_set_value(item, change->old_value);
+        change->old_value = NULL;
+
+        if (change->dm_updated && dm_update(xpp, item))
+            index->outdated = true;
+    }
+}
+
+static void journal_clear(struct apply_journal *journal)
+{
+    int i;
+
+    for (i = 0; i < journal->total; i++)
+        applied_change_release(&journal->changes[i]);
+
+    if (journal->changes != NULL)
+        free(journal->changes);
+
+    memset(journal, 0, sizeof(struct apply_journal));
+}
+
+/*
+ * Only objects whose value can be entirely described by a string can be
+ * changed without running them.
+ */
+static bool is_headless_object(enum xante_object type)
+{
+    switch (type) {
+        case XANTE_WIDGET_INPUT_INT:
+        case XANTE_WIDGET_INPUT_FLOAT:
+        case XANTE_WIDGET_INPUT_DATE:
+        case XANTE_WIDGET_INPUT_STRING:
+        case XANTE_WIDGET_INPUT_PASSWD:
+        case XANTE_WIDGET_INPUT_TIME:
+        case XANTE_WIDGET_CALENDAR:
+        case XANTE_WIDGET_TIMEBOX:
+        case XANTE_WIDGET_RADIO_CHECKLIST:
+        case XANTE_WIDGET_CHECKLIST:
+        case XANTE_WIDGET_YES_NO:
+        case XANTE_WIDGET_RANGE:
+        case XANTE_WIDGET_FILE_SELECT:
+        case XANTE_WIDGET_DIR_SELECT:
+        case XANTE_WIDGET_INPUTSCROLL:
+            return true;
+
+        default:
+            break;
+    }
+
+    return false;
+}
+
+/*
+ * Runs a new value through the same steps the manager takes when an object
+ * is confirmed by the user, without displaying it. The item previous value
+ * is kept inside the @journal, and nothing is told about the change until
+ * it is committed.
+ */
+static int apply_item_value(struct xante_app *xpp, struct item_index *index,
+    struct apply_journal *journal, struct xante_item *item, const char *value)
+{
+    struct applied_change *change = NULL;
+    session_t session;
+    enum validator_status status;
+    int ret = -1;
+
+    session_init(xpp, item, &session);
+
+    if ((session.editable_value == false) ||
+        (is_headless_object(item->widget_type) == false) ||
+        (NULL == session.value_changed) || (NULL == session.update_value))
+    {
+        errno_set(XANTE_ERROR_ITEM_NOT_EDITABLE);
+        errno_store_additional_content(cl_string_valueof(item->object_id));
+        goto end_block;
+    }
+
+    status = validator_check(&item->validator, value);
+
+    if (status != VALIDATOR_OK) {
+        errno_set(XANTE_ERROR_INVALID_ITEM_VALUE);
+        errno_store_additional_content(cl_string_valueof(item->object_id));
+        errno_store_additional_content(validator_strerror(status));
+        goto end_block;
+    }
+
+    session.result = cl_string_create("%s", value);
+
+    if (item->list_items != NULL)
+        session.number_of_items = cl_stringlist_size(item->list_items);
+
+    if (event_call(EV_ITEM_VALUE_CONFIRM, xpp, item, value) < 0) {
+        errno_set(XANTE_ERROR_INVALID_ITEM_VALUE);
+        errno_store_additional_content(cl_string_valueof(item->object_id));
+        errno_store_additional_content("refused by the module");
+        goto end_block;
+    }
+
+    if ((session.value_changed)(&session) == true) {
+        change = journal_push(journal);
+
+        if (NULL == change)
+            goto end_block;
+
+        /* The current value object is kept aside, so it can be put back */
+        change->object_id = cl_string_ref(item->object_id);
+        change->old_value = item->value;
+        item->value = NULL;
+        (session.update_value)(&session);
+
+        change->name = session.change_item_name;
+        change->old_text = session.change_old_value;
+        change->new_text = session.change_new_value;
+        session.change_item_name = NULL;
+        session.change_old_value = NULL;
+        session.change_new_value = NULL;
+
+        if (dm_update(xpp, item) == true) {
+            change->dm_updated = true;
+            index->outdated = true;
+        }
+    }
+
+    ret = 0;
+
+end_block:
+    session_uninit(&session);
+
+    return ret;
+}
+
+static int apply_json_changes(struct xante_app *xpp, struct item_index *index,
+    struct apply_journal *journal, const char *changes)
+{
+    cl_json_t *jchanges = NULL, *node = NULL, *object_id = NULL, *value = NULL;
+    cl_string_t *s_object_id = NULL, *s_value = NULL;
+    struct xante_item *item = NULL;
+    int i, t, ret = -1;
+
+    jchanges = cl_json_parse_string(changes);
+
+    if ((NULL == jchanges) ||
+        (cl_json_get_object_type(jchanges) != CL_JSON_ARRAY))
+    {
+        errno_set(XANTE_ERROR_INVALID_CHANGE_SET);
+        errno_store_additional_content("expected an array of changes");
+        goto end_block;
+    }
+
+    t = cl_json_get_array_size(jchanges);
+
+    for (i = 0; i < t; i++) {
+        node = cl_json_get_array_item(jchanges, i);
+        object_id = cl_json_get_object_item(node, CHANGE_OBJECT_ID);
+        value = cl_json_get_object_item(node, CHANGE_VALUE);
+        s_object_id = (object_id != NULL) ? cl_json_get_object_value(object_id)
+                                          : NULL;
+
+        s_value = (value != NULL) ? cl_json_get_object_value(value) : NULL;
+
+        if ((NULL == s_object_id) || (NULL == s_value)) {
+            errno_set(XANTE_ERROR_INVALID_CHANGE_SET);
+            errno_store_additional_content("change without object_id or value");
+            goto end_block;
+        }
+
+        item = item_index_lookup(index, xpp, cl_string_valueof(s_object_id),
+                                 cl_string_length(s_object_id));
+
+        if (NULL == item)
+            goto end_block;
+
+        if (apply_item_value(xpp, index, journal, item,
+                             cl_string_valueof(s_value)) < 0)
+        {
+            goto end_block;
+        }
+    }
+
+    ret = 0;
+
+end_block:
+    if (jchanges != NULL)
+        cl_json_delete(jchanges);
+
+    return ret;
+}
+
+static const char *skip_blanks(const char *p, const char *end)
+{
+    while ((p < end) && ((*p == ' ') || (*p == '\t') || (*p == '\r')))
+        p++;
+
+    return p;
+}
+
+static const char *trim_blanks(const char *start, const char *p)
+{
+    while ((p > start) &&
+           ((p[-1] == ' ') || (p[-1] == '\t') || (p[-1] == '\r')))
+    {
+        p--;
+    }
+
+    return p;
+}
+
+/*
+ * Applies changes written as "object_id = value" lines. Empty lines, lines
+ * starting with '#' or ';' and sections are ignored, so a settings file
+ * keyed by object_id may be used.
+ */
+static int apply_ini_changes(struct xante_app *xpp, struct item_index *index,
+    struct apply_journal *journal, const char *changes)
+{
+    const char *line = changes, *end = NULL, *eol = NULL, *sep = NULL,
+               *key_end = NULL, *value = NULL;
+    struct xante_item *item = NULL;
+    cl_string_t *s_value = NULL;
+    int ret, line_number = 0;
+
+    end = changes + strlen(changes);
+
+    for (; line < end; line = (eol < end) ? eol + 1 : end) {
+        line_number++;
+        eol = memchr(line, '\n', end - line);
+
+        if (NULL == eol)
+            eol = end;
+
+        line = skip_blanks(line, eol);
+
+        if ((line == eol) || (*line == '#') || (*line == ';') ||
+            (*line == '['))
+        {
+            continue;
+        }
+
+        sep = memchr(line, '=', eol - line);
+
+        if (NULL == sep) {
+            errno_set(XANTE_ERROR_INVALID_CHANGE_SET);
+            errno_store_additional_content("line without '='");
+            return -1;
+        }
+
+        key_end = trim_blanks(line, sep);
+        value = skip_blanks(sep + 1, eol);
+        item = item_index_lookup(index, xpp, line, key_end - line);
+
+        if (NULL == item)
+            return -1;
+
+        s_value = cl_string_create("%.*s",
+                                   (int)(trim_blanks(value, eol) - value),
+                                   value);
+
+        ret = apply_item_value(xpp, index, journal, item,
+                               cl_string_valueof(s_value));
+        cl_string_unref(s_value);
+
+        if (ret < 0) {
+            xante_log_error(cl_tr("Change at line %d was not applied"),
+                            line_number);
+
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ *
+ * Internal API
+ *
+ */
+
+/**
+ * @name apply_changes
+ * @brief Applies a set of changes to the application items.
+ *
+ * Each change goes through the same validation and events as if it had been
+ * made through the UI. The changes are applied in order and the first one
+ * that fails stops the whole process, undoing the previous ones. Only when
+ * every change is accepted they are added to the internal changes list and
+ * the EV_ITEM_VALUE_UPDATED events are called.
+ *
+ * @param [in,out] xpp: The library main object.
+ * @param [in] changes: The change set, as a JSON array of objects with
+ *                      "object_id" and "value" or as "object_id = value"
+ *                      lines.
+ *
+ * @return On success returns 0 or -1 otherwise.
+ */
+int apply_changes(struct xante_app *xpp, const char *changes)
+{
+    struct item_index index;
+    struct apply_journal journal;
+    const char *p = changes;
+    int ret;
+
+    memset(&index, 0, sizeof(struct item_index));
+    memset(&journal, 0, sizeof(struct apply_journal));
+
+    if (item_index_build(&index, xpp) < 0)
+        return -1;
+
+    while ((*p == ' ') || (*p == '\t') || (*p == '\r') || (*p == '\n'))
+        p++;
+
+    if (*p == '[')
+        ret = apply_json_changes(xpp, &index, &journal, p);
+    else
+        ret = apply_ini_changes(xpp, &index, &journal, p);
+
+    if (ret == 0)
+        journal_commit(&journal, xpp, &index);
+    else
+        journal_rollback(&journal, xpp, &index);
+
+    journal_clear(&journal);
+    item_index_clear(&index);
+
+    return ret;
+}
+
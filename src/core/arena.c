@@ -0,0 +1,279 @@
+
+/*
+ * Description: A region allocator, where everything is released at once.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 16:12:40 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include "libxante.h"
+
+/* Default size of every block requested to the system */
+#define ARENA_DEFAULT_BLOCK_SIZE        (64 * 1024)
+
+/* Every allocation is aligned like the strictest scalar type */
+#define ARENA_ALIGNMENT                 16
+
+#define align_up(n)                     \
+    (((n) + (ARENA_ALIGNMENT - 1)) & ~((size_t)ARENA_ALIGNMENT - 1))
+
+struct arena_block {
+    struct arena_block  *next;
+    size_t              base;   /* Arena position where the block starts */
+    size_t              size;
+    size_t              used;
+};
+
+struct arena {
+    struct arena_block  *blocks;
+    struct arena_block  *spare;     /* Released blocks kept to be reused */
+    size_t              block_size;
+    size_t              allocated;
+};
+
+/*
+ *
+ * Internal functions
+ *
+ */
+
+static unsigned char *block_data(struct arena_block *block)
+{
+    return (unsigned char *)block + align_up(sizeof(struct arena_block));
+}
+
+static struct arena_block *reuse_block(struct arena *arena, size_t size)
+{
+    struct arena_block *block = NULL, **prev = &arena->spare;
+
+    for (block = arena->spare; block != NULL; block = block->next) {
+        if (block->size >= size) {
+            *prev = block->next;
+            return block;
+        }
+
+        prev = &block->next;
+    }
+
+    return NULL;
+}
+
+static struct arena_block *new_block(struct arena *arena, size_t size)
+{
+    struct arena_block *block = NULL;
+
+    size = max(size, arena->block_size);
+    block = reuse_block(arena, size);
+
+    if (NULL == block) {
+        block = malloc(align_up(sizeof(struct arena_block)) + size);
+
+        if (NULL == block)
+            return NULL;
+
+        block->size = size;
+    }
+
+    block->base = (NULL == arena->blocks)
+                        ? 0
+                        : arena->blocks->base + arena->blocks->size;
+
+    block->used = 0;
+    block->next = arena->blocks;
+    arena->blocks = block;
+
+    return block;
+}
+
+/*
+ *
+ * Internal API
+ *
+ */
+
+/**
+ * @name arena_create
+ * @brief Creates a new arena.
+ *
+ * @param [in] block_size: The size of every block requested to the system.
+ *                         If 0 a default value is used.
+ *
+ * @return On success returns the new arena or NULL otherwise.
+ */
+struct arena *arena_create(size_t block_size)
+{
+    struct arena *arena = NULL;
+
+    arena = calloc(1, sizeof(struct arena));
+
+    if (NULL == arena) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return NULL;
+    }
+
+    arena->block_size = (block_size == 0) ? ARENA_DEFAULT_BLOCK_SIZE
+                                          : align_up(block_size);
+
+    return arena;
+}
+
+/**
+ * @name arena_destroy
+ * @brief Releases an arena and everything that was allocated from it.
+ *
+ * @param [in,out] arena: The arena.
+ */
+void arena_destroy(struct arena *arena)
+{
+    struct arena_block *block = NULL, *next = NULL;
+
+    if (NULL == arena)
+        return;
+
+    for (block = arena->blocks; block != NULL; block = next) {
+        next = block->next;
+        free(block);
+    }
+
+    for (block = arena->spare; block != NULL; block = next) {
+        next = block->next;
+        free(block);
+    }
+
+    free(arena);
+}
+
+/**
+ * @name arena_alloc
+ * @brief Allocates zeroed memory from an arena.
+ *
+ * The memory must not be freed, it lives until the arena is destroyed or
+ * rewound to a position before it.
+ *
+ * @param [in,out] arena: The arena.
+ * @param [in] size: The size of the requested memory.
+ *
+ * @return On success returns a pointer to the memory or NULL otherwise.
+ */
+void *arena_alloc(struct arena *arena, size_t size)
+{
+    struct arena_block *block = NULL;
+    void *p = NULL;
+
+    if (NULL == arena)
+        return NULL;
+
+    size = align_up(max(size, (size_t)1));
+    block = arena->blocks;
+
+    if ((NULL == block) || (block->size - block->used < size)) {
+        block = new_block(arena, size);
+
+        if (NULL == block) {
+            errno_set(XANTE_ERROR_NO_MEMORY);
+            return NULL;
+        }
+    }
+
+    p = block_data(block) + block->used;
+    block->used += size;
+    arena->allocated += size;
+    memset(p, 0, size);
+
+    return p;
+}
+
+/**
+ * @name arena_allocated
+ * @brief Gets the amount of memory handed out by an arena.
+ *
+ * @param [in] arena: The arena.
+ *
+ * @return Returns the number of allocated bytes.
+ */
+size_t arena_allocated(const struct arena *arena)
+{
+    if (NULL == arena)
+        return 0;
+
+    return arena->allocated;
+}
+
+/**
+ * @name arena_position
+ * @brief Gets the current position of an arena, to be rewound to later.
+ *
+ * @param [in] arena: The arena.
+ *
+ * @return Returns the arena position.
+ */
+size_t arena_position(const struct arena *arena)
+{
+    if ((NULL == arena) || (NULL == arena->blocks))
+        return 0;
+
+    return arena->blocks->base + arena->blocks->used;
+}
+
+/**
+ * @name arena_rewind
+ * @brief Releases everything allocated from an arena after a position.
+ *
+ * The blocks are kept to serve the next allocations, so an arena which is
+ * rewound over and over stops asking memory to the system.
+ *
+ * @param [in,out] arena: The arena.
+ * @param [in] position: A position previously given by arena_position.
+ */
+void arena_rewind(struct arena *arena, size_t position)
+{
+    struct arena_block *block = NULL;
+
+    if (NULL == arena)
+        return;
+
+    while ((arena->blocks != NULL) && (arena->blocks->base >= position)) {
+        block = arena->blocks;
+        arena->blocks = block->next;
+        arena->allocated -= block->used;
+        block->next = arena->spare;
+        arena->spare = block;
+    }
+
+    block = arena->blocks;
+
+    if ((block != NULL) && (position - block->base < block->used)) {
+        arena->allocated -= block->used - (position - block->base);
+        block->used = position - block->base;
+    }
+}
+
+/**
+ * @name arena_reset
+ * @brief Releases everything allocated from an arena, keeping its blocks.
+ *
+ * @param [in,out] arena: The arena.
+ */
+void arena_reset(struct arena *arena)
+{
+    arena_rewind(arena, 0);
+}
+
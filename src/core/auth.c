@@ -512,6 +512,7 @@ static void write_jxdbi_ui_info(struct xante_app *xpp, cl_json_t *root)
         return;
 
     cl_list_map(xpp->ui.menus, write_jxdbi_menu, ui);
+    dm_map_menus(xpp, write_jxdbi_menu, ui);
     cl_json_add_item_to_object(root, UI, ui);
 }
 
@@ -1059,6 +1060,7 @@ int auth_application_init(struct xante_app *xpp)
         return -1;
 
     cl_list_map(xpp->ui.menus, update_menu_access, xpp);
+    dm_map_menus(xpp, update_menu_access, xpp);
 
     return 0;
 }
@@ -0,0 +1,388 @@
+
+
+/*
+ * Description: A growable set of bits, indexed by option.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 11:05:51 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+
+#include "libxante.h"
+
+#define WORD_BITS                       64
+
+/*
+ * A selection wider than an int is persisted as an hexadecimal number, where
+ * the option N is the bit N. Its value is the same as the old integer
+ * representation, so old settings files (written in decimal) are still
+ * accepted when loading.
+ */
+#define BITSET_HEX_PREFIX               "0x"
+
+struct xante_bitset {
+    int         bits;
+    int         total_words;
+    uint64_t    *words;
+};
+
+/*
+ *
+ * Internal functions
+ *
+ */
+
+static int words_for(int bits)
+{
+    return max(1, (bits + WORD_BITS - 1) / WORD_BITS);
+}
+
+/*
+ * Clears every bit after the last valid one, so whole words may be compared
+ * at once.
+ */
+static void clear_unused_bits(struct xante_bitset *bitset)
+{
+    int used = bitset->bits % WORD_BITS;
+
+    if (bitset->bits == 0) {
+        bitset->words[0] = 0;
+        return;
+    }
+
+    if (used != 0)
+        bitset->words[bitset->total_words - 1] &= (UINT64_C(1) << used) - 1;
+}
+
+static int hex_digit(char c)
+{
+    if ((c >= '0') && (c <= '9'))
+        return c - '0';
+
+    if ((c >= 'a') && (c <= 'f'))
+        return c - 'a' + 10;
+
+    if ((c >= 'A') && (c <= 'F'))
+        return c - 'A' + 10;
+
+    return -1;
+}
+
+/*
+ *
+ * Internal API
+ *
+ */
+
+/**
+ * @name bitset_create
+ * @brief Creates an empty bitset.
+ *
+ * @param [in] bits: The number of bits of the bitset.
+ *
+ * @return On success returns the new bitset or NULL otherwise.
+ */
+struct xante_bitset *bitset_create(int bits)
+{
+    struct xante_bitset *bitset = NULL;
+
+    bitset = calloc(1, sizeof(struct xante_bitset));
+
+    if (NULL == bitset) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return NULL;
+    }
+
+    bitset->bits = max(0, bits);
+    bitset->total_words = words_for(bitset->bits);
+    bitset->words = calloc(bitset->total_words, sizeof(uint64_t));
+
+    if (NULL == bitset->words) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        free(bitset);
+        return NULL;
+    }
+
+    return bitset;
+}
+
+/**
+ * @name bitset_destroy
+ * @brief Releases a bitset.
+ *
+ * @param [in] bitset: The bitset.
+ */
+void bitset_destroy(struct xante_bitset *bitset)
+{
+    if (NULL == bitset)
+        return;
+
+    free(bitset->words);
+    free(bitset);
+}
+
+/**
+ * @name bitset_size
+ * @brief Gets the number of bits of a bitset.
+ *
+ * @param [in] bitset: The bitset.
+ *
+ * @return Returns the number of bits.
+ */
+int bitset_size(const struct xante_bitset *bitset)
+{
+    return bitset->bits;
+}
+
+/**
+ * @name bitset_set
+ * @brief Turns on a bit. Bits out of the bitset range are ignored.
+ *
+ * @param [in,out] bitset: The bitset.
+ * @param [in] bit: The bit index.
+ */
+void bitset_set(struct xante_bitset *bitset, int bit)
+{
+    if ((bit < 0) || (bit >= bitset->bits))
+        return;
+
+    bitset->words[bit / WORD_BITS] |= UINT64_C(1) << (bit % WORD_BITS);
+}
+
+/**
+ * @name bitset_test
+ * @brief Checks if a bit is on.
+ *
+ * @param [in] bitset: The bitset.
+ * @param [in] bit: The bit index.
+ *
+ * @return Returns true if the bit is on or false otherwise.
+ */
+bool bitset_test(const struct xante_bitset *bitset, int bit)
+{
+    if ((bit < 0) || (bit >= bitset->bits))
+        return false;
+
+    return (bitset->words[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1;
+}
+
+/**
+ * @name bitset_is_empty
+ * @brief Checks if a bitset has no bit turned on.
+ *
+ * @param [in] bitset: The bitset.
+ *
+ * @return Returns true if every bit is off or false otherwise.
+ */
+bool bitset_is_empty(const struct xante_bitset *bitset)
+{
+    int i;
+
+    for (i = 0; i < bitset->total_words; i++)
+        if (bitset->words[i] != 0)
+            return false;
+
+    return true;
+}
+
+/**
+ * @name bitset_equals
+ * @brief Compares two bitsets, a whole word at a time.
+ *
+ * @param [in] a: The first bitset.
+ * @param [in] b: The second bitset.
+ *
+ * @return Returns true if both have the same size and the same bits turned
+ *         on or false otherwise.
+ */
+bool bitset_equals(const struct xante_bitset *a, const struct xante_bitset *b)
+{
+    if (a->bits != b->bits)
+        return false;
+
+    return memcmp(a->words, b->words, a->total_words * sizeof(uint64_t)) == 0;
+}
+
+/**
+ * @name bitset_to_cstring
+ * @brief Encodes a bitset to be saved.
+ *
+ * A bitset of up to BITSET_INT_BITS bits is encoded as a decimal number, as
+ * older versions did.
+ *
+ * @param [in] bitset: The bitset.
+ *
+ * @return Returns a cl_string_t with the bitset as a decimal or an
+ *         hexadecimal number.
+ */
+cl_string_t *bitset_to_cstring(const struct xante_bitset *bitset)
+{
+    cl_string_t *s = NULL;
+    int i = bitset->total_words - 1;
+
+    if (bitset->bits <= BITSET_INT_BITS)
+        return cl_string_create("%" PRIu64, bitset->words[0]);
+
+    /* Leading zeros are not written */
+    while ((i > 0) && (bitset->words[i] == 0))
+        i--;
+
+    s = cl_string_create(BITSET_HEX_PREFIX "%" PRIx64, bitset->words[i]);
+
+    for (i--; i >= 0; i--)
+        cl_string_cat(s, "%016" PRIx64, bitset->words[i]);
+
+    return s;
+}
+
+/**
+ * @name bitset_from_cstring
+ * @brief Decodes a bitset previously encoded with 'bitset_to_cstring'.
+ *
+ * Plain decimal values, as used by old settings files, are also accepted.
+ * Bits beyond the bitset size are discarded.
+ *
+ * @param [in] value: The encoded bitset.
+ * @param [in] bits: The number of bits of the bitset.
+ *
+ * @return On success returns the decoded bitset or NULL otherwise.
+ */
+struct xante_bitset *bitset_from_cstring(const cl_string_t *value, int bits)
+{
+    struct xante_bitset *bitset = NULL;
+    const char *p = NULL;
+    int i, d, bit, prefix = strlen(BITSET_HEX_PREFIX);
+    long legacy;
+
+    bitset = bitset_create(bits);
+
+    if ((NULL == bitset) || (NULL == value))
+        return bitset;
+
+    p = cl_string_valueof(value);
+
+    if (strncmp(p, BITSET_HEX_PREFIX, prefix) != 0) {
+        legacy = strtol(p, NULL, 10);
+
+        if (legacy > 0)
+            bitset->words[0] = (uint64_t)legacy;
+
+        clear_unused_bits(bitset);
+
+        return bitset;
+    }
+
+    for (i = cl_string_length(value) - 1, bit = 0; i >= prefix; i--, bit += 4) {
+        d = hex_digit(p[i]);
+
+        if (d < 0) {
+            errno_set(XANTE_ERROR_INVALID_ARG);
+            bitset_destroy(bitset);
+            return NULL;
+        }
+
+        if (bit < bitset->total_words * WORD_BITS)
+            bitset->words[bit / WORD_BITS] |= (uint64_t)d << (bit % WORD_BITS);
+    }
+
+    clear_unused_bits(bitset);
+
+    return bitset;
+}
+
+/**
+ * @name bitset_cstring_to_int
+ * @brief Decodes an encoded bitset of up to BITSET_INT_BITS bits as an int.
+ *
+ * Both decimal and hexadecimal encodings are accepted. Bits beyond
+ * BITSET_INT_BITS are discarded.
+ *
+ * @param [in] value: The encoded bitset.
+ *
+ * @return Returns the bitset as an int.
+ */
+int bitset_cstring_to_int(const char *value)
+{
+    int prefix = strlen(BITSET_HEX_PREFIX);
+    unsigned long v;
+
+    if (NULL == value)
+        return 0;
+
+    if (strncmp(value, BITSET_HEX_PREFIX, prefix) == 0)
+        v = strtoul(value + prefix, NULL, 16);
+    else
+        v = strtoul(value, NULL, 10);
+
+    return (int)(v & ((1UL << BITSET_INT_BITS) - 1));
+}
+
+/**
+ * @name bitset_validate_cstring
+ * @brief Checks if an encoded bitset only uses the first bits of a bitset.
+ *
+ * Unlike 'bitset_from_cstring', nothing is discarded: any invalid digit or
+ * bit set beyond \a bits makes the value invalid.
+ *
+ * @param [in] value: The encoded bitset.
+ * @param [in] bits: The number of bits of the bitset.
+ *
+ * @return Returns true if the value is valid or false otherwise.
+ */
+bool bitset_validate_cstring(const char *value, int bits)
+{
+    int i, d, bit, length, prefix = strlen(BITSET_HEX_PREFIX);
+    char *end = NULL;
+    long legacy;
+
+    if (strncmp(value, BITSET_HEX_PREFIX, prefix) != 0) {
+        errno = 0;
+        legacy = strtol(value, &end, 10);
+
+        if ((end == value) || (*end != '\0') || (errno == ERANGE) ||
+            (legacy < 0))
+        {
+            return false;
+        }
+
+        return (bits >= (int)(sizeof(long) * 8) - 1) || (legacy < (1L << bits));
+    }
+
+    length = strlen(value);
+
+    if (length == prefix)
+        return false;
+
+    for (i = length - 1, bit = 0; i >= prefix; i--, bit += 4) {
+        d = hex_digit(value[i]);
+
+        if (d < 0)
+            return false;
+
+        /* Every bit of this digit from @bits on must be clear */
+        if ((bit + 4 > bits) && ((d >> max(0, bits - bit)) != 0))
+            return false;
+    }
+
+    return true;
+}
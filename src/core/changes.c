@@ -66,6 +66,24 @@ static struct xante_change_entry *new_change(void)
     return c;
 }
 
+static int copy_change(cl_list_node_t *node, void *a)
+{
+    struct xante_change_entry *c = cl_list_node_content(node), *copy = NULL;
+    cl_list_t *changes = (cl_list_t *)a;
+
+    copy = new_change();
+
+    if (NULL == copy)
+        return -1;
+
+    copy->item_name = strdup(c->item_name);
+    copy->old_value = strdup(c->old_value);
+    copy->new_value = strdup(c->new_value);
+    cl_list_unshift(changes, copy, -1);
+
+    return 0;
+}
+
 /*
  *
  * Internal API
@@ -111,6 +129,39 @@ void change_uninit(struct xante_app *xpp)
     cl_list_destroy(xpp->changes.user_changes);
 }
 
+/**
+ * @name change_snapshot
+ * @brief Copies every configuration change made by the user.
+ *
+ * The copy may be handed to another thread while the user keeps changing
+ * the application.
+ *
+ * @param [in] xpp: The main library object.
+ *
+ * @return On success returns a list of changes, which must be released with
+ *         cl_list_destroy, or NULL otherwise.
+ */
+cl_list_t *change_snapshot(struct xante_app *xpp)
+{
+    cl_list_t *changes = NULL;
+    cl_list_node_t *node = NULL;
+
+    changes = cl_list_create(destroy_change, NULL, NULL, NULL);
+
+    if (NULL == changes)
+        return NULL;
+
+    node = cl_list_map(xpp->changes.user_changes, copy_change, changes);
+
+    if (node != NULL) {
+        cl_list_node_unref(node);
+        cl_list_destroy(changes);
+        return NULL;
+    }
+
+    return changes;
+}
+
 /**
  * @name change_add
  * @brief Adds a configuration change made by the user.
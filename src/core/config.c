@@ -69,9 +69,17 @@ static void load_buildlist_item(struct xante_item *item,
     if (NULL == key)
         return;
 
+    /* Without options, there is nothing a saved selection could refer to */
+    if (NULL == item->options_index) {
+        xante_log_warning(cl_tr("Buildlist '%s' has no options, ignoring its "
+                                "saved value"), cl_string_valueof(item->name));
+
+        return;
+    }
+
     value = cl_cfg_entry_value(key);
     s = CL_OBJECT_AS_CSTRING(value);
-    item->selected_items = cl_string_split(s, ",");
+    item->selected_options = option_set_from_cstring(item->options_index, s);
     cl_string_unref(s);
     cl_object_unref(value);
 }
@@ -96,7 +104,7 @@ static int load_item_config(cl_list_node_t *node, void *a)
         if (NULL == key)
             return 0;
 
-        item->value = cl_cfg_entry_value(key);
+        item_set_value(item, cl_cfg_entry_value(key));
     }
 
     return 0;
@@ -186,7 +194,11 @@ static void save_buildlist_item(struct xante_app *xpp, struct xante_item *item)
 {
     cl_string_t *value;
 
-    value = cl_stringlist_flat(item->selected_items, ',');
+    if (NULL == item->selected_options)
+        return;
+
+    value = option_set_to_cstring(item->options_index,
+                                  item->selected_options);
 
     if (NULL == value)
         return;
@@ -214,7 +226,7 @@ static int save_item_config(cl_list_node_t *node, void *a)
         ui_save_spreadsheet_item(xpp, item);
     else {
         /* Checks if we can save the item */
-        if (item->flags.config == false)
+        if (item->details->flags.config == false)
             return 0;
 
         value = cl_object_to_cstring(item_value(item));
@@ -239,15 +251,29 @@ static int save_menu_config(cl_list_node_t *node, void *a)
     return 0;
 }
 
-static int write_config(struct xante_app *xpp)
+static void unload_config(struct xante_app *xpp)
+{
+    /* It also releases the settings */
+    event_config_unload(xpp);
+
+    if (xpp->config.filename != NULL) {
+        free(xpp->config.filename);
+        xpp->config.filename = NULL;
+    }
+}
+
+static int write_config(struct xante_app *xpp, bool ask_user)
 {
     enum xante_return_value ui_return_status = xante_runtime_exit_value(xpp);
+    int ret = 0;
 
     if (need_to_write_config_file(xpp, ui_return_status) == false)
         goto end_block;
 
     /* Do we need to ask the user for saving the changes? */
-    if (xante_runtime_show_config_saving_question(xpp) == true) {
+    if ((ask_user == true) &&
+        (xante_runtime_show_config_saving_question(xpp) == true))
+    {
         if (gadget_question(xpp, cl_tr("Closing"),
                             cl_tr("Do you want to save all modifications?"),
                             cl_tr("Yes"), cl_tr("No"), NULL) == false)
@@ -263,23 +289,78 @@ static int write_config(struct xante_app *xpp)
         xpp->config.cfg_file = cl_cfg_create();
 
     /* Write configurations */
+    dm_materialize_all(xpp);
     cl_list_map(xpp->ui.menus, save_menu_config, xpp);
+    dm_map_menus(xpp, save_menu_config, xpp);
+
+    if (cl_cfg_sync(xpp->config.cfg_file, xpp->config.filename) < 0) {
+        errno_set(XANTE_ERROR_CONFIG_NOT_SAVED);
+        errno_store_additional_content(xpp->config.filename);
+        xante_log_error(cl_tr("Unable to save the settings file '%s'"),
+                        xpp->config.filename);
+
+        runtime_set_exit_value(xpp, XANTE_RETURN_ERROR);
+        ret = -1;
+        goto end_block;
+    }
 
-    cl_cfg_sync(xpp->config.cfg_file, xpp->config.filename);
     runtime_set_exit_value(xpp, XANTE_RETURN_CONFIG_SAVED);
 
     if (change_has_occourred(xpp) == true)
         event_call(EV_CHANGES_SAVED, xpp, NULL);
 
 end_block:
-    event_call(EV_CONFIG_UNLOAD, xpp, xpp->config.cfg_file);
+    unload_config(xpp);
 
-    if (xpp->config.filename != NULL)
-        free(xpp->config.filename);
+    return ret;
+}
+
+/*
+ *
+ * Internal API
+ *
+ */
 
-    cl_cfg_unload(xpp->config.cfg_file);
+/**
+ * @name config_load_menu
+ * @brief Loads the values of every item of a menu from the current
+ *        application settings.
+ *
+ * @param [in,out] xpp: The library main object.
+ * @param [in,out] menu: The menu.
+ */
+void config_load_menu(struct xante_app *xpp, struct xante_menu *menu)
+{
+    if (NULL == xpp->config.cfg_file)
+        return;
 
-    return 0;
+    cl_list_map(menu->items, load_item_config, xpp->config.cfg_file);
+}
+
+/**
+ * @name config_write_changes
+ * @brief Writes the application settings without any user interaction.
+ *
+ * @param [in,out] xpp: The library main object.
+ *
+ * @return On success returns 0 or -1 otherwise.
+ */
+int config_write_changes(struct xante_app *xpp)
+{
+    return write_config(xpp, false);
+}
+
+/**
+ * @name config_release
+ * @brief Releases the application settings without writing them.
+ *
+ * The module still receives its EV_CONFIG_UNLOAD event.
+ *
+ * @param [in,out] xpp: The library main object.
+ */
+void config_release(struct xante_app *xpp)
+{
+    unload_config(xpp);
 }
 
 /*
@@ -309,6 +390,6 @@ __PUB_API__ int xante_config_write(xante_t *xpp)
         return -1;
     }
 
-    return write_config(xpp);
+    return write_config(xpp, true);
 }
 
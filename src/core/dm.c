@@ -36,17 +36,63 @@
  * USA
  */
 
+#include <pthread.h>
+
 #include "libxante.h"
 
 struct list_data {
     struct xante_app    *xpp;
     cl_cfg_file_t       *cfg_file;
     struct xante_menu   *menu;
+    struct dm_copy      *copies;
     int                 number_of_copies;
     int                 first_copy_index;
     char                *input_name;
 };
 
+/*
+ * A copy of a dynamic menu. It holds the copy itself and the copies of
+ * its submenus, so all of them are released at once.
+ */
+struct dm_copy {
+    int                 index;
+    bool                from_settings;
+    cl_list_t           *menus;
+    struct xante_item   *rme_item;  /* Its entry inside the RME */
+};
+
+/*
+ * All copies of a dynamic menu, in the same order as their entries inside
+ * the reference menu entry (RME).
+ */
+struct dm_entry {
+    struct xante_menu   *template;
+    struct xante_menu   *rme;
+    struct xante_item   *origin;    /* Item holding the number of copies */
+    struct dm_copy      *copies;
+    int                 total_copies;
+    int                 allocated_copies;
+};
+
+/*
+ * Copies are materialized, searched and replaced from any thread (a module
+ * may search an item while the UI adds copies), so everything here is done
+ * holding the registry lock. It's recursive, since most of these functions
+ * call each other.
+ */
+struct dm_registry {
+    pthread_mutex_t     lock;
+    struct dm_entry     *entries;
+    int                 total_entries;
+};
+
+struct dup_data {
+    struct xante_menu   *menu;
+    struct xante_menu   *d_menu;
+    struct intern_table *strings;
+    int                 menu_index;
+};
+
 /*
  *
  *
@@ -55,8 +101,8 @@ struct list_data {
  */
 
 static int dm_replicate(struct xante_app *xpp, struct xante_menu *menu,
-                        int copies, int first_copy_index,
-                        const char *input_name);
+                        struct dm_copy *copies, int number_of_copies,
+                        int first_copy_index, const char *input_name);
 
 static int find_item(cl_list_node_t *a, void *b)
 {
@@ -64,10 +110,8 @@ static int find_item(cl_list_node_t *a, void *b)
     struct list_data *ld = (struct list_data *)b;
     struct xante_menu *menu = ld->menu;
 
-    if ((cl_string_cmp(menu->dynamic_origin_block,
-                       item->config_block) == 0) &&
-        (cl_string_cmp(menu->dynamic_origin_item,
-                       item->config_item) == 0))
+    if (intern_equals(menu->dynamic_origin_block, item->config_block) &&
+        intern_equals(menu->dynamic_origin_item, item->config_item))
     {
         ld->number_of_copies = CL_OBJECT_AS_INT(item->default_value);
     }
@@ -174,94 +218,147 @@ static cl_string_t *create_item_config_block(struct xante_menu *menu,
                             cl_string_valueof(item->config_block), menu_index);
 }
 
-static struct xante_item *dup_item(struct xante_menu *menu, int item_index,
-    int menu_index)
+/*
+ * A copy only owns what is different between every copy (its object_id,
+ * referenced menu, config block and value). Everything else is immutable
+ * after the JTF is parsed, so it's shared with the template item.
+ */
+static struct xante_item *dup_item(struct xante_menu *menu,
+    struct xante_item *item, int menu_index, struct intern_table *strings)
 {
-    struct xante_item *item, *d_item = NULL;
-    cl_list_node_t *node;
+    struct xante_item *d_item = NULL;
 
-    node = cl_list_at(menu->items, item_index);
+    d_item = xante_item_create(NULL);
 
-    if (NULL == node)
+    if (NULL == d_item)
         return NULL;
 
-    item = cl_list_node_content(node);
-    d_item = xante_item_create();
-
-    /* Duplicate all item information */
-    d_item->name = cl_string_dup(item->name);
-    d_item->type = cl_string_dup(item->type);
-    d_item->descriptive_help = cl_string_dup(item->descriptive_help);
-    d_item->brief_help = cl_string_dup(item->brief_help);
-    d_item->options = cl_string_dup(item->options);
-    d_item->object_id = cl_string_dup(item->object_id);
-    cl_string_cat(d_item->object_id, "_%d", menu_index);
-    d_item->referenced_menu = cl_string_dup(item->referenced_menu);
-    cl_string_cat(d_item->referenced_menu, "_%d", menu_index);
+    xante_item_ref(item);
+    d_item->template = item;
+
+    /* Shared information */
+    d_item->name = cl_string_ref(item->name);
+    d_item->type = cl_string_ref(item->type);
+    d_item->descriptive_help = cl_string_ref(item->descriptive_help);
+    d_item->brief_help = cl_string_ref(item->brief_help);
+    d_item->options = cl_string_ref(item->options);
+    d_item->list_items = item->list_items;
+    d_item->options_index = option_index_ref(item->options_index);
+    d_item->default_value = cl_object_ref(item->default_value);
+    d_item->min = cl_object_ref(item->min);
+    d_item->max = cl_object_ref(item->max);
 
     d_item->mode = item->mode;
     d_item->widget_type = item->widget_type;
     d_item->widget_checklist_type = item->widget_checklist_type;
     d_item->string_length = item->string_length;
+    d_item->validator = item->validator;
 
-    d_item->list_items = cl_stringlist_dup(item->list_items);
-    d_item->default_value = cl_object_dup(item->default_value);
-    d_item->min = cl_object_dup(item->min);
-    d_item->max = cl_object_dup(item->max);
+    /* Copy overrides */
+    d_item->object_id = cl_string_dup(item->object_id);
+    cl_string_cat(d_item->object_id, "_%d", menu_index);
+    d_item->referenced_menu = cl_string_dup(item->referenced_menu);
+    cl_string_cat(d_item->referenced_menu, "_%d", menu_index);
 
     if (is_menu_item(d_item->type) == false) {
-        d_item->config_item = cl_string_dup(item->config_item);
-        d_item->config_block = create_item_config_block(menu, menu_index, item);
+        d_item->config_item = cl_string_ref(item->config_item);
+        d_item->config_block =
+            intern_string(strings, create_item_config_block(menu, menu_index,
+                                                             item));
     }
 
-    if (item_has_ranges(d_item->widget_type) == true)
-        d_item->value_spec = cl_spec_create(CL_READABLE | CL_WRITABLE,
-                                            d_item->min, d_item->max,
-                                            d_item->string_length);
+    return d_item;
+}
 
-    cl_list_unref(node);
+static int dup_menu_item(cl_list_node_t *node, void *a)
+{
+    struct xante_item *item = cl_list_node_content(node), *d_item = NULL;
+    struct dup_data *dd = (struct dup_data *)a;
 
-    return d_item;
+    d_item = dup_item(dd->menu, item, dd->menu_index, dd->strings);
+
+    if (NULL == d_item)
+        return -1;
+
+    cl_list_unshift(dd->d_menu->items, d_item, -1);
+
+    return 0;
 }
 
+/*
+ * Creates a copy of a menu as a stub. Its items are only created by
+ * dm_materialize.
+ */
 static struct xante_menu *dup_menu(struct xante_menu *menu, int copy_index,
     const char *input_name)
 {
-    int total_items = 0, i;
-    struct xante_item *d_item = NULL;
     struct xante_menu *d_menu = NULL;
 
-    d_menu = xante_menu_create(XANTE_MENU_CREATED_INTERNALLY);
-    total_items = cl_list_size(menu->items);
+    d_menu = xante_menu_create(XANTE_MENU_CREATED_INTERNALLY, NULL);
+
+    if (NULL == d_menu)
+        return NULL;
 
     /* Duplicate all menu information */
     d_menu->name = create_menu_name(menu, copy_index, input_name);
     d_menu->object_id = create_object_id(menu, copy_index);
     d_menu->menu_type = menu->menu_type;
 
-    for (i = 0; i < total_items; i++) {
-        d_item = dup_item(menu, i, copy_index);
-        cl_list_unshift(d_menu->items, d_item, -1);
-    }
+    xante_menu_ref(menu);
+    d_menu->dynamic_template = menu;
+    d_menu->dynamic_copy_index = copy_index;
 
     return d_menu;
 }
 
+static int materialize_menu(cl_list_node_t *node, void *a)
+{
+    struct xante_menu *menu = cl_list_node_content(node);
+
+    dm_materialize((struct xante_app *)a, menu);
+
+    return 0;
+}
+
+static int release_stub(cl_list_node_t *node, void *a)
+{
+    struct xante_menu *menu = cl_list_node_content(node);
+    struct xante_app *xpp = (struct xante_app *)a;
+
+    if (menu->dynamic_template != NULL)
+        xpp->ui.stub_menus--;
+
+    return 0;
+}
+
+static void release_copy(struct xante_app *xpp, struct dm_copy *copy)
+{
+    if (NULL == copy->menus)
+        return;
+
+    cl_list_map(copy->menus, release_stub, xpp);
+    cl_list_destroy(copy->menus);
+    copy->menus = NULL;
+}
+
 static int replicate(struct xante_app *xpp, struct xante_menu *menu,
-    int copies, int first_copy_index, const char *input_name)
+    struct dm_copy *copies, int number_of_copies, int first_copy_index,
+    const char *input_name)
 {
     int i, j;
     struct xante_menu *d_menu = NULL;
 
-    /* Replicate the menu _N_ times */
-    for (i = 0, j = first_copy_index; i < copies; i++, j++) {
+    /* Replicate the menu _N_ times, each one into its own copy */
+    for (i = 0, j = first_copy_index; i < number_of_copies; i++, j++) {
         d_menu = dup_menu(menu, j, input_name);
 
-        /*
-         * XXX: Insert the new menu at the of the list, so it does not
-         *      mess with our mapping.
-         */
-        cl_list_unshift(xpp->ui.menus, d_menu, -1);
+        if (NULL == d_menu)
+            return -1;
+
+        /* Only copies loaded with the settings take their values */
+        d_menu->dynamic_from_settings = copies[i].from_settings;
+        xpp->ui.stub_menus++;
+        cl_list_unshift(copies[i].menus, d_menu, -1);
     }
 
     return 0;
@@ -282,7 +379,7 @@ static int find_submenu_to_replicate(cl_list_node_t *a, void *b)
         menu = xante_menu_search_by_object_id(ld->xpp->ui.menus,
                                               cl_string_valueof(item->referenced_menu));
 
-        if (dm_replicate(ld->xpp, menu, ld->number_of_copies,
+        if (dm_replicate(ld->xpp, menu, ld->copies, ld->number_of_copies,
                          ld->first_copy_index, ld->input_name) < 0)
         {
             return -1;
@@ -293,13 +390,15 @@ static int find_submenu_to_replicate(cl_list_node_t *a, void *b)
 }
 
 static int dm_replicate(struct xante_app *xpp, struct xante_menu *menu,
-    int copies, int first_copy_index, const char *input_name)
+    struct dm_copy *copies, int number_of_copies, int first_copy_index,
+    const char *input_name)
 {
     cl_list_node_t *node;
     struct list_data ld = {
         .xpp = xpp,
         .first_copy_index = first_copy_index,
-        .number_of_copies = copies,
+        .number_of_copies = number_of_copies,
+        .copies = copies,
         .menu = menu,
     };
 
@@ -309,8 +408,11 @@ static int dm_replicate(struct xante_app *xpp, struct xante_menu *menu,
     node = cl_list_map(menu->items, find_submenu_to_replicate, &ld);
 
     if (NULL == node) {
-        if (replicate(xpp, menu, copies, first_copy_index, input_name) < 0)
+        if (replicate(xpp, menu, copies, number_of_copies, first_copy_index,
+                      input_name) < 0)
+        {
             return -1;
+        }
 
         return 0; /* ok */
     }
@@ -325,7 +427,7 @@ static struct xante_item *create_rme_item(struct xante_menu *menu,
 {
     struct xante_item *item = NULL;
 
-    item = xante_item_create();
+    item = xante_item_create(NULL);
 
     /* Create the required item's information */
 
@@ -351,30 +453,191 @@ static struct xante_item *create_rme_item(struct xante_menu *menu,
     return item;
 }
 
-static void rme_create(struct xante_app *xpp, struct xante_menu *menu,
-    int copies)
+static struct xante_menu *rme_create(struct xante_app *xpp,
+    struct xante_menu *menu)
 {
     struct xante_menu *rme = NULL;
-    struct xante_item *rme_item = NULL;
-    int i;
 
-    rme = xante_menu_create(XANTE_MENU_CREATED_INTERNALLY);
+    rme = xante_menu_create(XANTE_MENU_CREATED_INTERNALLY, NULL);
+
+    if (NULL == rme)
+        return NULL;
 
     /* Create some required menu's information */
     rme->name = cl_string_dup(menu->name);
     rme->object_id = cl_string_dup(menu->object_id);
     rme->menu_type = XANTE_MENU_DEFAULT;
 
-    /* Create items to point at every previously created (sub)menu */
-    for (i = 0; i < copies; i++) {
-        rme_item = create_rme_item(menu, i, NULL);
-        cl_list_unshift(rme->items, rme_item, -1);
-    }
-
     cl_list_unshift(xpp->ui.menus, rme, -1);
 
     /* Mark the original menu to be released from our main list */
     menu->move_to_be_released = true;
+
+    return rme;
+}
+
+static int dm_entry_reserve(struct dm_entry *entry, int total)
+{
+    struct dm_copy *copies = NULL;
+    int allocated;
+
+    if (total <= entry->allocated_copies)
+        return 0;
+
+    allocated = max(total, max(4, entry->allocated_copies * 2));
+    copies = realloc(entry->copies, allocated * sizeof(struct dm_copy));
+
+    if (NULL == copies)
+        return -1;
+
+    entry->copies = copies;
+    entry->allocated_copies = allocated;
+
+    return 0;
+}
+
+/*
+ * Creates @entries_to_add new copies at the end of a dynamic menu, one
+ * entry inside its RME for each one. Copies created @from_settings have
+ * their values loaded from them, the others start with default values.
+ */
+static int dm_add(struct xante_app *xpp, struct dm_entry *entry,
+    int entries_to_add, const char *input_name, bool from_settings)
+{
+    int i, current_copies = entry->total_copies;
+    struct dm_copy *copies = NULL;
+    struct xante_item *rme_item = NULL;
+
+    if (dm_entry_reserve(entry, current_copies + entries_to_add) < 0)
+        return -1;
+
+    copies = entry->copies + current_copies;
+
+    for (i = 0; i < entries_to_add; i++) {
+        copies[i].index = current_copies + i;
+        copies[i].from_settings = from_settings;
+        copies[i].menus = cl_list_create(xante_menu_destroy, NULL, NULL, NULL);
+
+        if (NULL == copies[i].menus)
+            goto error_block;
+    }
+
+    /* Replicate the original menu */
+    if (dm_replicate(xpp, entry->template, copies, entries_to_add,
+                     current_copies, input_name) < 0)
+    {
+        goto error_block;
+    }
+
+    /* Add entries to the RME menu */
+    for (i = 0; i < entries_to_add; i++) {
+        rme_item = create_rme_item(entry->template, i + current_copies,
+                                   input_name);
+
+        copies[i].rme_item = rme_item;
+        cl_list_unshift(entry->rme->items, rme_item, -1);
+    }
+
+    entry->total_copies += entries_to_add;
+
+    return 0;
+
+error_block:
+    for (i = 0; i < entries_to_add; i++)
+        release_copy(xpp, &copies[i]);
+
+    return -1;
+}
+
+static int is_rme_item(cl_list_node_t *node, void *a)
+{
+    return (cl_list_node_content(node) == a) ? 1 : 0;
+}
+
+/*
+ * Removes a single copy of a dynamic menu, its RME entry and everything
+ * that was created for it. The RME entry is the one kept by the copy, so
+ * it's unlinked without being looked up by its position.
+ */
+static void dm_remove_copy(struct xante_app *xpp, struct dm_entry *entry,
+    int position)
+{
+    if ((position < 0) || (position >= entry->total_copies))
+        return;
+
+    cl_list_delete(entry->rme->items, is_rme_item,
+                   entry->copies[position].rme_item);
+
+    release_copy(xpp, &entry->copies[position]);
+    memmove(entry->copies + position, entry->copies + position + 1,
+            (entry->total_copies - position - 1) * sizeof(struct dm_copy));
+
+    entry->total_copies--;
+}
+
+static void dm_remove(struct xante_app *xpp, struct dm_entry *entry,
+    int entries_to_remove)
+{
+    int i;
+
+    for (i = 0; i < entries_to_remove; i++)
+        dm_remove_copy(xpp, entry, entry->total_copies - 1);
+}
+
+static struct dm_entry *dm_entry_create(struct xante_app *xpp,
+    struct xante_menu *menu)
+{
+    struct dm_registry *registry = xpp->ui.dynamic_menus;
+    struct dm_entry *entries = NULL, *entry = NULL;
+    pthread_mutexattr_t attr;
+
+    if (NULL == registry) {
+        registry = calloc(1, sizeof(struct dm_registry));
+
+        if (NULL == registry)
+            return NULL;
+
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+        pthread_mutex_init(&registry->lock, &attr);
+        pthread_mutexattr_destroy(&attr);
+        xpp->ui.dynamic_menus = registry;
+    }
+
+    entries = realloc(registry->entries,
+                      (registry->total_entries + 1) * sizeof(struct dm_entry));
+
+    if (NULL == entries)
+        return NULL;
+
+    registry->entries = entries;
+    entry = &registry->entries[registry->total_entries];
+    memset(entry, 0, sizeof(struct dm_entry));
+    entry->rme = rme_create(xpp, menu);
+
+    if (NULL == entry->rme)
+        return NULL;
+
+    xante_menu_ref(menu);
+    entry->template = menu;
+    xante_menu_ref(entry->rme);
+    registry->total_entries++;
+
+    return entry;
+}
+
+static void dm_entry_destroy(struct xante_app *xpp, struct dm_entry *entry)
+{
+    int i;
+
+    for (i = 0; i < entry->total_copies; i++)
+        release_copy(xpp, &entry->copies[i]);
+
+    if (entry->copies != NULL)
+        free(entry->copies);
+
+    xante_menu_unref(entry->rme);
+    xante_menu_unref(entry->template);
 }
 
 static int dm_push_menu(cl_list_node_t *a, void *b)
@@ -383,6 +646,7 @@ static int dm_push_menu(cl_list_node_t *a, void *b)
     struct list_data *ld = (struct list_data *)b;
     struct xante_app *xpp = ld->xpp;
     cl_cfg_file_t *cfg_file = ld->cfg_file;
+    struct dm_entry *entry = NULL;
     int copies = -1;
 
     /* Don't need to handle internally create menus */
@@ -395,12 +659,16 @@ static int dm_push_menu(cl_list_node_t *a, void *b)
     /* Discover how many copies we'll have from this menu */
     copies = dm_find_number_of_copies(xpp, cfg_file, menu);
 
-    /* Replicate menus (submenus and items) */
-    if (dm_replicate(xpp, menu, copies, 0, NULL) < 0)
+    /* Create the reference menu entry (RME) */
+    entry = dm_entry_create(xpp, menu);
+
+    if (NULL == entry)
         return -1;
 
-    /* Create the reference menu entry (RME) */
-    rme_create(xpp, menu, copies);
+    /* Replicate menus (submenus and items) */
+    if ((copies > 0) &&
+        (dm_add(xpp, entry, copies, NULL, (cfg_file != NULL)) < 0))
+        return -1;
 
     return 0;
 }
@@ -422,80 +690,117 @@ static void unreference_menus(struct xante_app *xpp)
     xpp->ui.unreferenced_menus = cl_list_filter(xpp->ui.menus, NULL);
 }
 
-static int find_dm(cl_list_node_t *node, void *a)
+static bool is_origin_item(const struct xante_menu *menu,
+    const struct xante_item *item)
 {
-    struct xante_menu *menu = cl_list_node_content(node);
-    struct xante_item *item = (struct xante_item *)a;
-
-    if (menu->menu_type == XANTE_MENU_DEFAULT)
-        return 0;
-
     if (menu->dynamic_names != NULL)
-        return 0;
+        return false;
 
     if (menu->copies != -1)
-        return 0;
+        return false;
 
-    if ((cl_string_cmp(menu->dynamic_origin_block, item->config_block) == 0) &&
-        (cl_string_cmp(menu->dynamic_origin_item, item->config_item) == 0))
+    if (intern_equals(menu->dynamic_origin_block, item->config_block) &&
+        intern_equals(menu->dynamic_origin_item, item->config_item))
     {
-        return 1;
+        return true;
     }
 
-    return 0;
+    return false;
 }
 
-static struct xante_menu *get_unref_menu(struct xante_app *xpp,
+static struct dm_entry *dm_entry_by_origin(struct xante_app *xpp,
     struct xante_item *item)
 {
-    cl_list_node_t *node;
-    struct xante_menu *menu;
+    struct dm_registry *registry = xpp->ui.dynamic_menus;
+    struct dm_entry *entry = NULL;
+    int i;
 
-    node = cl_list_map(xpp->ui.unreferenced_menus, find_dm, item);
+    if (NULL == registry)
+        return NULL;
 
-    if (NULL == node)
+    for (i = 0; i < registry->total_entries; i++) {
+        entry = &registry->entries[i];
+
+        if (entry->origin == item)
+            return entry;
+
+        if (is_origin_item(entry->template, item)) {
+            entry->origin = item;
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static struct dm_entry *dm_entry_by_object_id(struct xante_app *xpp,
+    const char *object_id)
+{
+    struct dm_registry *registry = xpp->ui.dynamic_menus;
+    int i;
+
+    if (NULL == registry)
         return NULL;
 
-    menu = cl_list_node_content(node);
-    cl_list_node_unref(node);
+    for (i = 0; i < registry->total_entries; i++)
+        if (strcmp(cl_string_valueof(registry->entries[i].template->object_id),
+                   object_id) == 0)
+        {
+            return &registry->entries[i];
+        }
 
-    return menu;
+    return NULL;
 }
 
-static void dm_remove(struct xante_menu *rme, int entries_to_remove)
+static struct dm_entry *dm_entry_by_rme(struct xante_app *xpp,
+    const struct xante_menu *rme)
 {
+    struct dm_registry *registry = xpp->ui.dynamic_menus;
     int i;
-    cl_list_node_t *node;
 
-    for (i = 0; i < entries_to_remove; i++) {
-        node = cl_list_shift(rme->items);
-        cl_list_node_unref(node);
-    }
+    if (NULL == registry)
+        return NULL;
+
+    for (i = 0; i < registry->total_entries; i++)
+        if (registry->entries[i].rme == rme)
+            return &registry->entries[i];
+
+    return NULL;
 }
 
-static void dm_add(struct xante_app *xpp, struct xante_menu *rme,
-    struct xante_menu *unreferenced_menu, int entries_to_add,
-    const char *input_name)
+/*
+ * Copies always end with their index, so only copies with the same index
+ * need to be looked at.
+ */
+static int copy_index_of(const char *object_id)
 {
-    int i, current_copies;
-    struct xante_item *rme_item = NULL;
+    const char *p = strrchr(object_id, '_');
+    char *end = NULL;
+    long index;
 
-    current_copies = cl_list_size(rme->items);
+    if ((NULL == p) || (*(p + 1) == '\0'))
+        return -1;
 
-    /* Replicate the unreferenced_menu */
-    if (dm_replicate(xpp, unreferenced_menu, entries_to_add,
-                     current_copies, input_name) < 0)
-    {
-        return;
-    }
+    index = strtol(p + 1, &end, 10);
 
-    /* Add entries to the RME menu */
-    for (i = 0; i < entries_to_add; i++) {
-        rme_item = create_rme_item(unreferenced_menu, i + current_copies,
-                                   input_name);
+    if (*end != '\0')
+        return -1;
 
-        cl_list_unshift(rme->items, rme_item, -1);
-    }
+    return (int)index;
+}
+
+static int search_copy_by_object_id(cl_list_node_t *node, void *a)
+{
+    struct xante_menu *menu = cl_list_node_content(node);
+
+    return strcmp(cl_string_valueof(menu->object_id), (char *)a) == 0;
+}
+
+static int search_copy_by_name(cl_list_node_t *node, void *a)
+{
+    struct xante_menu *menu = cl_list_node_content(node);
+
+    return strcmp(cl_string_valueof(menu->name), (char *)a) == 0;
 }
 
 /*
@@ -518,6 +823,10 @@ static void dm_add(struct xante_app *xpp, struct xante_menu *rme,
  * The original menu will be put in a secondary list. To serve as a base
  * for new copies on the fly.
  *
+ * Copies aren't kept inside the main menu list. They're registered by their
+ * original menu, each one with its own submenus, so adding or removing them
+ * only touches the copies involved.
+ *
  * @param [in,out] xpp: The library main object.
  * @param [in] cfg_file: The cl_cfg_file_t pointer to the application
  *                       configurations.
@@ -541,10 +850,233 @@ void dm_init(struct xante_app *xpp, cl_cfg_file_t *cfg_file)
  */
 void dm_uninit(struct xante_app *xpp)
 {
+    struct dm_registry *registry = xpp->ui.dynamic_menus;
+    int i;
+
+    if (registry != NULL) {
+        for (i = 0; i < registry->total_entries; i++)
+            dm_entry_destroy(xpp, &registry->entries[i]);
+
+        if (registry->entries != NULL)
+            free(registry->entries);
+
+        pthread_mutex_destroy(&registry->lock);
+        free(registry);
+        xpp->ui.dynamic_menus = NULL;
+    }
+
     if (xpp->ui.unreferenced_menus != NULL)
         cl_list_destroy(xpp->ui.unreferenced_menus);
 }
 
+/**
+ * @name dm_lock
+ * @brief Holds the dynamic menu copies, so they're not materialized, added
+ *        or removed by another thread.
+ *
+ * It may be called again by the same thread.
+ *
+ * @param [in] xpp: The library main object.
+ */
+void dm_lock(const struct xante_app *xpp)
+{
+    if (xpp->ui.dynamic_menus != NULL)
+        pthread_mutex_lock(&xpp->ui.dynamic_menus->lock);
+}
+
+/**
+ * @name dm_unlock
+ * @brief Releases the dynamic menu copies held with 'dm_lock'.
+ *
+ * @param [in] xpp: The library main object.
+ */
+void dm_unlock(const struct xante_app *xpp)
+{
+    if (xpp->ui.dynamic_menus != NULL)
+        pthread_mutex_unlock(&xpp->ui.dynamic_menus->lock);
+}
+
+/**
+ * @name dm_materialize
+ * @brief Creates the items of a dynamic menu copy.
+ *
+ * Copies are created as stubs and only get their items when they're
+ * entered or searched for the first time. Copies loaded with the settings
+ * also get their values from them. Any other menu is left untouched.
+ *
+ * @param [in,out] xpp: The library main object.
+ * @param [in,out] menu: The menu.
+ */
+void dm_materialize(struct xante_app *xpp, struct xante_menu *menu)
+{
+    struct xante_menu *template = NULL;
+    cl_list_node_t *node = NULL;
+    struct dup_data dd;
+
+    if (NULL == menu)
+        return;
+
+    dm_lock(xpp);
+
+    if (NULL == menu->dynamic_template) {
+        dm_unlock(xpp);
+        return;
+    }
+
+    template = menu->dynamic_template;
+    dd.menu = template;
+    dd.d_menu = menu;
+    dd.menu_index = menu->dynamic_copy_index;
+    dd.strings = xpp->ui.strings;
+    node = cl_list_map(template->items, dup_menu_item, &dd);
+
+    if (node != NULL)
+        cl_list_node_unref(node);
+
+    if (menu->dynamic_from_settings)
+        config_load_menu(xpp, menu);
+
+    menu->dynamic_template = NULL;
+    xante_menu_unref(template);
+    xpp->ui.stub_menus--;
+    dm_unlock(xpp);
+}
+
+/**
+ * @name dm_materialize_all
+ * @brief Creates the items of every dynamic menu copy not created yet.
+ *
+ * @param [in,out] xpp: The library main object.
+ */
+void dm_materialize_all(struct xante_app *xpp)
+{
+    dm_lock(xpp);
+
+    if (xpp->ui.stub_menus > 0)
+        dm_map_menus(xpp, materialize_menu, xpp);
+
+    dm_unlock(xpp);
+}
+
+/**
+ * @name dm_map_menus
+ * @brief Calls a function for every menu created as a dynamic menu copy.
+ *
+ * These menus aren't kept inside the main menu list, so every function
+ * that needs to go through all menus must also use this one.
+ *
+ * @param [in] xpp: The library main object.
+ * @param [in] foo: The function, with the same semantics of a cl_list_map
+ *                  callback.
+ * @param [in] data: Custom data passed to the function.
+ *
+ * @return Returns the node where \a foo returned a non-zero value (which
+ *         must be released by the caller) or NULL otherwise.
+ */
+cl_list_node_t *dm_map_menus(const struct xante_app *xpp,
+    int (*foo)(cl_list_node_t *, void *), void *data)
+{
+    struct dm_registry *registry = xpp->ui.dynamic_menus;
+    struct dm_entry *entry = NULL;
+    cl_list_node_t *node = NULL;
+    int i, j;
+
+    if (NULL == registry)
+        return NULL;
+
+    dm_lock(xpp);
+
+    for (i = 0; (i < registry->total_entries) && (NULL == node); i++) {
+        entry = &registry->entries[i];
+
+        for (j = 0; (j < entry->total_copies) && (NULL == node); j++)
+            node = cl_list_map(entry->copies[j].menus, foo, data);
+    }
+
+    dm_unlock(xpp);
+
+    return node;
+}
+
+/**
+ * @name dm_search_menu_by_object_id
+ * @brief Searches a dynamic menu copy by its object_id.
+ *
+ * @param [in] xpp: The library main object.
+ * @param [in] object_id: The menu object_id.
+ *
+ * @return On success returns a pointer to the menu or NULL otherwise.
+ */
+struct xante_menu *dm_search_menu_by_object_id(const struct xante_app *xpp,
+    const char *object_id)
+{
+    struct dm_registry *registry = xpp->ui.dynamic_menus;
+    struct dm_entry *entry = NULL;
+    struct xante_menu *menu = NULL;
+    cl_list_node_t *node = NULL;
+    int i, j, index;
+
+    if ((NULL == registry) || (NULL == object_id))
+        return NULL;
+
+    index = copy_index_of(object_id);
+
+    if (index < 0)
+        return NULL;
+
+    dm_lock(xpp);
+
+    for (i = 0; (i < registry->total_entries) && (NULL == node); i++) {
+        entry = &registry->entries[i];
+
+        for (j = 0; (j < entry->total_copies) && (NULL == node); j++) {
+            if (entry->copies[j].index != index)
+                continue;
+
+            node = cl_list_map(entry->copies[j].menus,
+                               search_copy_by_object_id, (void *)object_id);
+        }
+    }
+
+    dm_unlock(xpp);
+
+    if (node != NULL) {
+        menu = cl_list_node_content(node);
+        cl_list_node_unref(node);
+    }
+
+    return menu;
+}
+
+/**
+ * @name dm_search_menu_by_name
+ * @brief Searches a dynamic menu copy by its name.
+ *
+ * @param [in] xpp: The library main object.
+ * @param [in] name: The menu name.
+ *
+ * @return On success returns a pointer to the menu or NULL otherwise.
+ */
+struct xante_menu *dm_search_menu_by_name(const struct xante_app *xpp,
+    const char *name)
+{
+    struct xante_menu *menu = NULL;
+    cl_list_node_t *node = NULL;
+
+    if (NULL == name)
+        return NULL;
+
+    node = dm_map_menus(xpp, search_copy_by_name, (void *)name);
+
+    if (NULL == node)
+        return NULL;
+
+    menu = cl_list_node_content(node);
+    cl_list_node_unref(node);
+
+    return menu;
+}
+
 /**
  * @name dm_update
  * @brief Updates a dynamic menu pointed by an item.
@@ -554,42 +1086,49 @@ void dm_uninit(struct xante_app *xpp)
  *
  * @param [in,out] xpp: The library main object.
  * @param [in] selected_item: The item pointing to a dynamic menu.
+ *
+ * @return Returns true if copies of the dynamic menu were added or removed
+ *         or false otherwise.
  */
-void dm_update(struct xante_app *xpp, struct xante_item *selected_item)
+bool dm_update(struct xante_app *xpp, struct xante_item *selected_item)
 {
-    struct xante_menu *unref_menu = NULL, *rme_menu = NULL;
+    struct dm_entry *entry = NULL;
     int expected_copies = -1, current_copies = -1;
+    bool updated = false;
 
     if (selected_item->widget_type != XANTE_WIDGET_INPUT_INT)
-        return;
-
-    expected_copies = CL_OBJECT_AS_INT(item_value(selected_item));
-    unref_menu = get_unref_menu(xpp, selected_item);
-
-    if (NULL == unref_menu) {
-        // error msg
-        return;
-    }
+        return false;
 
-    rme_menu =
-        xante_menu_search_by_object_id(xpp->ui.menus,
-                                       cl_string_valueof(unref_menu->object_id));
+    expected_copies = max(0, CL_OBJECT_AS_INT(item_value(selected_item)));
+    dm_lock(xpp);
+    entry = dm_entry_by_origin(xpp, selected_item);
 
-    if (NULL == rme_menu) {
+    if (NULL == entry) {
         // error msg
-        return;
+        goto end_block;
     }
 
-    current_copies = cl_list_size(rme_menu->items);
+    current_copies = entry->total_copies;
 
     if (expected_copies == current_copies)
-        return;
+        goto end_block;
 
+    /* New copies start with default values, as new entries do */
     if (expected_copies > current_copies) {
-        dm_add(xpp, rme_menu, unref_menu, abs(expected_copies - current_copies),
-               NULL);
+        if (dm_add(xpp, entry, expected_copies - current_copies, NULL,
+                   false) < 0)
+        {
+            goto end_block;
+        }
     } else
-        dm_remove(rme_menu, abs(expected_copies - current_copies));
+        dm_remove(xpp, entry, current_copies - expected_copies);
+
+    updated = true;
+
+end_block:
+    dm_unlock(xpp);
+
+    return updated;
 }
 
 /**
@@ -597,14 +1136,26 @@ void dm_update(struct xante_app *xpp, struct xante_item *selected_item)
  * @brief Deletes a dynamic menu from the internal menus.
  *
  * The function will remove a dynamic menu by removing a specific \a position
- * from the RME menu.
+ * from the RME menu. Its copy menus and items are released as well.
  *
+ * @param [in,out] xpp: The library main object.
  * @param [in,out] rme_menu: The RME menu.
  * @param [in] position: The item position to be removed.
  */
-void dm_delete(struct xante_menu *rme_menu, int position)
+void dm_delete(struct xante_app *xpp, struct xante_menu *rme_menu,
+    int position)
 {
-    cl_list_delete_indexed(rme_menu->items, position);
+    struct dm_entry *entry = NULL;
+
+    dm_lock(xpp);
+    entry = dm_entry_by_rme(xpp, rme_menu);
+
+    if (NULL == entry)
+        cl_list_delete_indexed(rme_menu->items, position);
+    else
+        dm_remove_copy(xpp, entry, position);
+
+    dm_unlock(xpp);
 }
 
 /**
@@ -623,31 +1174,34 @@ void dm_delete(struct xante_menu *rme_menu, int position)
 bool dm_insert(struct xante_app *xpp, struct xante_item *item,
     const char *new_entry_name)
 {
-    struct xante_menu *unref_menu = NULL, *rme_menu = NULL;
+    struct dm_entry *entry = NULL;
     const char *referenced_menu = cl_string_valueof(item->referenced_menu);
+    int ret = -1;
+
+    dm_lock(xpp);
+    entry = dm_entry_by_object_id(xpp, referenced_menu);
+
+    if (entry != NULL)
+        ret = dm_add(xpp, entry, 1, new_entry_name, false);
 
-    unref_menu = xante_menu_search_by_object_id(xpp->ui.unreferenced_menus,
-                                                referenced_menu);
+    dm_unlock(xpp);
 
-    if (NULL == unref_menu) {
+    /* Messages are only displayed after releasing the copies */
+    if (NULL == entry) {
         xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
                              cl_tr("The menu '%s' was not found!"), referenced_menu);
 
         return false;
     }
 
-    rme_menu = xante_menu_search_by_object_id(xpp->ui.menus, referenced_menu);
-
-    if (NULL == rme_menu) {
+    if (ret < 0) {
         xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                             cl_tr("A reference for the menu '%s' was not found!"),
+                             cl_tr("A copy of the menu '%s' could not be created!"),
                              referenced_menu);
 
         return false;
     }
 
-    dm_add(xpp, rme_menu, unref_menu, 1, new_entry_name);
-
     return true;
 }
 
@@ -161,3 +161,46 @@ __PUB_API__ char *xante_env_cfg_path(void)
     return strdup(env);
 }
 
+/**
+ * @name xante_env_set_trace_path
+ * @brief Sets the file where the application startup trace is written.
+ *
+ * Setting it enables the trace, even without the XANTE_TRACE_STARTUP flag.
+ *
+ * @param [in] pathname: The file path.
+ *
+ * @return On success returns 0 or -1 otherwise.
+ */
+__PUB_API__ int xante_env_set_trace_path(const char *pathname)
+{
+    errno_clear();
+
+    if (NULL == pathname) {
+        errno_set(XANTE_ERROR_NULL_ARG);
+        return -1;
+    }
+
+    setenv(ENV_XANTE_TRACE_PATH, pathname, 1);
+
+    return 0;
+}
+
+/**
+ * @name xante_env_trace_path
+ * @brief Gets the current startup trace file path.
+ *
+ * @return On success returns the path, which must be freed after used, or
+ *         NULL otherwise.
+ */
+__PUB_API__ char *xante_env_trace_path(void)
+{
+    char *env = NULL;
+
+    env = getenv(ENV_XANTE_TRACE_PATH);
+
+    if (NULL == env)
+        return NULL;
+
+    return strdup(env);
+}
+
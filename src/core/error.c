@@ -97,7 +97,12 @@ static const char *__description[] = {
     cl_tr_noop("item was not found"),                                   //*
     cl_tr_noop("invalid form JSON"),                                    //*
     cl_tr_noop("item has no data object"),                              //*
+    cl_tr_noop("unknown object prefix"),                                //*
     cl_tr_noop("item has no internal value"),
+    cl_tr_noop("invalid item value"),                                   //*
+    cl_tr_noop("item value cannot be changed"),                         //*
+    cl_tr_noop("invalid change set"),                                   //*
+    cl_tr_noop("unable to save the settings file"),                     //*
 };
 
 static const char *__unknown_error = cl_tr_noop("Unknown error");
@@ -25,9 +25,25 @@
  */
 
 #include <stdarg.h>
+#include <pthread.h>
 
 #include "libxante.h"
 
+/* Maximum number of asynchronous events waiting to be called */
+#define ASYNC_EVENTS_MAX_PENDING        64
+
+/* Maximum number of workers calling asynchronous events together */
+#define ASYNC_EVENTS_MAX_WORKERS        2
+
+/*
+ * Events may also be called by the thread posting them, or finishing the
+ * application, when no worker is taking them.
+ */
+#define ASYNC_EVENTS_MAX_RUNNING        (ASYNC_EVENTS_MAX_WORKERS + 2)
+
+/* Maximum time spent calling the events left when finishing */
+#define ASYNC_EVENTS_DRAIN_TIMEOUT      5000 /* milliseconds */
+
 struct module_function {
     bool    found;
     bool    need_internal_dispatch;
@@ -36,6 +52,38 @@ struct module_function {
     char    name[512];
 };
 
+/*
+ * An event called outside the UI thread. It keeps its own copy (or
+ * reference) of everything the event function receives. Item events
+ * receive a snapshot of the item, taken when they were posted, and the
+ * function to call is resolved at the same time.
+ */
+struct async_event {
+    const char              *event_name;
+    const void              *key;
+    struct module_function  function;
+    struct xante_item       *item;
+    cl_cfg_file_t           *cfg_file;
+    cl_list_t               *changes;
+    struct async_event      *next;
+};
+
+/*
+ * Asynchronous events are queued here and called by a few executor tasks.
+ * Events from the same item (or the application ones) are never called at
+ * the same time, so they keep the order in which they were posted.
+ */
+struct event_pool {
+    pthread_mutex_t     lock;
+    pthread_cond_t      idle;
+    struct async_event  *head;
+    struct async_event  *tail;
+    int                 pending;
+    int                 active_workers;
+    const void          *running[ASYNC_EVENTS_MAX_RUNNING];
+    bool                draining;
+};
+
 /*
  *
  * Internal functions
@@ -46,12 +94,17 @@ static int ev_void(struct xante_app *xpp, const char *event_name)
 {
     cl_object_t *ret = NULL;
     int event_return = 0;
+    struct timespec start;
 
     xante_log_info("%s: chamando %s", __FUNCTION__, event_name);
+    stats_event_start(&start);
     ret = cl_plugin_call(xpp->module.module, event_name, CL_INT,
                          XANTE_ARG_XANTE_APP, CL_POINTER, false, xpp, -1, NULL,
                          NULL);
 
+    stats_event_record(xpp, event_name, event_name, STATS_ORIGIN_MODULE,
+                       &start, (NULL == ret));
+
     if (strcmp(event_name, EV_INIT) == 0)
         event_return = CL_OBJECT_AS_INT(ret);
 
@@ -60,17 +113,21 @@ static int ev_void(struct xante_app *xpp, const char *event_name)
     return event_return;
 }
 
-static void ev_config(struct xante_app *xpp, const char *event_name, va_list ap)
+static void ev_config(struct xante_app *xpp, const char *event_name,
+    cl_cfg_file_t *cfg_file)
 {
     cl_object_t *ret = NULL;
-    cl_cfg_file_t *cfg_file = NULL;
+    struct timespec start;
 
-    cfg_file = va_arg(ap, void *);
+    stats_event_start(&start);
     ret = cl_plugin_call(xpp->module.module, event_name, CL_VOID,
                          XANTE_ARG_XANTE_APP, CL_POINTER, false, xpp, -1, NULL,
                          XANTE_ARG_CFG_FILE, CL_POINTER, false, cfg_file, -1, NULL,
                          NULL);
 
+    stats_event_record(xpp, event_name, event_name, STATS_ORIGIN_MODULE,
+                       &start, (NULL == ret));
+
     cl_object_unref(ret);
 }
 
@@ -134,50 +191,52 @@ static struct module_function get_function_name(cl_json_t *events,
     return function;
 }
 
-static int ev_item(struct xante_app *xpp, const char *event_name, va_list ap)
+static enum stats_origin function_origin(const struct module_function *function)
 {
-    cl_object_t *ret = NULL, *data = NULL;
+    if (function->need_internal_dispatch)
+        return STATS_ORIGIN_INTERNAL;
+
+    return function->external_module ? STATS_ORIGIN_EXTERNAL
+                                     : STATS_ORIGIN_MODULE;
+}
+
+/*
+ * Calls an item event function. When called from @background no dialog is
+ * displayed, errors are only logged.
+ */
+static int item_function_call(struct xante_app *xpp, const char *event_name,
+    const struct module_function *function, struct xante_item *item,
+    void *data, bool background)
+{
+    cl_object_t *ret = NULL;
     cl_plugin_t *pl = NULL;
-    struct xante_item *item = NULL;
-    struct module_function function;
+    struct timespec start;
     int event_return = -1;
     bool unload = false;
 
-    item = va_arg(ap, void *);
-    function = get_function_name(item->events, event_name);
-
-    if (function.found == false) {
-        xante_log_debug(cl_tr("Event function from event [%s] not found"),
-                        event_name);
-
-        return 0; /* Should we return an error? */
-    }
+    stats_event_start(&start);
 
-    /*
-     * We need to pass the custom data, otherwise these routine calls (maybe)
-     * won't result in something useful.
-     */
-    if ((strcmp(event_name, EV_UPDATE_ROUTINE) == 0) ||
-        (strcmp(event_name, EV_SYNC_ROUTINE) == 0) ||
-        (strcmp(event_name, EV_VALUE_CHECK) == 0) ||
-        (strcmp(event_name, EV_VALUE_STRLEN) == 0))
-    {
-        data = va_arg(ap, void *);
-    }
-
-    if (function.need_internal_dispatch)
-        event_return = gadget_dispatch_call(function.name, xpp, item, data);
-    else {
-        if (function.external_module == false)
+    if (function->need_internal_dispatch) {
+        event_return = gadget_dispatch_call(function->name, xpp, item, data);
+        stats_event_record(xpp, event_name, function->name,
+                           STATS_ORIGIN_INTERNAL, &start, (event_return < 0));
+    } else {
+        if (function->external_module == false)
             pl = xpp->module.module;
         else {
-            pl = cl_plugin_load(function.module);
+            pl = cl_plugin_load(function->module);
 
             if (NULL == pl) {
-                xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                                     cl_tr("Trying to load external module '%s': %s!"),
-                                     function.module,
-                                     cl_strerror(cl_get_last_error()));
+                if (background) {
+                    xante_log_error(cl_tr("Trying to load external module '%s': %s!"),
+                                    function->module,
+                                    cl_strerror(cl_get_last_error()));
+                } else {
+                    xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                                         cl_tr("Trying to load external module '%s': %s!"),
+                                         function->module,
+                                         cl_strerror(cl_get_last_error()));
+                }
 
                 return -1;
             }
@@ -185,15 +244,21 @@ static int ev_item(struct xante_app *xpp, const char *event_name, va_list ap)
             unload = true;
         }
 
-        ret = cl_plugin_call(pl, function.name, CL_INT,
+        ret = cl_plugin_call(pl, function->name, CL_INT,
                              XANTE_ARG_XANTE_APP, CL_POINTER, false, xpp, -1, NULL,
                              XANTE_ARG_XANTE_ITEM, CL_POINTER, false, item, -1, NULL,
                              XANTE_ARG_DATA, CL_POINTER, false, data, -1, NULL,
                              NULL);
 
+        stats_event_record(xpp, event_name, function->name,
+                           function_origin(function), &start, (NULL == ret));
+
         if (NULL == ret) {
-            if ((strcmp(event_name, EV_CUSTOM) == 0) ||
-                (strcmp(event_name, EV_EXTRA_BUTTON_PRESSED) == 0))
+            if (background) {
+                xante_log_error("Event call error: %s",
+                                cl_strerror(cl_get_last_error()));
+            } else if ((strcmp(event_name, EV_CUSTOM) == 0) ||
+                       (strcmp(event_name, EV_EXTRA_BUTTON_PRESSED) == 0))
             {
                 xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
                                      "Event call error: %s",
@@ -223,12 +288,53 @@ static int ev_item(struct xante_app *xpp, const char *event_name, va_list ap)
     return event_return;
 }
 
+static int item_event(struct xante_app *xpp, const char *event_name,
+    struct xante_item *item, void *data, bool background)
+{
+    struct module_function function;
+
+    function = get_function_name(item->events, event_name);
+
+    if (function.found == false) {
+        xante_log_debug(cl_tr("Event function from event [%s] not found"),
+                        event_name);
+
+        return 0; /* Should we return an error? */
+    }
+
+    return item_function_call(xpp, event_name, &function, item, data,
+                              background);
+}
+
+static int ev_item(struct xante_app *xpp, const char *event_name, va_list ap)
+{
+    struct xante_item *item = NULL;
+    void *data = NULL;
+
+    item = va_arg(ap, void *);
+
+    /*
+     * We need to pass the custom data, otherwise these routine calls (maybe)
+     * won't result in something useful.
+     */
+    if ((strcmp(event_name, EV_UPDATE_ROUTINE) == 0) ||
+        (strcmp(event_name, EV_SYNC_ROUTINE) == 0) ||
+        (strcmp(event_name, EV_VALUE_CHECK) == 0) ||
+        (strcmp(event_name, EV_VALUE_STRLEN) == 0))
+    {
+        data = va_arg(ap, void *);
+    }
+
+    return item_event(xpp, event_name, item, data, false);
+}
+
 static int ev_menu(struct xante_app *xpp, const char *event_name, va_list ap)
 {
     cl_object_t *ret = NULL;
     struct xante_menu *menu = NULL;
     int event_return = 0;
     struct module_function function;
+    struct timespec start;
 
     menu = va_arg(ap, void *);
     function = get_function_name(menu->events, event_name);
@@ -236,11 +342,15 @@ static int ev_menu(struct xante_app *xpp, const char *event_name, va_list ap)
     if (function.found == false)
         return 0; /* Should we return an error? */
 
+    stats_event_start(&start);
     ret = cl_plugin_call(xpp->module.module, function.name, CL_INT,
                          XANTE_ARG_XANTE_APP, CL_POINTER, false, xpp, -1, NULL,
                          XANTE_ARG_XANTE_MENU, CL_POINTER, false, menu, -1, NULL,
                          NULL);
 
+    stats_event_record(xpp, event_name, function.name, STATS_ORIGIN_MODULE,
+                       &start, (NULL == ret));
+
     if (strcmp(event_name, EV_MENU_EXIT) == 0)
         event_return = CL_OBJECT_AS_INT(ret);
 
@@ -257,6 +367,8 @@ static int ev_item_value(struct xante_app *xpp, const char *event_name, va_list
     int event_return = 0;
     bool unload = false;
     struct module_function function;
+    struct timespec start;
+    const char *s = NULL;
 
     item = va_arg(ap, void *);
     function = get_function_name(item->events, event_name);
@@ -269,17 +381,35 @@ static int ev_item_value(struct xante_app *xpp, const char *event_name, va_list
     }
 
 
-    /* Parse the item value */
+    /*
+     * Parse the item value. It's always given as the text entered by the
+     * user (or by the application, when applying values in bulk), so numeric
+     * types are converted here.
+     */
+    s = va_arg(ap, char *);
+
+    if (NULL == s)
+        s = "";
+
     switch (item->widget_type) {
         case XANTE_WIDGET_INPUT_INT:
-        case XANTE_WIDGET_CHECKLIST:
         case XANTE_WIDGET_RADIO_CHECKLIST:
         case XANTE_WIDGET_YES_NO:
-            value = cl_object_create(CL_INT, va_arg(ap, int));
+            value = cl_object_create(CL_INT, (int)strtol(s, NULL, 10));
             break;
 
         case XANTE_WIDGET_INPUT_FLOAT:
-            value = cl_object_create(CL_FLOAT, (float)va_arg(ap, double));
+            value = cl_object_create(CL_FLOAT, strtof(s, NULL));
+            break;
+
+        case XANTE_WIDGET_CHECKLIST:
+
+            /* Selections wider than an int are only known as a string */
+            if (cl_stringlist_size(item->list_items) <= BITSET_INT_BITS)
+                value = cl_object_create(CL_INT, bitset_cstring_to_int(s));
+            else
+                value = cl_object_create(CL_STRING, s);
+
             break;
 
         case XANTE_WIDGET_INPUT_DATE:
@@ -288,16 +418,20 @@ static int ev_item_value(struct xante_app *xpp, const char *event_name, va_list
         case XANTE_WIDGET_INPUT_TIME:
         case XANTE_WIDGET_CALENDAR:
         case XANTE_WIDGET_TIMEBOX:
-            value = cl_object_create(CL_STRING, va_arg(ap, char *));
+            value = cl_object_create(CL_STRING, s);
             break;
 
         default:
             break;
     }
 
-    if (function.need_internal_dispatch)
+    stats_event_start(&start);
+
+    if (function.need_internal_dispatch) {
         event_return = gadget_dispatch_call(function.name, xpp, item, value);
-    else {
+        stats_event_record(xpp, event_name, function.name,
+                           STATS_ORIGIN_INTERNAL, &start, (event_return < 0));
+    } else {
         if (function.external_module == false)
             pl = xpp->module.module;
         else {
@@ -311,6 +445,9 @@ static int ev_item_value(struct xante_app *xpp, const char *event_name, va_list
                              XANTE_ARG_VALUE, CL_POINTER, false, value, -1, NULL,
                              NULL);
 
+        stats_event_record(xpp, event_name, function.name,
+                           function_origin(&function), &start, (NULL == ret));
+
         if (strcmp(event_name, EV_ITEM_VALUE_CONFIRM) == 0)
             event_return = CL_OBJECT_AS_INT(ret);
 
@@ -335,6 +472,7 @@ static void *ev_item_custom_data(struct xante_app *xpp,
     struct xante_item *item)
 {
     struct module_function function;
+    struct timespec start;
     cl_object_t *ret = NULL;
     void *data = NULL;
 
@@ -343,9 +481,13 @@ static void *ev_item_custom_data(struct xante_app *xpp,
     if (function.found == false)
         return NULL; /* Should we return an error? */
 
+    stats_event_start(&start);
     ret = cl_plugin_call(xpp->module.module, function.name, CL_POINTER,
                          NULL);
 
+    stats_event_record(xpp, EV_ITEM_CUSTOM_DATA, function.name,
+                       STATS_ORIGIN_MODULE, &start, (NULL == ret));
+
     if (NULL == ret)
         return NULL;
 
@@ -355,15 +497,20 @@ static void *ev_item_custom_data(struct xante_app *xpp,
     return data;
 }
 
-static int ev_changes(struct xante_app *xpp)
+static int ev_changes(struct xante_app *xpp, cl_list_t *changes)
 {
     cl_object_t *ret = NULL;
     int event_return = 0;
+    struct timespec start;
 
+    stats_event_start(&start);
     ret = cl_plugin_call(xpp->module.module, EV_CHANGES_SAVED, CL_INT,
                          XANTE_ARG_XANTE_APP, CL_POINTER, false, xpp, -1, NULL,
                          XANTE_ARG_CHANGES, CL_POINTER, false,
-                         xpp->changes.user_changes, -1, NULL, NULL);
+                         changes, -1, NULL, NULL);
+
+    stats_event_record(xpp, EV_CHANGES_SAVED, EV_CHANGES_SAVED,
+                       STATS_ORIGIN_MODULE, &start, (NULL == ret));
 
     event_return = CL_OBJECT_AS_INT(ret);
     cl_object_unref(ret);
@@ -382,7 +529,7 @@ static int call(const char *event_name, struct xante_app *xpp, va_list ap)
     } else if ((strcmp(event_name, EV_CONFIG_LOAD) == 0) ||
                (strcmp(event_name, EV_CONFIG_UNLOAD) == 0))
     {
-        ev_config(xpp, event_name, ap);
+        ev_config(xpp, event_name, va_arg(ap, void *));
     } else if ((strcmp(event_name, EV_ITEM_SELECTED) == 0) ||
                (strcmp(event_name, EV_ITEM_VALUE_UPDATED) == 0) ||
                (strcmp(event_name, EV_ITEM_EXIT) == 0) ||
@@ -399,11 +546,275 @@ static int call(const char *event_name, struct xante_app *xpp, va_list ap)
     else if (strcmp(event_name, EV_ITEM_VALUE_CONFIRM) == 0)
         ret = ev_item_value(xpp, event_name, ap);
     else if (strcmp(event_name, EV_CHANGES_SAVED) == 0)
-        ret = ev_changes(xpp);
+        ret = ev_changes(xpp, xpp->changes.user_changes);
 
     return ret;
 }
 
+static struct async_event *new_async_event(const char *event_name)
+{
+    struct async_event *ev = NULL;
+
+    ev = calloc(1, sizeof(struct async_event));
+
+    if (NULL == ev) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return NULL;
+    }
+
+    ev->event_name = event_name;
+
+    return ev;
+}
+
+static void destroy_async_event(struct async_event *ev)
+{
+    if (NULL == ev)
+        return;
+
+    if (ev->item != NULL)
+        xante_item_unref(ev->item);
+
+    if (ev->cfg_file != NULL)
+        cl_cfg_unload(ev->cfg_file);
+
+    if (ev->changes != NULL)
+        cl_list_destroy(ev->changes);
+
+    free(ev);
+}
+
+static void run_async_event(struct xante_app *xpp, struct async_event *ev)
+{
+    if (strcmp(ev->event_name, EV_CHANGES_SAVED) == 0)
+        ev_changes(xpp, ev->changes);
+    else if (strcmp(ev->event_name, EV_CONFIG_UNLOAD) == 0)
+        ev_config(xpp, ev->event_name, ev->cfg_file);
+    else {
+        item_function_call(xpp, ev->event_name, &ev->function, ev->item, NULL,
+                           true);
+    }
+}
+
+static bool is_key_running(const struct event_pool *pool, const void *key)
+{
+    int i;
+
+    for (i = 0; i < ASYNC_EVENTS_MAX_RUNNING; i++)
+        if (pool->running[i] == key)
+            return true;
+
+    return false;
+}
+
+static int running_events(const struct event_pool *pool)
+{
+    int i, total = 0;
+
+    for (i = 0; i < ASYNC_EVENTS_MAX_RUNNING; i++)
+        if (pool->running[i] != NULL)
+            total++;
+
+    return total;
+}
+
+/*
+ * Takes the oldest event whose key is not being called by another thread.
+ * It must be called with the pool lock held.
+ */
+static struct async_event *next_async_event(struct event_pool *pool,
+    int *slot)
+{
+    struct async_event *ev = NULL, *prev = NULL;
+    int i;
+
+    for (i = 0; i < ASYNC_EVENTS_MAX_RUNNING; i++)
+        if (NULL == pool->running[i])
+            break;
+
+    if (i == ASYNC_EVENTS_MAX_RUNNING)
+        return NULL;
+
+    for (ev = pool->head; ev != NULL; prev = ev, ev = ev->next)
+        if (is_key_running(pool, ev->key) == false)
+            break;
+
+    if (NULL == ev)
+        return NULL;
+
+    if (prev != NULL)
+        prev->next = ev->next;
+    else
+        pool->head = ev->next;
+
+    if (pool->tail == ev)
+        pool->tail = prev;
+
+    ev->next = NULL;
+    pool->pending--;
+    pool->running[i] = ev->key;
+    *slot = i;
+
+    return ev;
+}
+
+/*
+ * Calls queued events until no more than @limit are left, or until every
+ * one left is from an item being called by another thread. It must be
+ * called with the pool lock held, which is released while each event runs.
+ */
+static void call_pending_events(struct xante_app *xpp, struct event_pool *pool,
+    int limit)
+{
+    struct async_event *ev = NULL;
+    int slot = 0;
+
+    while ((pool->pending > limit) &&
+           ((ev = next_async_event(pool, &slot)) != NULL))
+    {
+        pthread_mutex_unlock(&pool->lock);
+        run_async_event(xpp, ev);
+        destroy_async_event(ev);
+        pthread_mutex_lock(&pool->lock);
+        pool->running[slot] = NULL;
+        pthread_cond_broadcast(&pool->idle);
+    }
+}
+
+static void dispatch_async_events(struct xante_task *task __attribute__((unused)),
+    void *arg)
+{
+    struct xante_app *xpp = (struct xante_app *)arg;
+    struct event_pool *pool = xpp->event_pool;
+
+    pthread_mutex_lock(&pool->lock);
+    call_pending_events(xpp, pool, 0);
+    pool->active_workers--;
+    pthread_cond_broadcast(&pool->idle);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/*
+ * Puts an event to be called in background. If the queue is full, its
+ * workers are not keeping up (or the executor has no free worker to run
+ * them), so the caller calls the oldest ones itself instead of waiting.
+ * Returns -1 if the event must be called synchronously, keeping @ev
+ * ownership with the caller.
+ */
+static int post_async_event(struct xante_app *xpp, struct async_event *ev)
+{
+    struct event_pool *pool = xpp->event_pool;
+    struct xante_task *task = NULL;
+    bool run_inline = false;
+
+    if ((NULL == pool) || (NULL == xpp->executor))
+        return -1;
+
+    pthread_mutex_lock(&pool->lock);
+
+    if (pool->draining == false)
+        call_pending_events(xpp, pool, ASYNC_EVENTS_MAX_PENDING - 1);
+
+    if (pool->draining == true) {
+        pthread_mutex_unlock(&pool->lock);
+        return -1;
+    }
+
+    /* Only events from items stuck inside another thread are left */
+    if (pool->pending >= ASYNC_EVENTS_MAX_PENDING)
+        xante_log_warning(cl_tr("%d asynchronous events are waiting"),
+                          pool->pending + 1);
+
+    if (pool->tail != NULL)
+        pool->tail->next = ev;
+    else
+        pool->head = ev;
+
+    pool->tail = ev;
+    pool->pending++;
+
+    if (pool->active_workers < ASYNC_EVENTS_MAX_WORKERS) {
+        task = executor_submit(xpp, dispatch_async_events, xpp, NULL);
+
+        if (task != NULL) {
+            pool->active_workers++;
+            task_unref(task);
+        } else if (pool->active_workers == 0) {
+            /* Nobody would ever call it, so we do it here */
+            pool->active_workers++;
+            run_inline = true;
+        }
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+
+    if (run_inline)
+        dispatch_async_events(NULL, xpp);
+
+    return 0;
+}
+
+/*
+ * Checks if @event_name was declared to be called asynchronously and, in
+ * this case, posts it.
+ */
+static bool post_event(const char *event_name, struct xante_app *xpp,
+    va_list ap)
+{
+    struct async_event *ev = NULL;
+    struct xante_item *item = NULL;
+
+    if (strcmp(event_name, EV_ITEM_VALUE_UPDATED) == 0) {
+        item = va_arg(ap, void *);
+
+        if ((NULL == item) || (item->behaviour.async_value_updated == false))
+            return false;
+    } else if (strcmp(event_name, EV_CHANGES_SAVED) == 0) {
+        if (xpp->info.async_changes_saved == false)
+            return false;
+    } else
+        return false;
+
+    ev = new_async_event(event_name);
+
+    if (NULL == ev)
+        return false;
+
+    if (item != NULL) {
+        ev->function = get_function_name(item->events, event_name);
+
+        /* There's nothing to call */
+        if (ev->function.found == false) {
+            destroy_async_event(ev);
+            return true;
+        }
+
+        /*
+         * The function may run while the UI changes the item again, so it
+         * receives a copy of it.
+         */
+        ev->item = item_snapshot(item);
+        ev->key = item;
+
+        if (NULL == ev->item)
+            goto error_block;
+    } else {
+        ev->key = xpp->event_pool;
+        ev->changes = change_snapshot(xpp);
+
+        if (NULL == ev->changes)
+            goto error_block;
+    }
+
+    if (post_async_event(xpp, ev) == 0)
+        return true;
+
+error_block:
+    destroy_async_event(ev);
+
+    return false;
+}
+
 /*
  *
  * Internal API
@@ -424,19 +835,106 @@ static int call(const char *event_name, struct xante_app *xpp, va_list ap)
  */
 int event_call(const char *event_name, struct xante_app *xpp, ...)
 {
-    va_list ap;
-    int ret;
+    va_list ap, aq;
+    int ret = 0;
 
     if (xante_runtime_execute_module(xpp) == false)
         return 0;
 
     va_start(ap, NULL);
-    ret = call(event_name, xpp, ap);
+    va_copy(aq, ap);
+
+    /* Events declared as asynchronous don't have a return value */
+    if (post_event(event_name, xpp, aq) == false)
+        ret = call(event_name, xpp, ap);
+
+    va_end(aq);
     va_end(ap);
 
     return ret;
 }
 
+/**
+ * @name event_config_unload
+ * @brief Calls the EV_CONFIG_UNLOAD event and releases the application
+ *        settings.
+ *
+ * When the event is asynchronous, the settings are released only after the
+ * event function returns.
+ *
+ * @param [in,out] xpp: The library main object.
+ */
+void event_config_unload(struct xante_app *xpp)
+{
+    cl_cfg_file_t *cfg_file = xpp->config.cfg_file;
+    struct async_event *ev = NULL;
+
+    xpp->config.cfg_file = NULL;
+
+    if (xante_runtime_execute_module(xpp) == true) {
+        if (xpp->info.async_config_unload == true) {
+            ev = new_async_event(EV_CONFIG_UNLOAD);
+
+            if (ev != NULL) {
+                ev->key = xpp->event_pool;
+                ev->cfg_file = cfg_file;
+
+                if (post_async_event(xpp, ev) == 0)
+                    return;
+
+                ev->cfg_file = NULL;
+                destroy_async_event(ev);
+            }
+        }
+
+        ev_config(xpp, EV_CONFIG_UNLOAD, cfg_file);
+    }
+
+    if (cfg_file != NULL)
+        cl_cfg_unload(cfg_file);
+}
+
+/**
+ * @name event_drain
+ * @brief Calls every asynchronous event still waiting.
+ *
+ * Events not taken by a worker are called here, so nothing depends on a
+ * free executor worker. We only wait for ASYNC_EVENTS_DRAIN_TIMEOUT for
+ * the ones stuck inside a module function. After it, new events are called
+ * synchronously. This must be called before the executor is finished.
+ *
+ * @param [in,out] xpp: The library main object.
+ */
+void event_drain(struct xante_app *xpp)
+{
+    struct event_pool *pool = xpp->event_pool;
+    struct timespec ts;
+    int ret = 0;
+
+    if (NULL == pool)
+        return;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += ASYNC_EVENTS_DRAIN_TIMEOUT / 1000;
+    pthread_mutex_lock(&pool->lock);
+    pool->draining = true;
+
+    while (ret == 0) {
+        call_pending_events(xpp, pool, 0);
+
+        if ((pool->pending == 0) && (running_events(pool) == 0))
+            break;
+
+        ret = pthread_cond_timedwait(&pool->idle, &pool->lock, &ts);
+    }
+
+    if ((pool->pending > 0) || (running_events(pool) > 0))
+        xante_log_warning(cl_tr("%d asynchronous events were left behind"),
+                          pool->pending + running_events(pool));
+
+    pthread_mutex_unlock(&pool->lock);
+}
+
 /**
  * @name event_init
  * @brief Initialize the application module.
@@ -451,7 +949,19 @@ int event_call(const char *event_name, struct xante_app *xpp, ...)
  */
 int event_init(struct xante_app *xpp, bool use_module)
 {
+    struct event_pool *pool = NULL;
+
     gadget_dispatch_init();
+    pool = calloc(1, sizeof(struct event_pool));
+
+    if (NULL == pool) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return -1;
+    }
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->idle, NULL);
+    xpp->event_pool = pool;
 
     if (use_module == false) {
         runtime_set_execute_module(xpp, false);
@@ -475,11 +985,18 @@ int event_init(struct xante_app *xpp, bool use_module)
         return -1;
     }
 
+    /* Widgets registered from here belong to the module */
+    session_widgets_owner(xpp->module.module);
+
     if (event_call(EV_INIT, xpp, NULL) < 0) {
+        session_widgets_owner(NULL);
+        session_unregister_widgets(xpp->module.module);
         errno_set(XANTE_ERROR_PLUGIN_INIT_ERROR);
         return -1;
     }
 
+    session_widgets_owner(NULL);
+
     return 0;
 }
 
@@ -493,17 +1010,58 @@ int event_init(struct xante_app *xpp, bool use_module)
  */
 void event_uninit(struct xante_app *xpp)
 {
+    struct async_event *ev = NULL;
+
     if (NULL == xpp)
         return;
 
+    /* Whatever is left is called before the module is gone */
+    event_drain(xpp);
+
     if (xpp->module.module != NULL) {
         event_call(EV_UNINIT, xpp, NULL);
         cl_plugin_info_unref(xpp->module.info);
         cl_stringlist_destroy(xpp->module.functions);
-        cl_plugin_unload(xpp->module.module);
+
+        /* Its widgets would point into unmapped code */
+        session_unregister_widgets(xpp->module.module);
+
+        if (xpp->module.in_use == false)
+            cl_plugin_unload(xpp->module.module);
     }
 
     gadget_dispatch_uninit();
+
+    if (xpp->event_pool != NULL) {
+        /* Events which could never be called */
+        while (xpp->event_pool->head != NULL) {
+            ev = xpp->event_pool->head;
+            xpp->event_pool->head = ev->next;
+            destroy_async_event(ev);
+        }
+
+        pthread_cond_destroy(&xpp->event_pool->idle);
+        pthread_mutex_destroy(&xpp->event_pool->lock);
+        free(xpp->event_pool);
+        xpp->event_pool = NULL;
+    }
+}
+
+/**
+ * @name event_item_has
+ * @brief Checks if an item has declared a specific event inside the JTF.
+ *
+ * @param [in] item: The item.
+ * @param [in] event_name: The event name.
+ *
+ * @return Returns true if the event was declared or false otherwise.
+ */
+bool event_item_has(const struct xante_item *item, const char *event_name)
+{
+    if ((NULL == item) || (NULL == item->events))
+        return false;
+
+    return (cl_json_get_object_item(item->events, event_name) != NULL);
 }
 
 /**
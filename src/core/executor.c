@@ -0,0 +1,743 @@
+
+/*
+ * Description: A pool of worker threads to run background tasks, such as the
+ *              module routines called by the sync and progress widgets.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 11:02:18 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <pthread.h>
+#include <time.h>
+
+#include "libxante.h"
+
+/* Maximum number of worker threads of an application */
+#define EXECUTOR_MAX_WORKERS            4
+
+/*
+ * Maximum number of workers left behind running blocked tasks. Each one of
+ * them is replaced by a new worker, so the pool keeps running other tasks.
+ */
+#define EXECUTOR_MAX_BLOCKED_WORKERS    12
+
+/* Seconds to wait for every worker to finish while closing the application */
+#define EXECUTOR_JOIN_TIMEOUT           5
+
+struct xante_task {
+    void                (*run)(struct xante_task *, void *);
+    void                *data;
+    void                (*free_data)(void *);
+    bool                cancelled;
+    bool                finished;
+    pthread_mutex_t     lock;
+    pthread_cond_t      cond;
+    struct xante_task   *next;
+    struct cl_ref_s     ref;
+
+    /* Protected by the executor lock */
+    struct xante_executor   *executor;
+    bool                    started;
+    bool                    abandoned;
+};
+
+struct xante_executor;
+
+struct xante_worker {
+    pthread_t               thread;
+    struct xante_task       *task;      /* The task being run */
+    struct xante_executor   *executor;
+};
+
+struct xante_executor {
+    pthread_mutex_t     lock;
+    pthread_cond_t      wakeup;
+    struct xante_worker workers[EXECUTOR_MAX_WORKERS +
+                                EXECUTOR_MAX_BLOCKED_WORKERS];
+
+    int                 total_workers;
+    int                 idle_workers;
+    int                 blocked_workers;
+    bool                shutdown;
+    struct xante_task   *head;
+    struct xante_task   *tail;
+};
+
+/*
+ *
+ * Internal functions
+ *
+ */
+
+static void destroy_task(const struct cl_ref_s *ref)
+{
+    struct xante_task *task = cl_container_of(ref, struct xante_task, ref);
+
+    if (NULL == task)
+        return;
+
+    if (task->free_data != NULL)
+        (task->free_data)(task->data);
+
+    pthread_cond_destroy(&task->cond);
+    pthread_mutex_destroy(&task->lock);
+    free(task);
+}
+
+static struct xante_task *new_task(struct xante_executor *executor,
+    void (*run)(struct xante_task *, void *), void *data,
+    void (*free_data)(void *))
+{
+    struct xante_task *task = NULL;
+
+    task = calloc(1, sizeof(struct xante_task));
+
+    if (NULL == task) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return NULL;
+    }
+
+    task->executor = executor;
+    task->run = run;
+    task->data = data;
+    task->free_data = free_data;
+    pthread_mutex_init(&task->lock, NULL);
+    pthread_cond_init(&task->cond, NULL);
+
+    /* One reference to the caller and another one to the worker */
+    task->ref.count = 2;
+    task->ref.free = destroy_task;
+
+    return task;
+}
+
+static void request_cancel(struct xante_task *task)
+{
+    pthread_mutex_lock(&task->lock);
+    task->cancelled = true;
+    pthread_cond_broadcast(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+}
+
+static void finish_task(struct xante_task *task)
+{
+    pthread_mutex_lock(&task->lock);
+    task->finished = true;
+    pthread_cond_broadcast(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+    task_unref(task);
+}
+
+/*
+ * Converts a relative @timeout, in milliseconds, into an absolute time to be
+ * used with pthread_cond_timedwait.
+ */
+static void deadline(struct timespec *ts, int timeout)
+{
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_sec += timeout / 1000;
+    ts->tv_nsec += (timeout % 1000) * 1000000L;
+
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+static void *worker(void *arg)
+{
+    struct xante_worker *w = (struct xante_worker *)arg;
+    struct xante_executor *executor = w->executor;
+    struct xante_task *task = NULL;
+
+    for (;;) {
+        pthread_mutex_lock(&executor->lock);
+        executor->idle_workers++;
+
+        while ((executor->shutdown == false) && (NULL == executor->head))
+            pthread_cond_wait(&executor->wakeup, &executor->lock);
+
+        executor->idle_workers--;
+        task = executor->head;
+
+        if (NULL == task) {
+            /* We're closing and there is nothing left to do */
+            pthread_mutex_unlock(&executor->lock);
+            break;
+        }
+
+        executor->head = task->next;
+
+        if (NULL == executor->head)
+            executor->tail = NULL;
+
+        task->started = true;
+        w->task = task;
+        pthread_mutex_unlock(&executor->lock);
+
+        /* A cancelled task is only finished, so its waiters are released */
+        if (task_cancelled(task) == false)
+            (task->run)(task, task->data);
+
+        pthread_mutex_lock(&executor->lock);
+        w->task = NULL;
+
+        /* We were replaced, but we may go back to the pool now */
+        if (task->abandoned == true)
+            executor->blocked_workers--;
+
+        pthread_mutex_unlock(&executor->lock);
+        finish_task(task);
+    }
+
+    return NULL;
+}
+
+/*
+ * Starts a new worker when there is none idle and the pool is not full yet.
+ * Workers running blocked tasks don't count. Must be called with the
+ * executor lock held.
+ *
+ * Returns false if there is no worker at all to run a task.
+ */
+static bool start_worker(struct xante_executor *executor)
+{
+    struct xante_worker *w;
+    int max_workers = sizeof(executor->workers) / sizeof(executor->workers[0]);
+
+    if ((executor->idle_workers > 0) ||
+        (executor->total_workers - executor->blocked_workers >=
+                                                EXECUTOR_MAX_WORKERS) ||
+        (executor->total_workers == max_workers))
+    {
+        return true;
+    }
+
+    w = &executor->workers[executor->total_workers];
+    w->executor = executor;
+
+    if (pthread_create(&w->thread, NULL, worker, w) == 0)
+        executor->total_workers++;
+
+    return (executor->total_workers > 0);
+}
+
+/* Removes a task still waiting to run from the queue. */
+static bool unqueue_task(struct xante_executor *executor,
+    struct xante_task *task)
+{
+    struct xante_task *t = NULL, *prev = NULL;
+
+    for (t = executor->head; t != NULL; prev = t, t = t->next) {
+        if (t != task)
+            continue;
+
+        if (NULL == prev)
+            executor->head = t->next;
+        else
+            prev->next = t->next;
+
+        if (executor->tail == t)
+            executor->tail = prev;
+
+        t->next = NULL;
+
+        return true;
+    }
+
+    return false;
+}
+
+/*
+ * Joins a worker until the shared deadline @ts. A worker still running is
+ * detached, since its task may be inside module code that can't be safely
+ * interrupted.
+ *
+ * Returns true if the worker was joined or false if it was left behind.
+ */
+static bool join_worker(pthread_t thread, const struct timespec *ts)
+{
+    if (pthread_timedjoin_np(thread, NULL, ts) == 0)
+        return true;
+
+    pthread_detach(thread);
+
+    return false;
+}
+
+/*
+ *
+ * Internal API
+ *
+ */
+
+/**
+ * @name executor_init
+ * @brief Initializes the application task executor.
+ *
+ * No thread is created here. Workers are only started when tasks are
+ * submitted and there is no idle one to run them.
+ *
+ * @param [in,out] xpp: The library main object.
+ *
+ * @return On success returns 0 or -1 otherwise.
+ */
+int executor_init(struct xante_app *xpp)
+{
+    struct xante_executor *executor = NULL;
+
+    executor = calloc(1, sizeof(struct xante_executor));
+
+    if (NULL == executor) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return -1;
+    }
+
+    pthread_mutex_init(&executor->lock, NULL);
+    pthread_cond_init(&executor->wakeup, NULL);
+    xpp->executor = executor;
+
+    return 0;
+}
+
+/**
+ * @name executor_uninit
+ * @brief Finishes the application task executor.
+ *
+ * Every task still waiting to run is cancelled and every worker is joined,
+ * all of them sharing a single deadline. Workers still running after it are
+ * left behind, along with the executor itself, since they'll use it when
+ * their tasks return. This must be called before unloading the module,
+ * since its functions may still be running.
+ *
+ * @param [in,out] xpp: The library main object.
+ *
+ * @return Returns the number of workers left behind.
+ */
+int executor_uninit(struct xante_app *xpp)
+{
+    struct xante_executor *executor = xpp->executor;
+    struct xante_task *task;
+    struct timespec ts;
+    int i, left_behind = 0;
+
+    if (NULL == executor)
+        return 0;
+
+    pthread_mutex_lock(&executor->lock);
+    executor->shutdown = true;
+
+    for (task = executor->head; task != NULL; task = task->next)
+        request_cancel(task);
+
+    for (i = 0; i < executor->total_workers; i++)
+        if (executor->workers[i].task != NULL)
+            request_cancel(executor->workers[i].task);
+
+    pthread_cond_broadcast(&executor->wakeup);
+    pthread_mutex_unlock(&executor->lock);
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += EXECUTOR_JOIN_TIMEOUT;
+
+    for (i = 0; i < executor->total_workers; i++)
+        if (join_worker(executor->workers[i].thread, &ts) == false)
+            left_behind++;
+
+    /* Tasks nobody was left to run are only finished */
+    for (;;) {
+        pthread_mutex_lock(&executor->lock);
+        task = executor->head;
+
+        if (task != NULL)
+            executor->head = task->next;
+
+        pthread_mutex_unlock(&executor->lock);
+
+        if (NULL == task)
+            break;
+
+        finish_task(task);
+    }
+
+    xpp->executor = NULL;
+
+    if (left_behind > 0) {
+        xante_log_warning(cl_tr("%d background task(s) still running after "
+                                "%d seconds. They were left behind."),
+                          left_behind, EXECUTOR_JOIN_TIMEOUT);
+
+        return left_behind;
+    }
+
+    pthread_cond_destroy(&executor->wakeup);
+    pthread_mutex_destroy(&executor->lock);
+    free(executor);
+
+    return 0;
+}
+
+/**
+ * @name executor_submit
+ * @brief Puts a new task to run in background.
+ *
+ * The @run function receives the task itself so it can check, from time to
+ * time, if it was cancelled. When the task is released @free_data is called
+ * with @data, if it's not NULL.
+ *
+ * @param [in,out] xpp: The library main object.
+ * @param [in] run: The task function.
+ * @param [in] data: The task function argument.
+ * @param [in] free_data: The function to release @data.
+ *
+ * @return On success returns a task object, which must be released with
+ *         task_unref, or NULL otherwise.
+ */
+struct xante_task *executor_submit(struct xante_app *xpp,
+    void (*run)(struct xante_task *, void *), void *data,
+    void (*free_data)(void *))
+{
+    struct xante_executor *executor = xpp->executor;
+    struct xante_task *task = NULL;
+
+    if ((NULL == executor) || (NULL == run)) {
+        errno_set(XANTE_ERROR_NULL_ARG);
+        return NULL;
+    }
+
+    task = new_task(executor, run, data, free_data);
+
+    if (NULL == task)
+        return NULL;
+
+    pthread_mutex_lock(&executor->lock);
+
+    if (executor->shutdown == true)
+        goto error_block;
+
+    /* Only starts a new worker when all of them are busy */
+    if (start_worker(executor) == false)
+        goto error_block; /* Nobody would ever run it */
+
+    if (executor->tail != NULL)
+        executor->tail->next = task;
+    else
+        executor->head = task;
+
+    executor->tail = task;
+    pthread_cond_signal(&executor->wakeup);
+    pthread_mutex_unlock(&executor->lock);
+
+    return task;
+
+error_block:
+    pthread_mutex_unlock(&executor->lock);
+
+    /* The caller keeps the ownership of @data */
+    task->free_data = NULL;
+    destroy_task(&task->ref);
+    errno_set(XANTE_ERROR_INVALID_ARG);
+
+    return NULL;
+}
+
+/**
+ * @name task_cancel
+ * @brief Requests a task to stop.
+ *
+ * A task still waiting to run is removed from the queue and finished right
+ * away. Otherwise the cancellation is cooperative, the task must check it
+ * with task_cancelled or task_sleep.
+ *
+ * @param [in,out] task: The task.
+ */
+void task_cancel(struct xante_task *task)
+{
+    struct xante_executor *executor = NULL;
+    bool queued = false;
+
+    if (NULL == task)
+        return;
+
+    executor = task->executor;
+    pthread_mutex_lock(&executor->lock);
+
+    if (task->started == false)
+        queued = unqueue_task(executor, task);
+
+    pthread_mutex_unlock(&executor->lock);
+    request_cancel(task);
+
+    if (queued == true)
+        finish_task(task);
+}
+
+/**
+ * @name task_abandon
+ * @brief Leaves a running task behind.
+ *
+ * The task is cancelled and its worker is not accounted anymore, so another
+ * one may be started to run the remaining tasks. It's meant to tasks
+ * blocked inside a module function, which will only be joined when the
+ * application finishes, if they return by then.
+ *
+ * @param [in,out] task: The task.
+ */
+void task_abandon(struct xante_task *task)
+{
+    struct xante_executor *executor = NULL;
+    int i;
+
+    if (NULL == task)
+        return;
+
+    task_cancel(task);
+    executor = task->executor;
+    pthread_mutex_lock(&executor->lock);
+
+    for (i = 0; i < executor->total_workers; i++) {
+        if ((executor->workers[i].task != task) || (task->abandoned == true))
+            continue;
+
+        task->abandoned = true;
+        executor->blocked_workers++;
+        xante_log_info(cl_tr("A background task seems to be blocked. It will "
+                             "be left behind."));
+
+        /* Someone must run whatever is waiting */
+        if (executor->head != NULL)
+            start_worker(executor);
+
+        break;
+    }
+
+    pthread_mutex_unlock(&executor->lock);
+}
+
+/**
+ * @name task_stop
+ * @brief Cancels a task and waits, for a limited time, for it to finish.
+ *
+ * A task not finished in time is abandoned.
+ *
+ * @param [in,out] task: The task.
+ * @param [in] timeout: The maximum time to wait, in milliseconds.
+ *
+ * @return Returns 0 if the task has finished or -1 if it was abandoned.
+ */
+int task_stop(struct xante_task *task, int timeout)
+{
+    if (NULL == task)
+        return 0;
+
+    task_cancel(task);
+
+    if (task_wait(task, timeout) == 0)
+        return 0;
+
+    task_abandon(task);
+
+    return -1;
+}
+
+/**
+ * @name task_started
+ * @brief Checks if a task has already left the queue to run.
+ *
+ * @param [in] task: The task.
+ *
+ * @return Returns true if the task was started or false otherwise.
+ */
+bool task_started(struct xante_task *task)
+{
+    struct xante_executor *executor = task->executor;
+    bool started;
+
+    pthread_mutex_lock(&executor->lock);
+    started = task->started;
+    pthread_mutex_unlock(&executor->lock);
+
+    return started;
+}
+
+/**
+ * @name task_runnable
+ * @brief Checks if a task may still be run by the executor.
+ *
+ * A queued task can never run once the application is closing or when every
+ * worker is left behind with a blocked task and no other may be started.
+ *
+ * @param [in] task: The task.
+ *
+ * @return Returns true if the task has started or may start later, or false
+ *         otherwise.
+ */
+bool task_runnable(struct xante_task *task)
+{
+    struct xante_executor *executor = task->executor;
+    bool runnable = true;
+
+    pthread_mutex_lock(&executor->lock);
+
+    if (task->started == false) {
+        if (executor->shutdown == true)
+            runnable = false;
+        else if (executor->total_workers - executor->blocked_workers <= 0) {
+            start_worker(executor);
+            runnable = (executor->total_workers -
+                        executor->blocked_workers > 0);
+        }
+    }
+
+    pthread_mutex_unlock(&executor->lock);
+
+    return runnable;
+}
+
+/**
+ * @name task_cancelled
+ * @brief Checks if a task was requested to stop.
+ *
+ * @param [in] task: The task.
+ *
+ * @return Returns true if the task was cancelled or false otherwise.
+ */
+bool task_cancelled(struct xante_task *task)
+{
+    bool cancelled;
+
+    pthread_mutex_lock(&task->lock);
+    cancelled = task->cancelled;
+    pthread_mutex_unlock(&task->lock);
+
+    return cancelled;
+}
+
+/**
+ * @name task_set_flag
+ * @brief Sets a flag shared with other threads, unless the task was
+ *        cancelled.
+ *
+ * The check and the store happen holding the task lock, the same one taken
+ * to cancel it, so a task cancelled by another thread never sets the flag
+ * afterwards.
+ *
+ * @param [in] task: The task.
+ * @param [out] flag: The flag.
+ *
+ * @return Returns true if the flag was set or false otherwise.
+ */
+bool task_set_flag(struct xante_task *task, bool *flag)
+{
+    bool set = false;
+
+    pthread_mutex_lock(&task->lock);
+
+    if (task->cancelled == false) {
+        __atomic_store_n(flag, true, __ATOMIC_RELEASE);
+        set = true;
+    }
+
+    pthread_mutex_unlock(&task->lock);
+
+    return set;
+}
+
+/**
+ * @name task_sleep
+ * @brief Puts a task to sleep, being awakened if it's cancelled.
+ *
+ * This function must be called from inside the task function.
+ *
+ * @param [in] task: The task.
+ * @param [in] timeout: The time to sleep, in milliseconds.
+ *
+ * @return Returns true if the task was cancelled or false otherwise.
+ */
+bool task_sleep(struct xante_task *task, int timeout)
+{
+    struct timespec ts;
+    bool cancelled;
+    int ret = 0;
+
+    deadline(&ts, timeout);
+    pthread_mutex_lock(&task->lock);
+
+    while ((task->cancelled == false) && (ret == 0))
+        ret = pthread_cond_timedwait(&task->cond, &task->lock, &ts);
+
+    cancelled = task->cancelled;
+    pthread_mutex_unlock(&task->lock);
+
+    return cancelled;
+}
+
+/**
+ * @name task_wait
+ * @brief Waits for a task to finish.
+ *
+ * @param [in] task: The task.
+ * @param [in] timeout: The maximum time to wait, in milliseconds, or -1 to
+ *                      wait until it finishes. Only a task which is known
+ *                      to be finishing should be waited without a limit.
+ *
+ * @return Returns 0 if the task has finished or -1 if the timeout expired.
+ */
+int task_wait(struct xante_task *task, int timeout)
+{
+    struct timespec ts;
+    bool finished;
+    int ret = 0;
+
+    if (timeout >= 0)
+        deadline(&ts, timeout);
+
+    pthread_mutex_lock(&task->lock);
+
+    while ((task->finished == false) && (ret == 0)) {
+        if (timeout < 0)
+            ret = pthread_cond_wait(&task->cond, &task->lock);
+        else
+            ret = pthread_cond_timedwait(&task->cond, &task->lock, &ts);
+    }
+
+    finished = task->finished;
+    pthread_mutex_unlock(&task->lock);
+
+    return (finished == true) ? 0 : -1;
+}
+
+/**
+ * @name task_unref
+ * @brief Releases a task object.
+ *
+ * A task still running is only released after it finishes.
+ *
+ * @param [in,out] task: The task.
+ */
+void task_unref(struct xante_task *task)
+{
+    if (NULL == task)
+        return;
+
+    cl_ref_dec(&task->ref);
+}
+
@@ -57,7 +57,17 @@ static void destroy_xante_app(const struct cl_ref_s *ref)
     if (NULL == xpp)
         return;
 
+    /*
+     * Background tasks may still be running module functions. If some of
+     * them never return, the module can't be unloaded under them.
+     */
+    event_drain(xpp);
+
+    if (executor_uninit(xpp) > 0)
+        xpp->module.in_use = true;
+    jts_cache_uninit(xpp);
     event_uninit(xpp);
+    stats_uninit(xpp);
     xante_log_info(cl_tr("Finishing application"));
     change_uninit(xpp);
     ui_data_uninit(xpp);
@@ -100,6 +110,34 @@ static void post_init(struct xante_app *xpp)
         cl_trap(SIGINT, NULL);
 }
 
+/*
+ * Writes the startup phases as a trace file if it was requested, by the
+ * XANTE_TRACE_STARTUP flag or by the environment.
+ */
+static void export_startup_trace(struct xante_app *xpp,
+    enum xante_init_flags flags)
+{
+    char *pathname = NULL;
+
+    pathname = xante_env_trace_path();
+
+    if ((NULL == pathname) && bit_test(flags, XANTE_TRACE_STARTUP) &&
+        (xpp->info.log_pathname != NULL))
+    {
+        asprintf(&pathname, "%s/%s-startup.json", xpp->info.log_pathname,
+                 xpp->info.application_name);
+    }
+
+    if (NULL == pathname)
+        return;
+
+    if (stats_trace_export(xpp, pathname) < 0)
+        xante_log_warning(cl_tr("Unable to write the startup trace to '%s'"),
+                          pathname);
+
+    free(pathname);
+}
+
 /*
  *
  * API
@@ -124,58 +162,114 @@ __PUB_API__ xante_t *xante_init(const char *caller_name, const char *jtf_pathnam
     if (NULL == xpp)
         return NULL;
 
+    /* Account the startup phases and every event function called */
+    if (stats_init(xpp) < 0)
+        goto error_block;
+
+    stats_phase_begin(xpp, "xante_init");
+
     /*
      * The JTF parsing must be divided and the first part is done here since we
      * need to have some relevant information to keep going through this
      * function and initialize/check everything else.
      */
+    stats_phase_begin(xpp, "jtf_parse_application_info");
+
     if (jtf_parse_application_info(jtf_pathname, xpp) < 0)
         goto error_block;
 
+    stats_phase_end(xpp);
+
     /* Initialize libcollections from here */
+    stats_phase_begin(xpp, "libcollections_init");
     libcollections_init(xpp);
+    stats_phase_end(xpp);
 
     /* Start log file */
+    stats_phase_begin(xpp, "log_init");
     log_init(xpp);
+    stats_phase_end(xpp);
 
     /* Set runtime flags */
     runtime_start(xpp, caller_name);
 
     /* We check if we can run */
+    stats_phase_begin(xpp, "instance_init");
+
     if (instance_init(xpp, bit_test(flags, XANTE_SINGLE_INSTANCE)) < 0)
         goto error_block;
 
+    stats_phase_end(xpp);
+
     /* Start translation environment */
 
     /* Start user access control */
+    stats_phase_begin(xpp, "auth_init");
+
     if (auth_init(xpp, bit_test(flags, XANTE_USE_AUTH), session, username,
                   password) < 0)
     {
         goto error_block;
     }
 
+    stats_phase_end(xpp);
+
     /* Parse the rest of the JTF file */
+    stats_phase_begin(xpp, "jtf_parse_application");
+
     if (jtf_parse_application(jtf_pathname, xpp) < 0)
         goto error_block;
 
+    stats_phase_end(xpp);
+
     /* Starts application authentication */
+    stats_phase_begin(xpp, "auth_application_init");
+
     if (auth_application_init(xpp) < 0)
         goto error_block;
 
+    stats_phase_end(xpp);
+
     /* Start user modifications monitoring */
+    stats_phase_begin(xpp, "change_init");
     change_init(xpp);
+    stats_phase_end(xpp);
+
+    /* Prepare the background tasks executor */
+    stats_phase_begin(xpp, "executor_init");
+
+    if (executor_init(xpp) < 0)
+        goto error_block;
+
+    stats_phase_end(xpp);
+
+    /* Keep parsed JTS to be reused by xante_manager_single_run */
+    stats_phase_begin(xpp, "jts_cache_init");
+
+    if (jts_cache_init(xpp) < 0)
+        goto error_block;
+
+    stats_phase_end(xpp);
 
     /* Call the module initialization function or disable its using */
+    stats_phase_begin(xpp, "event_init");
+
     if (event_init(xpp, bit_test(flags, XANTE_USE_MODULE)) < 0)
         goto error_block;
 
+    stats_phase_end(xpp);
     post_init(xpp);
+    stats_phase_end(xpp);
+    export_startup_trace(xpp, flags);
     xante_log_info(cl_tr("Initializing application - %s"),
                    xpp->info.application_name);
 
     return xpp;
 
 error_block:
+    /* A failed startup is also worth looking at */
+    export_startup_trace(xpp, flags);
+
     return NULL;
 }
 
@@ -0,0 +1,260 @@
+
+/*
+ * Description: A table of unique strings, shared by every object needing
+ *              them.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 17:03:27 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include "libxante.h"
+
+/* The minimum number of slots of the table */
+#define INTERN_MIN_SLOTS                256
+
+/*
+ * Strings loaded from a JTF (item types, configuration blocks, labels) are
+ * repeated a lot. Every one of them is kept only once, inside an open
+ * addressing hash table holding a reference to it, so objects sharing a
+ * string share the same cl_string_t.
+ */
+struct intern_table {
+    cl_string_t     **slots;
+    unsigned int    mask;
+    int             total;
+    unsigned int    lookups;
+    unsigned int    hits;
+    size_t          saved_bytes;
+};
+
+/*
+ *
+ * Internal functions
+ *
+ */
+
+static unsigned int hash_string(const cl_string_t *s)
+{
+    const char *p = cl_string_valueof(s);
+    unsigned int h = 2166136261u;
+    int i, length = cl_string_length(s);
+
+    /* FNV-1a */
+    for (i = 0; i < length; i++) {
+        h ^= (unsigned char)p[i];
+        h *= 16777619u;
+    }
+
+    return h;
+}
+
+static bool string_equals(const cl_string_t *a, const cl_string_t *b)
+{
+    return (cl_string_length(a) == cl_string_length(b)) &&
+           (memcmp(cl_string_valueof(a), cl_string_valueof(b),
+                   cl_string_length(a)) == 0);
+}
+
+static int grow(struct intern_table *table)
+{
+    cl_string_t **slots = NULL;
+    unsigned int size = (table->mask + 1) << 1, i, j;
+
+    slots = calloc(size, sizeof(cl_string_t *));
+
+    if (NULL == slots) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return -1;
+    }
+
+    for (i = 0; i <= table->mask; i++) {
+        if (NULL == table->slots[i])
+            continue;
+
+        j = hash_string(table->slots[i]) & (size - 1);
+
+        while (slots[j] != NULL)
+            j = (j + 1) & (size - 1);
+
+        slots[j] = table->slots[i];
+    }
+
+    free(table->slots);
+    table->slots = slots;
+    table->mask = size - 1;
+
+    return 0;
+}
+
+/*
+ *
+ * Internal API
+ *
+ */
+
+/**
+ * @name intern_create
+ * @brief Creates an empty table of strings.
+ *
+ * @return On success returns the new table or NULL otherwise.
+ */
+struct intern_table *intern_create(void)
+{
+    struct intern_table *table = NULL;
+
+    table = calloc(1, sizeof(struct intern_table));
+
+    if (NULL == table) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return NULL;
+    }
+
+    table->slots = calloc(INTERN_MIN_SLOTS, sizeof(cl_string_t *));
+
+    if (NULL == table->slots) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        free(table);
+        return NULL;
+    }
+
+    table->mask = INTERN_MIN_SLOTS - 1;
+
+    return table;
+}
+
+/**
+ * @name intern_destroy
+ * @brief Releases a table of strings.
+ *
+ * Strings still used by some object are only released with it.
+ *
+ * @param [in,out] table: The table.
+ */
+void intern_destroy(struct intern_table *table)
+{
+    unsigned int i;
+
+    if (NULL == table)
+        return;
+
+    for (i = 0; i <= table->mask; i++)
+        if (table->slots[i] != NULL)
+            cl_string_unref(table->slots[i]);
+
+    free(table->slots);
+    free(table);
+}
+
+/**
+ * @name intern_string
+ * @brief Gives the unique copy of a string.
+ *
+ * The function takes the caller reference of \a s. If the same content was
+ * already inside the table \a s is released and the existing string is
+ * returned instead. Interned strings must never be modified.
+ *
+ * @param [in,out] table: The table. If NULL \a s is returned untouched.
+ * @param [in] s: The string.
+ *
+ * @return Returns a reference to the unique string, which must be released
+ *         by the caller.
+ */
+cl_string_t *intern_string(struct intern_table *table, cl_string_t *s)
+{
+    unsigned int i;
+
+    if ((NULL == table) || (NULL == s))
+        return s;
+
+    table->lookups++;
+    i = hash_string(s) & table->mask;
+
+    while (table->slots[i] != NULL) {
+        if (table->slots[i] == s)
+            return s;
+
+        if (string_equals(table->slots[i], s)) {
+            table->hits++;
+            table->saved_bytes += cl_string_length(s) + 1;
+            cl_string_unref(s);
+
+            return cl_string_ref(table->slots[i]);
+        }
+
+        i = (i + 1) & table->mask;
+    }
+
+    /* Keeps the table, at most, half full */
+    if ((unsigned int)(2 * (table->total + 1)) > table->mask + 1) {
+        if (grow(table) < 0)
+            return s;
+
+        i = hash_string(s) & table->mask;
+
+        while (table->slots[i] != NULL)
+            i = (i + 1) & table->mask;
+    }
+
+    table->slots[i] = cl_string_ref(s);
+    table->total++;
+
+    return s;
+}
+
+/**
+ * @name intern_equals
+ * @brief Compares two strings which may have been interned.
+ *
+ * @param [in] a: A string.
+ * @param [in] b: Another string.
+ *
+ * @return Returns true if both strings exist and have the same content or
+ *         false otherwise.
+ */
+bool intern_equals(const cl_string_t *a, const cl_string_t *b)
+{
+    if ((NULL == a) || (NULL == b))
+        return false;
+
+    if (a == b)
+        return true;
+
+    return string_equals(a, b);
+}
+
+/**
+ * @name intern_info
+ * @brief Gets how the table has been used.
+ *
+ * @param [in] table: The table.
+ * @param [out] total: The number of unique strings.
+ * @param [out] lookups: The number of strings looked up.
+ * @param [out] saved_bytes: The number of bytes of duplicated strings which
+ *                           were released.
+ */
+void intern_info(const struct intern_table *table, int *total,
+    unsigned int *lookups, size_t *saved_bytes)
+{
+    *total = (table != NULL) ? table->total : 0;
+    *lookups = (table != NULL) ? table->lookups : 0;
+    *saved_bytes = (table != NULL) ? table->saved_bytes : 0;
+}
+
@@ -25,6 +25,11 @@
  * USA
  */
 
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+
 #include "libxante.h"
 
 /*
@@ -40,6 +45,12 @@ struct search_data {
     int     (*compare)(cl_list_node_t *, void *);
 };
 
+/*
+ * Guards every item value replacement and display text, since values may be
+ * changed by asynchronous module events while a menu is being built.
+ */
+static pthread_mutex_t __display_lock = PTHREAD_MUTEX_INITIALIZER;
+
 /*
  *
  * Internal functions
@@ -85,6 +96,9 @@ static void __destroy_xante_item(const struct cl_ref_s *ref)
     if (item->value != NULL)
         cl_object_unref(item->value);
 
+    if (item->display_value != NULL)
+        free(item->display_value);
+
     if (item->default_value != NULL)
         cl_object_unref(item->default_value);
 
@@ -94,44 +108,67 @@ static void __destroy_xante_item(const struct cl_ref_s *ref)
     if (item->max != NULL)
         cl_object_unref(item->max);
 
-    /* spec */
-    if (item->value_spec != NULL)
-        cl_spec_destroy(item->value_spec);
-
     /* json */
     if (item->events != NULL)
         cl_json_delete(item->events);
 
-    if (item->form_options != NULL)
-        cl_json_delete(item->form_options);
+    if (item->details->form_options != NULL)
+        cl_json_delete(item->details->form_options);
 
     /* stringlist */
-    if (item->list_items != NULL)
+    if ((item->list_items != NULL) &&
+        ((NULL == item->template) ||
+         (item->list_items != item->template->list_items)))
+    {
         cl_stringlist_destroy(item->list_items);
+    }
+
+    if (item->details->checklist_brief_options != NULL)
+        cl_stringlist_destroy(item->details->checklist_brief_options);
+
+    /* options */
+    if (item->options_index != NULL)
+        option_index_unref(item->options_index);
 
-    if (item->checklist_brief_options != NULL)
-        cl_stringlist_destroy(item->checklist_brief_options);
+    if (item->selected_options != NULL)
+        option_set_destroy(item->selected_options);
 
-    if (item->selected_items != NULL)
-        cl_stringlist_destroy(item->selected_items);
+    /* list */
+    if (item->details->tasks != NULL)
+        cl_list_destroy(item->details->tasks);
 
     /* labels */
-    if (item->label.ok != NULL)
-        cl_string_unref(item->label.ok);
+    if (item->details->label.ok != NULL)
+        cl_string_unref(item->details->label.ok);
+
+    if (item->details->label.cancel != NULL)
+        cl_string_unref(item->details->label.cancel);
+
+    if (item->details->label.extra != NULL)
+        cl_string_unref(item->details->label.extra);
+
+    if (item->details->label.help != NULL)
+        cl_string_unref(item->details->label.help);
 
-    if (item->label.cancel != NULL)
-        cl_string_unref(item->label.cancel);
+    if (item->details->label.title != NULL)
+        cl_string_unref(item->details->label.title);
 
-    if (item->label.extra != NULL)
-        cl_string_unref(item->label.extra);
+    /* Only left behind when the item parsing failed */
+    if (item->__helper != NULL)
+        free(item->__helper);
 
-    if (item->label.help != NULL)
-        cl_string_unref(item->label.help);
+    /* progress channel */
+    if (item->progress.fd >= 0)
+        close(item->progress.fd);
 
-    if (item->label.title != NULL)
-        cl_string_unref(item->label.title);
+    if (item->template != NULL)
+        xante_item_unref(item->template);
 
-    free(item);
+    /* Items from the JTF are released along with their arena */
+    if (item->from_arena == false) {
+        free(item->details);
+        free(item);
+    }
 }
 
 /*
@@ -208,6 +245,9 @@ static struct xante_item *look_for_item(const struct xante_app *xpp,
 
     node = cl_list_map(xpp->ui.menus, look_for_item_in_menu, data);
 
+    if (NULL == node)
+        node = dm_map_menus(xpp, look_for_item_in_menu, data);
+
     if (NULL == node)
         return NULL;
 
@@ -234,6 +274,9 @@ static struct xante_item *xante_item_search_by_name(const struct xante_app *xpp,
 
     menu = xante_menu_search_by_name(xpp->ui.menus, menu_name);
 
+    if (NULL == menu)
+        menu = dm_search_menu_by_name(xpp, menu_name);
+
     if (NULL == menu) {
         errno_set(XANTE_ERROR_MENU_NOT_FOUND);
         errno_store_additional_content(menu_name);
@@ -310,6 +353,62 @@ static struct xante_item *xante_item_search_by_config_name(const struct xante_ap
     return item;
 }
 
+/*
+ * Gives the item current value as it's displayed, if it's an item that may
+ * hold a value.
+ */
+static char *value_as_text(const struct xante_item *item)
+{
+    char *text = NULL;
+    cl_string_t *value = NULL;
+    int index = -1;
+
+    switch (item->widget_type) {
+        case XANTE_WIDGET_INPUT_INT:
+        case XANTE_WIDGET_INPUT_FLOAT:
+        case XANTE_WIDGET_INPUT_DATE:
+        case XANTE_WIDGET_INPUT_TIME:
+        case XANTE_WIDGET_CALENDAR:
+        case XANTE_WIDGET_TIMEBOX:
+        case XANTE_WIDGET_INPUT_STRING:
+        case XANTE_WIDGET_RANGE:
+        case XANTE_WIDGET_INPUTSCROLL:
+            value = cl_object_to_cstring(item_value(item));
+
+            if ((value != NULL) && (cl_string_length(value) > 0))
+                text = strdup(cl_string_valueof(value));
+
+            break;
+
+        case XANTE_WIDGET_RADIO_CHECKLIST:
+            index = CL_OBJECT_AS_INT(item_value(item));
+            value = cl_stringlist_get(item->list_items, index);
+
+            if (value != NULL)
+                text = strdup(cl_string_valueof(value));
+
+            break;
+
+        case XANTE_WIDGET_YES_NO:
+            index = CL_OBJECT_AS_INT(item_value(item));
+
+            if (index == 1)
+                text = strdup(cl_tr("Yes"));
+            else
+                text = strdup(cl_tr("No"));
+
+            break;
+
+        default:
+            break;
+    }
+
+    if (value != NULL)
+        cl_string_unref(value);
+
+    return text;
+}
+
 /*
  *
  * Internal API
@@ -366,17 +465,42 @@ void xante_item_unref(struct xante_item *item)
  *
  * To release an object of this type, one may call the 'xante_item_unref'.
  *
+ * @param [in,out] arena: An optional arena where the item will be allocated.
+ *                        Its memory is only released with the arena.
+ *
  * @return On success returns a xante_item structure or NULL otherwise.
  */
-struct xante_item *xante_item_create(void)
+struct xante_item *xante_item_create(struct arena *arena)
 {
     struct xante_item *item = NULL;
 
-    item = calloc(1, sizeof(struct xante_item));
+    if (arena != NULL) {
+        item = arena_alloc(arena, sizeof(struct xante_item));
 
-    if (NULL == item) {
-        errno_set(XANTE_ERROR_NO_MEMORY);
-        return NULL;
+        if (NULL == item)
+            return NULL;
+
+        item->details = arena_alloc(arena, sizeof(struct item_details));
+
+        if (NULL == item->details)
+            return NULL;
+
+        item->from_arena = true;
+    } else {
+        item = calloc(1, sizeof(struct xante_item));
+
+        if (NULL == item) {
+            errno_set(XANTE_ERROR_NO_MEMORY);
+            return NULL;
+        }
+
+        item->details = calloc(1, sizeof(struct item_details));
+
+        if (NULL == item->details) {
+            free(item);
+            errno_set(XANTE_ERROR_NO_MEMORY);
+            return NULL;
+        }
     }
 
     /*
@@ -388,18 +512,11 @@ struct xante_item *xante_item_create(void)
     /*
      * Every item has, at least, the Ok and the Cancel buttons enabled.
      */
-    item->button.ok = true;
-    item->button.cancel = true;
+    item->details->button.ok = true;
+    item->details->button.cancel = true;
 
-    /*
-     * Ensures that every item has its helper variables correctly
-     * initialized.
-     */
-    item->__helper.min = NULL;
-    item->__helper.max = NULL;
-    item->__helper.brief_options_help = NULL;
-    item->__helper.options = NULL;
-    item->__helper.default_value = NULL;
+    /* The progress channel is only opened when the item runs a progress */
+    item->progress.fd = -1;
 
     /* Initialize reference count */
     item->ref.count = 1;
@@ -408,6 +525,248 @@ struct xante_item *xante_item_create(void)
     return item;
 }
 
+/**
+ * @name item_progress_open
+ * @brief Prepares the item progress channel to receive new values.
+ *
+ * The channel is kept open until the item is released, so threads still
+ * posting values after the UI has finished never touch a closed descriptor.
+ *
+ * @param [in,out] item: The item.
+ *
+ * @return On success returns 0 or -1 otherwise.
+ */
+int item_progress_open(struct xante_item *item)
+{
+    eventfd_t v;
+
+    if (item->progress.fd < 0) {
+        item->progress.fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (item->progress.fd < 0)
+            return -1;
+    } else
+        eventfd_read(item->progress.fd, &v); /* Discards old notifications */
+
+    __atomic_store_n(&item->progress.value, 0, __ATOMIC_RELEASE);
+
+    return 0;
+}
+
+/**
+ * @name item_progress_value
+ * @brief Gives the last progress value posted to an item.
+ *
+ * @param [in] item: The item.
+ *
+ * @return Returns the last posted value.
+ */
+int item_progress_value(const struct xante_item *item)
+{
+    return __atomic_load_n(&item->progress.value, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @name item_progress_wait
+ * @brief Waits for a new progress value to be posted to an item.
+ *
+ * Every notification pending is consumed at once, so a burst of posted
+ * values results in a single wake up.
+ *
+ * @param [in,out] item: The item.
+ * @param [in] timeout: The maximum time to wait, in milliseconds, or -1 to
+ *                      wait forever.
+ *
+ * @return Returns true if something was posted or false if the timeout
+ *         expired.
+ */
+bool item_progress_wait(struct xante_item *item, int timeout)
+{
+    struct pollfd pfd = {
+        .fd = item->progress.fd,
+        .events = POLLIN,
+    };
+
+    eventfd_t v;
+
+    if (item->progress.fd < 0) {
+        if (timeout > 0)
+            cl_msleep(timeout);
+
+        return false;
+    }
+
+    if (poll(&pfd, 1, timeout) <= 0)
+        return false;
+
+    return (eventfd_read(item->progress.fd, &v) == 0);
+}
+
+/*
+ * Drops the display text of an item. It must be called holding the
+ * display lock.
+ */
+static void drop_display_value(struct xante_item *item)
+{
+    if (item->display_value != NULL) {
+        free(item->display_value);
+        item->display_value = NULL;
+    }
+
+    item->display_cached = false;
+}
+
+/**
+ * @name item_set_value
+ * @brief Replaces the current value of an item.
+ *
+ * @param [in,out] item: The item.
+ * @param [in] value: The new value, whose reference is taken by the item. It
+ *                    may be NULL to go back to the default value.
+ */
+void item_set_value(struct xante_item *item, cl_object_t *value)
+{
+    cl_object_t *old_value = NULL;
+
+    pthread_mutex_lock(&__display_lock);
+    old_value = item->value;
+    item->value = value;
+    drop_display_value(item);
+    pthread_mutex_unlock(&__display_lock);
+
+    if (old_value != NULL)
+        cl_object_unref(old_value);
+}
+
+/**
+ * @name item_value_updated
+ * @brief Tells that the current value of an item was changed in place.
+ *
+ * @param [in,out] item: The item.
+ */
+void item_value_updated(struct xante_item *item)
+{
+    pthread_mutex_lock(&__display_lock);
+    drop_display_value(item);
+    pthread_mutex_unlock(&__display_lock);
+}
+
+/**
+ * @name item_display_lock
+ * @brief Holds every item display text, so none of them is replaced while
+ *        a menu is being built.
+ */
+void item_display_lock(void)
+{
+    pthread_mutex_lock(&__display_lock);
+}
+
+/**
+ * @name item_display_unlock
+ * @brief Releases the item display texts held with 'item_display_lock'.
+ */
+void item_display_unlock(void)
+{
+    pthread_mutex_unlock(&__display_lock);
+}
+
+/**
+ * @name item_display_value
+ * @brief Gives an item current value as it's displayed inside a menu.
+ *
+ * The text is only built again after the item value changes. It must be
+ * called, and its text used, between 'item_display_lock' and
+ * 'item_display_unlock', so a value changed by another thread does not
+ * release it in the meantime.
+ *
+ * @param [in,out] item: The item.
+ *
+ * @return Returns the text or NULL if the item has no value to display.
+ */
+const char *item_display_value(struct xante_item *item)
+{
+    if (item->display_cached == false) {
+        item->display_value = value_as_text(item);
+        item->display_cached = true;
+    }
+
+    return item->display_value;
+}
+
+/*
+ * Copies an item value, so it doesn't change when the original one is
+ * updated in place.
+ */
+static cl_object_t *value_copy(const struct xante_item *item)
+{
+    cl_object_t *value = NULL;
+    cl_string_t *s = NULL;
+
+    if (NULL == item->value)
+        return NULL;
+
+    switch (item->widget_type) {
+        case XANTE_WIDGET_INPUT_INT:
+        case XANTE_WIDGET_RADIO_CHECKLIST:
+        case XANTE_WIDGET_YES_NO:
+        case XANTE_WIDGET_RANGE:
+            return cl_object_create(CL_INT, CL_OBJECT_AS_INT(item->value));
+
+        case XANTE_WIDGET_INPUT_FLOAT:
+            return cl_object_create(CL_FLOAT, CL_OBJECT_AS_FLOAT(item->value));
+
+        default:
+            break;
+    }
+
+    s = cl_object_to_cstring(item->value);
+
+    if (NULL == s)
+        return NULL;
+
+    value = cl_object_create(CL_STRING, cl_string_valueof(s));
+    cl_string_unref(s);
+
+    return value;
+}
+
+/**
+ * @name item_snapshot
+ * @brief Creates a detached copy of an item, holding its identification
+ *        and current value.
+ *
+ * The copy may be used by another thread while the original item keeps
+ * being used by the UI. Changes made to it are not seen by the application.
+ *
+ * @param [in] item: The item.
+ *
+ * @return On success returns the copy, which must be released with
+ *         'xante_item_unref', or NULL otherwise.
+ */
+struct xante_item *item_snapshot(const struct xante_item *item)
+{
+    struct xante_item *snapshot = NULL;
+
+    snapshot = xante_item_create(NULL);
+
+    if (NULL == snapshot)
+        return NULL;
+
+    snapshot->name = cl_string_ref(item->name);
+    snapshot->object_id = cl_string_ref(item->object_id);
+    snapshot->config_block = cl_string_ref(item->config_block);
+    snapshot->config_item = cl_string_ref(item->config_item);
+    snapshot->widget_type = item->widget_type;
+    snapshot->widget_checklist_type = item->widget_checklist_type;
+    snapshot->mode = item->mode;
+    snapshot->value = value_copy(item);
+
+    if (item->default_value != NULL)
+        snapshot->default_value = cl_object_ref(item->default_value);
+
+    return snapshot;
+}
+
 /*
  *
  * API
@@ -557,8 +916,7 @@ __PUB_API__ int xante_item_update_value(xante_item_t *item, const char *fmt, ...
     }
 
     cl_string_unref(tmp);
-    cl_object_unref(i->value);
-    i->value = data;
+    item_set_value(i, data);
 
     return 0;
 }
@@ -584,7 +942,54 @@ __PUB_API__ int xante_item_cancel_update(xante_item_t *item)
      * If any update routine is running for this item it will stop right
      * after this change.
      */
-    i->cancel_update = true;
+    __atomic_store_n(&i->cancel_update, true, __ATOMIC_RELEASE);
+
+    /* Wakes up a progress waiting for new values */
+    if (i->progress.fd >= 0)
+        eventfd_write(i->progress.fd, 1);
+
+    return 0;
+}
+
+__PUB_API__ int xante_item_post_progress(xante_item_t *item, int value)
+{
+    struct xante_item *i = (struct xante_item *)item;
+
+    errno_clear();
+
+    if (NULL == item) {
+        errno_set(XANTE_ERROR_NULL_ARG);
+        return -1;
+    }
+
+    __atomic_store_n(&i->progress.value, value, __ATOMIC_RELEASE);
+
+    if (i->progress.fd >= 0)
+        eventfd_write(i->progress.fd, 1);
+
+    return 0;
+}
+
+__PUB_API__ int xante_item_validate(const xante_item_t *item,
+    const char *value)
+{
+    const struct xante_item *i = (const struct xante_item *)item;
+    enum validator_status status;
+
+    errno_clear();
+
+    if ((NULL == item) || (NULL == value)) {
+        errno_set(XANTE_ERROR_NULL_ARG);
+        return -1;
+    }
+
+    status = validator_check(&i->validator, value);
+
+    if (status != VALIDATOR_OK) {
+        errno_set(XANTE_ERROR_INVALID_ITEM_VALUE);
+        errno_store_additional_content(validator_strerror(status));
+        return -1;
+    }
 
     return 0;
 }
@@ -602,6 +1007,13 @@ __PUB_API__ xante_item_t *xante_item_search(const xante_t *xpp,
         return NULL;
     }
 
+    /*
+     * Items from dynamic menu copies are only created when needed. The
+     * copies are held during the search, so the UI can't replace them
+     * under us if we're called from another thread.
+     */
+    dm_lock(xpp);
+    dm_materialize_all((struct xante_app *)xpp);
     va_start(ap, NULL);
 
     switch (mode) {
@@ -619,10 +1031,11 @@ __PUB_API__ xante_item_t *xante_item_search(const xante_t *xpp,
 
         default:
             errno_set(XANTE_ERROR_INVALID_ARG);
-            return NULL;
+            break;
     }
 
     va_end(ap);
+    dm_unlock(xpp);
 
     return item;
 }
@@ -219,6 +219,44 @@ static void parse_blocked_keys(const cl_json_t *general, struct xante_app *xpp)
     }
 }
 
+/*
+ * Checks if @event_name is listed inside an array of events which must be
+ * called asynchronously.
+ */
+static bool has_async_event(const cl_json_t *events, const char *event_name)
+{
+    cl_json_t *node = NULL;
+    cl_string_t *value = NULL;
+    int i, t;
+
+    if (NULL == events)
+        return false;
+
+    t = cl_json_get_array_size(events);
+
+    for (i = 0; i < t; i++) {
+        node = cl_json_get_array_item(events, i);
+        value = cl_json_get_object_value(node);
+
+        if ((value != NULL) &&
+            (strcmp(cl_string_valueof(value), event_name) == 0))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void parse_async_events(const cl_json_t *general, struct xante_app *xpp)
+{
+    cl_json_t *events;
+
+    events = cl_json_get_object_item(general, XANTE_JTF_ASYNC_EVENTS);
+    xpp->info.async_changes_saved = has_async_event(events, EV_CHANGES_SAVED);
+    xpp->info.async_config_unload = has_async_event(events, EV_CONFIG_UNLOAD);
+}
+
 static int parse_jtf_info(cl_json_t *jtf, struct xante_app *xpp)
 {
     cl_json_t *general = NULL, *internal = NULL;
@@ -305,6 +343,7 @@ static int parse_jtf_info(cl_json_t *jtf, struct xante_app *xpp)
     }
 
     parse_blocked_keys(general, xpp);
+    parse_async_events(general, xpp);
 
     return 0;
 }
@@ -367,13 +406,13 @@ static int parse_item_ranges(const cl_json_t *item, struct xante_item *i)
                                                                  : CL_JSON_NUMBER;
 
     if ((parse_object_value(ranges, XANTE_JTF_MIN_RANGE, expected_type, false,
-                            (void **)&i->__helper.min) < 0) && min_range)
+                            (void **)&i->__helper->min) < 0) && min_range)
     {
         return -1;
     }
 
     if ((parse_object_value(ranges, XANTE_JTF_MAX_RANGE, expected_type, false,
-                            (void **)&i->__helper.max) < 0) && max_range)
+                            (void **)&i->__helper->max) < 0) && max_range)
     {
         return -1;
     }
@@ -386,12 +425,19 @@ static int parse_item_config(const cl_json_t *item, struct xante_item *it,
 {
     cl_json_t *config = NULL;
 
+    config = cl_json_get_object_item(item, XANTE_JTF_CONFIG);
+
+    /*
+     * An unknown type may belong to a widget registered by a module loaded
+     * later, so its configuration is kept when it's declared.
+     */
+    if ((it->widget_type == XANTE_WIDGET_UNKNOWN) && (config != NULL))
+        it->details->flags.config = true;
+
     /* The item does not have configuration */
-    if (it->flags.config == false)
+    if (it->details->flags.config == false)
         return 0;
 
-    config = cl_json_get_object_item(item, XANTE_JTF_CONFIG);
-
     if (NULL == config) {
         if (single_instance == false) {
             errno_set(XANTE_ERROR_JTF_NO_CONFIG_OBJECT);
@@ -450,6 +496,34 @@ static int parse_item_help(const cl_json_t *item, struct xante_item *it,
     return 0;
 }
 
+/*
+ * How the module EV_VALUE_CHECK event is called while the user types inside
+ * an inputscroll.
+ */
+static int parse_item_input_check(const cl_json_t *item, struct xante_item *it)
+{
+    cl_json_t *check = NULL;
+
+    check = cl_json_get_object_item(item, XANTE_JTF_INPUT_CHECK);
+
+    if (NULL == check)
+        return 0;
+
+    if (parse_object_value(check, XANTE_JTF_DEBOUNCE, CL_JSON_NUMBER, false,
+                           &it->behaviour.check_debounce) < 0)
+    {
+        return -1;
+    }
+
+    if (parse_object_value(check, XANTE_JTF_ASYNC, CL_JSON_TRUE, false,
+                           &it->behaviour.async_check) < 0)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
 /*
  * This function is responsible for initializations with properties of an
  * item, so it may be correctly parsed and validated.
@@ -457,7 +531,7 @@ static int parse_item_help(const cl_json_t *item, struct xante_item *it,
 static void pre_adjust_item_info(struct xante_item *item)
 {
     item->widget_type = translate_string_widget_type(item->type);
-    item->flags.ranges = item_has_ranges(item->widget_type);
+    item->details->flags.ranges = item_has_ranges(item->widget_type);
 
     /* Internal gadgets don't need to load some objects. */
     if (is_gadget(item->widget_type))
@@ -467,7 +541,7 @@ static void pre_adjust_item_info(struct xante_item *item)
     if ((item->widget_type == XANTE_WIDGET_MENU_REFERENCE) ||
         (item->widget_type == XANTE_WIDGET_DYNAMIC_MENU_REFERENCE))
     {
-        item->flags.referenced_menu = true;
+        item->details->flags.referenced_menu = true;
     } else {
         if ((item->widget_type == XANTE_WIDGET_INPUT_INT) ||
             (item->widget_type == XANTE_WIDGET_INPUT_FLOAT) ||
@@ -482,17 +556,58 @@ static void pre_adjust_item_info(struct xante_item *item)
             (item->widget_type == XANTE_WIDGET_RANGE) ||
             (item->widget_type == XANTE_WIDGET_INPUTSCROLL) ||
             (item->widget_type == XANTE_WIDGET_BUILDLIST) ||
-            (item->widget_type == XANTE_WIDGET_SPREADSHEET))
+            (item->widget_type == XANTE_WIDGET_SPREADSHEET) ||
+            session_is_registered_widget(item->widget_type))
         {
-            item->flags.config = true;
+            item->details->flags.config = true;
         }
 
         /* Almost every item needs to have the "options" object */
         if (item->widget_type != XANTE_WIDGET_CUSTOM)
-            item->flags.options = true;
+            item->details->flags.options = true;
     }
 }
 
+/*
+ * Every task of a multi-progress is a complete progress item, with its own
+ * name, ranges and events. They are not part of any menu, so they don't
+ * need an object_id.
+ */
+static int parse_item_tasks(struct xante_item *item)
+{
+    struct xante_item *task = NULL;
+    int i, t;
+
+    t = cl_json_get_array_size(item->__helper->tasks);
+    item->details->tasks = cl_list_create(xante_item_destroy, NULL, NULL, NULL);
+
+    if (NULL == item->details->tasks) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return -1;
+    }
+
+    for (i = 0; i < t; i++) {
+        task = jtf_parse_item(cl_json_get_array_item(item->__helper->tasks, i),
+                              true, item->__helper->arena,
+                              item->__helper->strings);
+
+        if (NULL == task)
+            return -1;
+
+        if (task->widget_type != XANTE_WIDGET_PROGRESS) {
+            errno_set(XANTE_ERROR_JTF_WRONG_OBJECT_TYPE);
+            errno_store_additional_content(cl_string_valueof(task->name));
+            errno_store_additional_content(XANTE_STR_WIDGET_PROGRESS);
+            xante_item_unref(task);
+            return -1;
+        }
+
+        cl_list_unshift(item->details->tasks, task, -1);
+    }
+
+    return 0;
+}
+
 /**
  * Do some adjustments inside an item after its information is
  * completely loaded from the JTF file.
@@ -513,23 +628,34 @@ static int adjusts_item_info(struct xante_item *item)
      * We hold the item's default-value as an cl_object_t since we can have
      * different types of values.
      */
-    if (item->__helper.default_value != NULL) {
-        item->default_value = cl_object_from_cstring(item->__helper.default_value);
-        cl_string_unref(item->__helper.default_value);
+    if (item->__helper->default_value != NULL) {
+        item->default_value = cl_object_from_cstring(item->__helper->default_value);
+        cl_string_unref(item->__helper->default_value);
     }
 
     switch (item->widget_type) {
         case XANTE_WIDGET_RADIO_CHECKLIST:
         case XANTE_WIDGET_CHECKLIST:
         case XANTE_WIDGET_BUILDLIST:
-            if (item->__helper.options != NULL) {
-                t = cl_json_get_array_size(item->__helper.options);
+            if (item->__helper->options != NULL) {
+                t = cl_json_get_array_size(item->__helper->options);
                 item->list_items = cl_stringlist_create();
 
+                /* A buildlist selection is kept as a set of option ids */
+                if (item->widget_type == XANTE_WIDGET_BUILDLIST) {
+                    item->options_index = option_index_create(t);
+
+                    if (NULL == item->options_index)
+                        return -1;
+                }
+
                 for (i = 0; i < t; i++) {
-                    node = cl_json_get_array_item(item->__helper.options, i);
+                    node = cl_json_get_array_item(item->__helper->options, i);
                     value = cl_json_get_object_value(node);
                     cl_stringlist_add(item->list_items, value);
+
+                    if (item->options_index != NULL)
+                        option_index_add(item->options_index, value);
                 }
             }
 
@@ -542,14 +668,14 @@ static int adjusts_item_info(struct xante_item *item)
                 (item->widget_type == XANTE_WIDGET_CHECKLIST) ? FLAG_CHECK
                                                               : FLAG_RADIO;
 
-            if (item->__helper.brief_options_help != NULL) {
-                t = cl_json_get_array_size(item->__helper.brief_options_help);
-                item->checklist_brief_options = cl_stringlist_create();
+            if (item->__helper->brief_options_help != NULL) {
+                t = cl_json_get_array_size(item->__helper->brief_options_help);
+                item->details->checklist_brief_options = cl_stringlist_create();
 
                 for (i = 0; i < t; i++) {
-                    node = cl_json_get_array_item(item->__helper.brief_options_help, i);
+                    node = cl_json_get_array_item(item->__helper->brief_options_help, i);
                     value = cl_json_get_object_value(node);
-                    cl_stringlist_add(item->checklist_brief_options, value);
+                    cl_stringlist_add(item->details->checklist_brief_options, value);
                 }
             }
 
@@ -565,8 +691,8 @@ static int adjusts_item_info(struct xante_item *item)
 
         case XANTE_WIDGET_INPUT_INT:
         case XANTE_WIDGET_RANGE:
-            i_min = *(int *)&item->__helper.min;
-            i_max = *(int *)&item->__helper.max;
+            i_min = *(int *)&item->__helper->min;
+            i_max = *(int *)&item->__helper->max;
             item->min = cl_object_create(CL_INT, i_min);
             item->max = cl_object_create(CL_INT, i_max);
             break;
@@ -574,22 +700,28 @@ static int adjusts_item_info(struct xante_item *item)
         case XANTE_WIDGET_PROGRESS:
         case XANTE_WIDGET_SPINNER_SYNC:
         case XANTE_WIDGET_DOTS_SYNC:
-            i_max = *(int *)&item->__helper.max;
+            i_max = *(int *)&item->__helper->max;
             item->max = cl_object_create(CL_INT, i_max);
             break;
 
         case XANTE_WIDGET_INPUT_FLOAT:
-            f_min = *(float *)&item->__helper.min;
-            f_max = *(float *)&item->__helper.max;
+            f_min = *(float *)&item->__helper->min;
+            f_max = *(float *)&item->__helper->max;
             item->min = cl_object_create(CL_FLOAT, f_min);
             item->max = cl_object_create(CL_FLOAT, f_max);
             break;
 
+        case XANTE_WIDGET_MULTI_PROGRESS:
+            if (parse_item_tasks(item) < 0)
+                return -1;
+
+            break;
+
         case XANTE_WIDGET_MIXEDFORM:
         case XANTE_WIDGET_SPREADSHEET:
-            item->form_options = cl_json_parse(item->__helper.options);
+            item->details->form_options = cl_json_parse(item->__helper->options);
 
-            if (NULL == item->form_options) {
+            if (NULL == item->details->form_options) {
                 errno_set(XANTE_ERROR_INVALID_FORM_JSON);
                 errno_store_additional_content(cl_string_valueof(item->name));
                 return -1;
@@ -606,17 +738,16 @@ static int adjusts_item_info(struct xante_item *item)
         (item->widget_type != XANTE_WIDGET_MIXEDFORM) &&
         (item->widget_type != XANTE_WIDGET_SPREADSHEET))
     {
-        if (item->__helper.options != NULL) {
-            item->options = cl_string_ref(item->__helper.options);
-            cl_string_unref(item->__helper.options);
+        if (item->__helper->options != NULL) {
+            item->options = cl_string_ref(item->__helper->options);
+            cl_string_unref(item->__helper->options);
         }
     } else
-        if (item->__helper.options != NULL)
-            cl_string_unref(item->__helper.options);
+        if (item->__helper->options != NULL)
+            cl_string_unref(item->__helper->options);
 
-    if (item_has_ranges(item->widget_type) == true)
-        item->value_spec = cl_spec_create(CL_READABLE | CL_WRITABLE, item->min,
-                                          item->max, item->string_length);
+    /* Input constraints are checked without touching the cl_object_t's */
+    validator_compile(&item->validator, item);
 
     return 0;
 }
@@ -738,7 +869,8 @@ static int parse_ui(cl_json_t *jtf, struct xante_app *xpp)
     t = cl_json_get_array_size(node);
 
     for (i = 0; i < t; i++) {
-        menu = jtf_parse_menu(cl_json_get_array_item(node, i));
+        menu = jtf_parse_menu(cl_json_get_array_item(node, i),
+                              xpp->ui.arena, xpp->ui.strings);
 
         if (NULL == menu)
             return -1;
@@ -788,9 +920,9 @@ static bool data_object_must_exist(const struct xante_item *item)
 {
     bool must = false;
 
-    if (item->flags.options ||
-        item->flags.referenced_menu ||
-        item->flags.config)
+    if (item->details->flags.options ||
+        item->details->flags.referenced_menu ||
+        item->details->flags.config)
     {
         must = true;
     }
@@ -816,7 +948,7 @@ static int parse_item_data(const cl_json_t *root, struct xante_item *item,
     }
 
     if (parse_object_value(data, XANTE_JTF_DEFAULT_VALUE, CL_JSON_STRING, false,
-                           (void **)&item->__helper.default_value) < 0)
+                           (void **)&item->__helper->default_value) < 0)
     {
         return -1;
     }
@@ -830,15 +962,23 @@ static int parse_item_data(const cl_json_t *root, struct xante_item *item,
     }
 
     if ((parse_object_value(data, XANTE_JTF_OPTIONS, expected_option, false,
-                            (void **)&item->__helper.options) < 0) &&
-        item->flags.options)
+                            (void **)&item->__helper->options) < 0) &&
+        item->details->flags.options)
     {
         return -1;
     }
 
     if ((parse_object_value(data, XANTE_JTF_REFERENCED_MENU, CL_JSON_STRING, false,
                             (void **)&item->referenced_menu) < 0) &&
-        item->flags.referenced_menu)
+        item->details->flags.referenced_menu)
+    {
+        return -1;
+    }
+
+    /* Only a multi-progress holds other items inside */
+    if ((item->widget_type == XANTE_WIDGET_MULTI_PROGRESS) &&
+        (parse_object_value(data, XANTE_JTF_TASKS, CL_JSON_ARRAY, true,
+                            &item->__helper->tasks) < 0))
     {
         return -1;
     }
@@ -849,6 +989,12 @@ static int parse_item_data(const cl_json_t *root, struct xante_item *item,
     if (parse_item_ranges(data, item) < 0)
         return -1;
 
+    if ((item->widget_type == XANTE_WIDGET_INPUTSCROLL) &&
+        (parse_item_input_check(data, item) < 0))
+    {
+        return -1;
+    }
+
     return 0;
 }
 
@@ -863,25 +1009,25 @@ static int parse_item_button_labels(const cl_json_t *labels,
         return 0;
 
     if (parse_object_value(buttons, XANTE_JTF_BTN_OK_LABEL, CL_JSON_STRING, false,
-                           (void **)&item->label.ok) < 0)
+                           (void **)&item->details->label.ok) < 0)
     {
         return -1;
     }
 
     if (parse_object_value(buttons, XANTE_JTF_BTN_CANCEL_LABEL, CL_JSON_STRING, false,
-                           (void **)&item->label.cancel) < 0)
+                           (void **)&item->details->label.cancel) < 0)
     {
         return -1;
     }
 
     if (parse_object_value(buttons, XANTE_JTF_BTN_EXTRA_LABEL, CL_JSON_STRING, false,
-                           (void **)&item->label.extra) < 0)
+                           (void **)&item->details->label.extra) < 0)
     {
         return -1;
     }
 
     if (parse_object_value(buttons, XANTE_JTF_BTN_HELP_LABEL, CL_JSON_STRING, false,
-                           (void **)&item->label.help) < 0)
+                           (void **)&item->details->label.help) < 0)
     {
         return -1;
     }
@@ -899,12 +1045,12 @@ static int parse_item_labels(const cl_json_t *ui, struct xante_item *item)
         return 0;
 
     if (parse_object_value(labels, XANTE_JTF_TITLE, CL_JSON_STRING, false,
-                           (void **)&item->label.title) < 0)
+                           (void **)&item->details->label.title) < 0)
     {
         return -1;
     }
 
-    if (parse_item_help(labels, item, &item->__helper.brief_options_help) < 0)
+    if (parse_item_help(labels, item, &item->__helper->brief_options_help) < 0)
         return -1;
 
     if (parse_item_button_labels(labels, item) < 0)
@@ -926,25 +1072,25 @@ static int parse_item_buttons(const cl_json_t *ui, struct xante_item *item)
         return 0;
 
     if (parse_object_value(buttons, XANTE_JTF_BTN_OK_LABEL, CL_JSON_TRUE, false,
-                           (void **)&item->button.ok) < 0)
+                           (void **)&item->details->button.ok) < 0)
     {
         return -1;
     }
 
     if (parse_object_value(buttons, XANTE_JTF_BTN_CANCEL_LABEL, CL_JSON_TRUE, false,
-                           (void **)&item->button.cancel) < 0)
+                           (void **)&item->details->button.cancel) < 0)
     {
         return -1;
     }
 
     if (parse_object_value(buttons, XANTE_JTF_BTN_EXTRA_LABEL, CL_JSON_TRUE, false,
-                           (void **)&item->button.extra) < 0)
+                           (void **)&item->details->button.extra) < 0)
     {
         return -1;
     }
 
     if (parse_object_value(buttons, XANTE_JTF_BTN_HELP_LABEL, CL_JSON_TRUE, false,
-                           (void **)&item->button.help) < 0)
+                           (void **)&item->details->button.help) < 0)
     {
         return -1;
     }
@@ -970,25 +1116,25 @@ static int parse_item_ui(const cl_json_t *root, struct xante_item *item)
     }
 
     if (parse_object_value(ui, XANTE_JTF_BTN_OK, CL_JSON_TRUE, false,
-                           (void **)&item->button.ok) < 0)
+                           (void **)&item->details->button.ok) < 0)
     {
         return -1;
     }
 
     if (parse_object_value(ui, XANTE_JTF_BTN_CANCEL, CL_JSON_TRUE, false,
-                           (void **)&item->button.cancel) < 0)
+                           (void **)&item->details->button.cancel) < 0)
     {
         return -1;
     }
 
     if (parse_object_value(ui, XANTE_JTF_BTN_EXTRA, CL_JSON_TRUE, false,
-                           (void **)&item->button.extra) < 0)
+                           (void **)&item->details->button.extra) < 0)
     {
         return -1;
     }
 
     if (parse_object_value(ui, XANTE_JTF_BTN_HELP, CL_JSON_TRUE, false,
-                           (void **)&item->button.help) < 0)
+                           (void **)&item->details->button.help) < 0)
     {
         return -1;
     }
@@ -1005,6 +1151,43 @@ static int parse_item_ui(const cl_json_t *root, struct xante_item *item)
     return 0;
 }
 
+/*
+ * Strings repeated across the JTF are shared by every item using them.
+ */
+static void intern_item_strings(struct xante_item *item,
+    struct intern_table *strings)
+{
+    item->type = intern_string(strings, item->type);
+    item->config_block = intern_string(strings, item->config_block);
+    item->config_item = intern_string(strings, item->config_item);
+    item->details->label.ok = intern_string(strings, item->details->label.ok);
+    item->details->label.cancel = intern_string(strings,
+                                                item->details->label.cancel);
+
+    item->details->label.extra = intern_string(strings,
+                                               item->details->label.extra);
+
+    item->details->label.help = intern_string(strings,
+                                              item->details->label.help);
+
+    item->details->label.title = intern_string(strings,
+                                               item->details->label.title);
+}
+
+static void intern_menu_strings(struct xante_menu *menu,
+    struct intern_table *strings)
+{
+    menu->type = intern_string(strings, menu->type);
+    menu->dynamic_block_prefix = intern_string(strings,
+                                               menu->dynamic_block_prefix);
+
+    menu->dynamic_origin_block = intern_string(strings,
+                                               menu->dynamic_origin_block);
+
+    menu->dynamic_origin_item = intern_string(strings,
+                                              menu->dynamic_origin_item);
+}
+
 /*
  *
  * Internal API
@@ -1021,19 +1204,34 @@ static int parse_item_ui(const cl_json_t *root, struct xante_item *item)
  * @param [in] item: The item as a JSON node.
  * @param [in] single_instance: A boolean flag to tell if we're parsing the main
  *                              application JTF file or a Single Instance JTF.
+ * @param [in,out] arena: An optional arena where the item will be allocated.
+ * @param [in,out] strings: An optional table where repeated strings are
+ *                          shared.
  *
  * @return On success returns a struct xante_item with the parsed info or
  *         NULL otherwise.
  */
-struct xante_item *jtf_parse_item(const cl_json_t *item, bool single_instance)
+struct xante_item *jtf_parse_item(const cl_json_t *item, bool single_instance,
+    struct arena *arena, struct intern_table *strings)
 {
     struct xante_item *i;
 
-    i = xante_item_create();
+    i = xante_item_create(arena);
 
     if (NULL == i)
         return NULL;
 
+    /* Parsing state, released as soon as the item is ready */
+    i->__helper = calloc(1, sizeof(struct parser_helper));
+
+    if (NULL == i->__helper) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return NULL;
+    }
+
+    i->__helper->arena = arena;
+    i->__helper->strings = strings;
+
     /* Objects loaded before pre-adjusment are (almost all) mandatory */
     if (parse_object_value(item, XANTE_JTF_NAME, CL_JSON_STRING, true,
                            (void **)&i->name) < 0)
@@ -1070,6 +1268,12 @@ struct xante_item *jtf_parse_item(const cl_json_t *item, bool single_instance)
 
     i->events = cl_json_dup(cl_json_get_object_item(item, XANTE_JTF_EVENTS));
 
+    if (i->events != NULL) {
+        i->behaviour.async_value_updated =
+            has_async_event(cl_json_get_object_item(i->events, XANTE_JTF_ASYNC),
+                            EV_ITEM_VALUE_UPDATED);
+    }
+
     if (parse_item_ui(item, i) < 0)
         return NULL;
 
@@ -1077,6 +1281,10 @@ struct xante_item *jtf_parse_item(const cl_json_t *item, bool single_instance)
     if (adjusts_item_info(i))
         return NULL;
 
+    intern_item_strings(i, strings);
+    free(i->__helper);
+    i->__helper = NULL;
+
     return i;
 }
 
@@ -1085,11 +1293,16 @@ struct xante_item *jtf_parse_item(const cl_json_t *item, bool single_instance)
  * @brief Parses a JTF menu from a JSON node.
  *
  * @param [in] menu: The menu as a JSON node.
+ * @param [in,out] arena: An optional arena where the menu and its items will
+ *                        be allocated.
+ * @param [in,out] strings: An optional table where repeated strings are
+ *                          shared.
  *
  * @return On success returns a struct xante_menu with the parsed info or
  *         NULL otherwise.
  */
-struct xante_menu *jtf_parse_menu(const cl_json_t *menu)
+struct xante_menu *jtf_parse_menu(const cl_json_t *menu, struct arena *arena,
+    struct intern_table *strings)
 {
     cl_json_t *items;
     struct xante_menu *m = NULL;
@@ -1097,7 +1310,7 @@ struct xante_menu *jtf_parse_menu(const cl_json_t *menu)
     void *copies = NULL;
     int i, t;
 
-    m = xante_menu_create(XANTE_MENU_CREATED_FROM_JTF);
+    m = xante_menu_create(XANTE_MENU_CREATED_FROM_JTF, arena);
 
     if (NULL == m)
         return NULL;
@@ -1139,6 +1352,7 @@ struct xante_menu *jtf_parse_menu(const cl_json_t *menu)
      * items.
      */
     adjusts_menu_info(m, copies);
+    intern_menu_strings(m, strings);
     items = cl_json_get_object_item(menu, XANTE_JTF_ITEMS);
 
     if (NULL == items) {
@@ -1149,7 +1363,8 @@ struct xante_menu *jtf_parse_menu(const cl_json_t *menu)
     t = cl_json_get_array_size(items);
 
     for (i = 0; i < t; i++) {
-        it = jtf_parse_item(cl_json_get_array_item(items, i), false);
+        it = jtf_parse_item(cl_json_get_array_item(items, i), false, arena,
+                            strings);
 
         if (NULL == it)
             return NULL;
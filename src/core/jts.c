@@ -25,8 +25,64 @@
  * USA
  */
 
+#include <pthread.h>
+#include <stdint.h>
+
 #include "libxante.h"
 
+/* How many parsed JTS are kept to be reused */
+#define JTS_CACHE_MAX_ENTRIES           16
+
+/*
+ * A parsed JTS, identified by its content. Only one caller may use it at a
+ * time, since running it changes its items.
+ */
+struct jts_cache_entry {
+    uint64_t            hash;
+    size_t              length;
+    char                *content;
+    struct xante_jts    *jts;
+    bool                in_use;
+    unsigned long long  last_use;
+};
+
+/* A JTS registered by a module to be run with different arguments */
+struct jts_template {
+    char                *name;
+    char                *content;
+    struct xante_jts    *jts;
+    bool                in_use;
+};
+
+/*
+ * What an item had before being bound to the arguments of a template run,
+ * so it can be restored afterwards.
+ */
+struct jts_binding {
+    struct xante_item   *item;
+    struct xante_menu   *menu;
+    bool                title;
+    bool                default_value;
+    bool                options;
+
+    /* Original values */
+    cl_string_t         *o_name;
+    cl_object_t         *o_default_value;
+    cl_string_t         *o_options;
+    cl_stringlist_t     *o_list_items;
+    struct option_index *o_options_index;
+};
+
+struct jts_cache {
+    pthread_mutex_t         lock;
+    unsigned long long      clock;
+    struct jts_cache_entry  entries[JTS_CACHE_MAX_ENTRIES];
+
+    /* Templates */
+    struct jts_template     *templates;
+    int                     total_templates;
+};
+
 /*
  *
  * Internal functions
@@ -46,6 +102,8 @@ static struct xante_jts *new_xante_jts(void)
 
     m->menus = NULL;
     m->object = NULL;
+    m->cached = false;
+    m->binding = NULL;
 
     return m;
 }
@@ -64,7 +122,8 @@ static int si_jtf_parse(struct xante_jts *jts, cl_json_t *jdata)
         t = cl_json_get_array_size(object);
 
         for (i = 0; i < t; i++) {
-            menu = jtf_parse_menu(cl_json_get_array_item(object, i));
+            menu = jtf_parse_menu(cl_json_get_array_item(object, i), NULL,
+                                  NULL);
 
             if (NULL == menu)
                 return -1;
@@ -79,7 +138,7 @@ static int si_jtf_parse(struct xante_jts *jts, cl_json_t *jdata)
     object = cl_json_get_object_item(jdata, "item");
 
     if (object != NULL) {
-        jts->object = jtf_parse_item(object, true);
+        jts->object = jtf_parse_item(object, true, NULL, NULL);
 
         if (NULL == jts->object)
             return -1;
@@ -91,6 +150,349 @@ static int si_jtf_parse(struct xante_jts *jts, cl_json_t *jdata)
     return -1;
 }
 
+static uint64_t content_hash(const char *content, size_t length)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    size_t i;
+
+    for (i = 0; i < length; i++) {
+        hash ^= (unsigned char)content[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+static void reset_item_value(struct xante_item *item)
+{
+    /* Back to the JTS default-value */
+    item_set_value(item, NULL);
+
+    if (item->selected_options != NULL) {
+        option_set_destroy(item->selected_options);
+        item->selected_options = NULL;
+    }
+
+    item->cancel_update = false;
+}
+
+static int reset_item(cl_list_node_t *node, void *a __attribute__((unused)))
+{
+    reset_item_value(cl_list_node_content(node));
+
+    return 0;
+}
+
+static int reset_menu(cl_list_node_t *node, void *a)
+{
+    struct xante_menu *menu = cl_list_node_content(node);
+
+    cl_list_map(menu->items, reset_item, a);
+
+    return 0;
+}
+
+static void reset_jts(struct xante_jts *jts)
+{
+    if (jts->menus != NULL)
+        cl_list_map(jts->menus, reset_menu, NULL);
+
+    if (jts->object != NULL)
+        reset_item_value(jts->object);
+}
+
+static int find_form_item(cl_list_node_t *node, void *a __attribute__((unused)))
+{
+    struct xante_item *item = cl_list_node_content(node);
+
+    /* Stops the mapping */
+    return (item->details->form_options != NULL) ? 1 : 0;
+}
+
+static int find_form_menu(cl_list_node_t *node, void *a)
+{
+    struct xante_menu *menu = cl_list_node_content(node);
+    cl_list_node_t *form = NULL;
+
+    form = cl_list_map(menu->items, find_form_item, a);
+
+    if (NULL == form)
+        return 0;
+
+    cl_list_node_unref(form);
+
+    return 1;
+}
+
+/*
+ * Forms keep their values inside their JSON options, which cannot be
+ * restored after running. A JTS with one of them is always parsed again.
+ */
+static bool is_reusable(const struct xante_jts *jts)
+{
+    cl_list_node_t *node = NULL;
+
+    if ((jts->object != NULL) && (jts->object->details->form_options != NULL))
+        return false;
+
+    if (jts->menus != NULL) {
+        node = cl_list_map(jts->menus, find_form_menu, NULL);
+
+        if (node != NULL) {
+            cl_list_node_unref(node);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void release_entry(struct jts_cache_entry *entry)
+{
+    if (entry->jts != NULL) {
+        entry->jts->cached = false;
+        jts_unload(entry->jts);
+    }
+
+    if (entry->content != NULL)
+        free(entry->content);
+
+    memset(entry, 0, sizeof(struct jts_cache_entry));
+}
+
+static struct jts_cache_entry *cache_lookup(struct jts_cache *cache,
+    uint64_t hash, const char *content, size_t length)
+{
+    struct jts_cache_entry *entry = NULL;
+    int i;
+
+    for (i = 0; i < JTS_CACHE_MAX_ENTRIES; i++) {
+        entry = &cache->entries[i];
+
+        if ((entry->jts != NULL) && (entry->hash == hash) &&
+            (entry->length == length) &&
+            (memcmp(entry->content, content, length) == 0))
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/* Gives an empty entry or the least recently used one which is not running */
+static struct jts_cache_entry *cache_victim(struct jts_cache *cache)
+{
+    struct jts_cache_entry *entry = NULL, *victim = NULL;
+    int i;
+
+    for (i = 0; i < JTS_CACHE_MAX_ENTRIES; i++) {
+        entry = &cache->entries[i];
+
+        if (NULL == entry->jts)
+            return entry;
+
+        if (entry->in_use == true)
+            continue;
+
+        if ((NULL == victim) || (entry->last_use < victim->last_use))
+            victim = entry;
+    }
+
+    if (victim != NULL)
+        release_entry(victim);
+
+    return victim;
+}
+
+static struct jts_template *template_lookup(struct jts_cache *cache,
+    const char *name)
+{
+    int i;
+
+    for (i = 0; i < cache->total_templates; i++)
+        if (strcmp(cache->templates[i].name, name) == 0)
+            return &cache->templates[i];
+
+    return NULL;
+}
+
+static void release_template(struct jts_template *template)
+{
+    if (template->jts != NULL) {
+        template->jts->cached = false;
+        jts_unload(template->jts);
+    }
+
+    if (template->name != NULL)
+        free(template->name);
+
+    if (template->content != NULL)
+        free(template->content);
+
+    memset(template, 0, sizeof(struct jts_template));
+}
+
+static bool is_list_object(enum xante_object type)
+{
+    return (type == XANTE_WIDGET_RADIO_CHECKLIST) ||
+           (type == XANTE_WIDGET_CHECKLIST) ||
+           (type == XANTE_WIDGET_BUILDLIST);
+}
+
+static int bind_options(struct xante_item *item, struct jts_binding *binding,
+    const char * const *options, int total_options)
+{
+    cl_stringlist_t *list = NULL;
+    cl_string_t *text = NULL, *option = NULL;
+    int i;
+
+    binding->options = true;
+    binding->o_options = item->options;
+    binding->o_list_items = item->list_items;
+    binding->o_options_index = item->options_index;
+    item->options = NULL;
+    item->list_items = NULL;
+    item->options_index = NULL;
+
+    /* Other objects display their options as text, one per line */
+    if (is_list_object(item->widget_type) == false) {
+        text = cl_string_create_empty(0);
+
+        for (i = 0; i < total_options; i++) {
+            if (i > 0)
+                cl_string_cat(text, "%c", XANTE_STR_LINE_BREAK);
+
+            cl_string_cat(text, "%s", options[i]);
+        }
+
+        item->options = text;
+
+        return 0;
+    }
+
+    list = cl_stringlist_create();
+    item->list_items = list;
+
+    if (item->widget_type == XANTE_WIDGET_BUILDLIST) {
+        item->options_index = option_index_create(max(1, total_options));
+
+        if (NULL == item->options_index)
+            return -1;
+    }
+
+    for (i = 0; i < total_options; i++) {
+        option = cl_string_create("%s", options[i]);
+        cl_stringlist_add(list, option);
+
+        if (item->options_index != NULL)
+            option_index_add(item->options_index, option);
+
+        cl_string_unref(option);
+    }
+
+    return 0;
+}
+
+static void unbind(struct jts_binding *binding)
+{
+    struct xante_item *item = binding->item;
+
+    if (binding->menu != NULL) {
+        cl_string_unref(binding->menu->name);
+        binding->menu->name = binding->o_name;
+        xante_menu_unref(binding->menu);
+    }
+
+    if (NULL == item)
+        goto end_block;
+
+    if (binding->title == true) {
+        cl_string_unref(item->name);
+        item->name = binding->o_name;
+    }
+
+    if (binding->default_value == true) {
+        if (item->default_value != NULL)
+            cl_object_unref(item->default_value);
+
+        item->default_value = binding->o_default_value;
+    }
+
+    if (binding->options == true) {
+        if (item->options != NULL)
+            cl_string_unref(item->options);
+
+        if (item->list_items != NULL)
+            cl_stringlist_destroy(item->list_items);
+
+        if (item->options_index != NULL)
+            option_index_unref(item->options_index);
+
+        item->options = binding->o_options;
+        item->list_items = binding->o_list_items;
+        item->options_index = binding->o_options_index;
+    }
+
+end_block:
+    free(binding);
+}
+
+/*
+ * Replaces the title, the default value and the options of a template
+ * object with the ones of the current run.
+ */
+static int bind(struct xante_jts *jts, const struct jts_arguments *args)
+{
+    struct jts_binding *binding = NULL;
+    struct xante_item *item = jts->object;
+    cl_string_t *value = NULL;
+
+    binding = calloc(1, sizeof(struct jts_binding));
+
+    if (NULL == binding) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return -1;
+    }
+
+    jts->binding = binding;
+
+    /* A menu template may only have its title changed */
+    if (NULL == item) {
+        if (args->title != NULL) {
+            binding->menu = xante_menu_head(jts->menus);
+
+            if (binding->menu != NULL) {
+                binding->o_name = binding->menu->name;
+                binding->menu->name = cl_string_create("%s", args->title);
+            }
+        }
+
+        return 0;
+    }
+
+    binding->item = item;
+
+    if (args->title != NULL) {
+        binding->title = true;
+        binding->o_name = item->name;
+        item->name = cl_string_create("%s", args->title);
+    }
+
+    if (args->default_value != NULL) {
+        binding->default_value = true;
+        binding->o_default_value = item->default_value;
+        value = cl_string_create("%s", args->default_value);
+        item->default_value = cl_object_from_cstring(value);
+        cl_string_unref(value);
+    }
+
+    if (args->options != NULL)
+        return bind_options(item, binding, args->options, args->total_options);
+
+    return 0;
+}
+
 /*
  *
  * Internal API
@@ -140,3 +542,300 @@ void jts_unload(struct xante_jts *jts)
     free(jts);
 }
 
+/**
+ * @name jts_cache_init
+ * @brief Prepares the cache of parsed JTS of an application.
+ *
+ * @param [in,out] xpp: The library main object.
+ *
+ * @return On success returns 0 or -1 otherwise.
+ */
+int jts_cache_init(struct xante_app *xpp)
+{
+    struct jts_cache *cache = NULL;
+
+    cache = calloc(1, sizeof(struct jts_cache));
+
+    if (NULL == cache) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return -1;
+    }
+
+    pthread_mutex_init(&cache->lock, NULL);
+    xpp->jts_cache = cache;
+
+    return 0;
+}
+
+/**
+ * @name jts_cache_uninit
+ * @brief Releases every parsed JTS kept by an application.
+ *
+ * @param [in,out] xpp: The library main object.
+ */
+void jts_cache_uninit(struct xante_app *xpp)
+{
+    struct jts_cache *cache = xpp->jts_cache;
+    int i;
+
+    if (NULL == cache)
+        return;
+
+    for (i = 0; i < JTS_CACHE_MAX_ENTRIES; i++)
+        release_entry(&cache->entries[i]);
+
+    for (i = 0; i < cache->total_templates; i++)
+        release_template(&cache->templates[i]);
+
+    if (cache->templates != NULL)
+        free(cache->templates);
+
+    pthread_mutex_destroy(&cache->lock);
+    free(cache);
+    xpp->jts_cache = NULL;
+}
+
+/**
+ * @name jts_cache_get
+ * @brief Gives a parsed JTS, reusing a previous one with the same content.
+ *
+ * The returned object must be given back with jts_cache_put.
+ *
+ * @param [in,out] xpp: The library main object.
+ * @param [in] jts: The JTS in a string format.
+ *
+ * @return On success returns the parsed JTS or NULL otherwise.
+ */
+struct xante_jts *jts_cache_get(struct xante_app *xpp, const char *jts)
+{
+    struct jts_cache *cache = xpp->jts_cache;
+    struct jts_cache_entry *entry = NULL;
+    struct xante_jts *m = NULL;
+    size_t length;
+    uint64_t hash;
+
+    if (NULL == cache)
+        return jts_load(jts);
+
+    length = strlen(jts);
+    hash = content_hash(jts, length);
+    pthread_mutex_lock(&cache->lock);
+    entry = cache_lookup(cache, hash, jts, length);
+
+    if ((entry != NULL) && (entry->in_use == false)) {
+        entry->in_use = true;
+        entry->last_use = ++cache->clock;
+        m = entry->jts;
+    }
+
+    pthread_mutex_unlock(&cache->lock);
+
+    if (m != NULL)
+        return m;
+
+    /*
+     * Already running (a module may run the same JTS from inside one of its
+     * events), so we give a private copy.
+     */
+    if (entry != NULL)
+        return jts_load(jts);
+
+    m = jts_load(jts);
+
+    if ((NULL == m) || (is_reusable(m) == false))
+        return m;
+
+    pthread_mutex_lock(&cache->lock);
+    entry = cache_victim(cache);
+
+    if (entry != NULL) {
+        entry->content = malloc(length + 1);
+
+        if (entry->content != NULL) {
+            memcpy(entry->content, jts, length + 1);
+            entry->hash = hash;
+            entry->length = length;
+            entry->jts = m;
+            entry->in_use = true;
+            entry->last_use = ++cache->clock;
+            m->cached = true;
+        }
+    }
+
+    pthread_mutex_unlock(&cache->lock);
+
+    return m;
+}
+
+/**
+ * @name jts_cache_put
+ * @brief Gives back a JTS obtained with jts_cache_get.
+ *
+ * A cached JTS has its items restored to their default values, so the next
+ * run looks exactly as a freshly parsed one.
+ *
+ * @param [in,out] xpp: The library main object.
+ * @param [in] jts: The parsed JTS.
+ */
+void jts_cache_put(struct xante_app *xpp, struct xante_jts *jts)
+{
+    struct jts_cache *cache = xpp->jts_cache;
+    int i;
+
+    if (NULL == jts)
+        return;
+
+    if (jts->binding != NULL) {
+        unbind(jts->binding);
+        jts->binding = NULL;
+    }
+
+    if ((NULL == cache) || (jts->cached == false)) {
+        jts_unload(jts);
+        return;
+    }
+
+    reset_jts(jts);
+    pthread_mutex_lock(&cache->lock);
+
+    for (i = 0; i < JTS_CACHE_MAX_ENTRIES; i++)
+        if (cache->entries[i].jts == jts)
+            cache->entries[i].in_use = false;
+
+    for (i = 0; i < cache->total_templates; i++)
+        if (cache->templates[i].jts == jts)
+            cache->templates[i].in_use = false;
+
+    pthread_mutex_unlock(&cache->lock);
+}
+
+/**
+ * @name jts_template_register
+ * @brief Parses a JTS once to be run later, through its name, with
+ *        different arguments.
+ *
+ * Registering a name again replaces its previous JTS.
+ *
+ * @param [in,out] xpp: The library main object.
+ * @param [in] name: The template name.
+ * @param [in] jts: The JTS in a string format.
+ *
+ * @return On success returns 0 or -1 otherwise.
+ */
+int jts_template_register(struct xante_app *xpp, const char *name,
+    const char *jts)
+{
+    struct jts_cache *cache = xpp->jts_cache;
+    struct jts_template *template = NULL, *tmp = NULL;
+    struct xante_jts *m = NULL;
+    int ret = -1;
+
+    m = jts_load(jts);
+
+    if (NULL == m)
+        return -1;
+
+    m->cached = true;
+    pthread_mutex_lock(&cache->lock);
+    template = template_lookup(cache, name);
+
+    if (template != NULL) {
+        if (template->in_use == true) {
+            errno_set(XANTE_ERROR_INVALID_ARG);
+            goto end_block;
+        }
+
+        release_template(template);
+    } else {
+        tmp = realloc(cache->templates, sizeof(struct jts_template) *
+                                            (cache->total_templates + 1));
+
+        if (NULL == tmp) {
+            errno_set(XANTE_ERROR_NO_MEMORY);
+            goto end_block;
+        }
+
+        cache->templates = tmp;
+        template = &cache->templates[cache->total_templates++];
+    }
+
+    template->name = strdup(name);
+    template->content = strdup(jts);
+    template->jts = m;
+    template->in_use = false;
+    m = NULL;
+    ret = 0;
+
+end_block:
+    pthread_mutex_unlock(&cache->lock);
+
+    if (m != NULL) {
+        m->cached = false;
+        jts_unload(m);
+    }
+
+    return ret;
+}
+
+/**
+ * @name jts_template_get
+ * @brief Gives a registered JTS, bound to the arguments of a run.
+ *
+ * The returned object must be given back with jts_cache_put, which also
+ * restores what was replaced by the arguments.
+ *
+ * @param [in,out] xpp: The library main object.
+ * @param [in] name: The template name.
+ * @param [in] args: The run arguments.
+ *
+ * @return On success returns the parsed JTS or NULL otherwise.
+ */
+struct xante_jts *jts_template_get(struct xante_app *xpp, const char *name,
+    const struct jts_arguments *args)
+{
+    struct jts_cache *cache = xpp->jts_cache;
+    struct jts_template *template = NULL;
+    struct xante_jts *m = NULL;
+    char *content = NULL;
+
+    pthread_mutex_lock(&cache->lock);
+    template = template_lookup(cache, name);
+
+    if (template != NULL) {
+        if (template->in_use == false) {
+            template->in_use = true;
+            m = template->jts;
+        } else
+            content = strdup(template->content);
+    }
+
+    pthread_mutex_unlock(&cache->lock);
+
+    if (NULL == template) {
+        errno_set(XANTE_ERROR_INVALID_ARG);
+        errno_store_additional_content(name);
+        return NULL;
+    }
+
+    /* Already running, so we parse a private copy of it */
+    if (NULL == m) {
+        if (NULL == content) {
+            errno_set(XANTE_ERROR_NO_MEMORY);
+            return NULL;
+        }
+
+        m = jts_load(content);
+        free(content);
+
+        if (NULL == m)
+            return NULL;
+    }
+
+    if (bind(m, args) < 0) {
+        jts_cache_put(xpp, m);
+        return NULL;
+    }
+
+    return m;
+}
+
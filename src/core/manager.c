@@ -81,6 +81,40 @@ static int ui_single_run(struct xante_app *xpp, struct xante_jts *jts)
     return ret_dialog;
 }
 
+/*
+ * Runs a JTS object, initializing the UI if we're not inside a running
+ * application.
+ */
+static enum xante_return_value run_jts(struct xante_app *xpp,
+    struct xante_jts *jts)
+{
+    enum xante_return_value exit_status = XANTE_RETURN_OK;
+    int ret_dialog = DLG_EXIT_CANCEL;
+    bool close_libdialog = false;
+
+    if (xante_runtime_ui_active(xpp) == false) {
+        ui_init(xpp);
+        close_libdialog = true;
+    }
+
+    ret_dialog = ui_single_run(xpp, jts);
+
+#ifdef ALTERNATIVE_DIALOG
+    exit_status = (ret_dialog == DLG_EXIT_TIMEOUT) ? XANTE_RETURN_TIMEOUT
+                                                   : ((ret_dialog == DLG_EXIT_OK)
+                                                        ? XANTE_RETURN_OK
+                                                        : XANTE_RETURN_ERROR);
+#else
+    exit_status = (ret_dialog == DLG_EXIT_OK) ? XANTE_RETURN_OK
+                                              : XANTE_RETURN_ERROR;
+#endif
+
+    if (close_libdialog == true)
+        ui_uninit(xpp);
+
+    return exit_status;
+}
+
 static int check_item_availability(cl_list_node_t *node, void *a)
 {
     struct xante_item *item = cl_list_node_content(node);
@@ -138,7 +172,7 @@ static int check_item_width(cl_list_node_t *node, void *a)
     struct xante_item *item = cl_list_node_content(node);
     struct list_data *ld = (struct list_data *)a;
     int length = 0;
-    char *s = NULL;
+    const char *s = NULL;
 
     if (is_item_available(item) == false)
         return 0;
@@ -150,13 +184,12 @@ static int check_item_width(cl_list_node_t *node, void *a)
 
     /* We only check items that may have values */
     if (item_may_have_value(item) == true) {
-        s = dlgx_get_item_value_as_text(item);
+        s = item_display_value(item);
 
         if (NULL == s)
             return 0;
 
         length = strlen(s);
-        free(s);
 
         if (length > ld->item_size)
             ld->item_size = length;
@@ -173,7 +206,9 @@ static int calc_menu_width(const struct xante_menu *menu)
         .item_size = 0,
     };
 
+    item_display_lock();
     cl_list_map(menu->items, check_item_width, &ld);
+    item_display_unlock();
     w = (ld.name_size + ld.item_size) + WINDOW_BORDER_SIZE;
     menu_width = (menu->geometry.width == 0) ? DEFAULT_DIALOG_WIDTH
                                              : menu->geometry.width;
@@ -187,25 +222,18 @@ static int calc_menu_width(const struct xante_menu *menu)
 static int add_item_content(unsigned int index, cl_list_node_t *node, void *a)
 {
     struct xante_item *item = cl_list_node_content(node);
-    DIALOG_LISTITEM *litems = (DIALOG_LISTITEM *)a;
+    session_t *session = (session_t *)a;
     DIALOG_LISTITEM *listitem = NULL;
-    char *value = NULL;
 
     /* Ignore this item (and the index does not get incremented) */
     if (is_item_available(item) == false)
         return 1;
 
     /* Fills litems[index] with item content */
-    listitem = &litems[index];
-    value = dlgx_get_item_value_as_text(item);
-
-    if (NULL == value)
-        listitem->text = strdup("");
-    else
-        listitem->text = value;
-
-    listitem->name = strdup(cl_string_valueof(item->name));
-    listitem->help = strdup("");
+    listitem = &session->litems[index];
+    listitem->text = session_strdup(session, item_display_value(item));
+    listitem->name = session_strdup(session, cl_string_valueof(item->name));
+    listitem->help = session_strdup(session, "");
     listitem->state = 0;
 
     return 0;
@@ -214,15 +242,17 @@ static int add_item_content(unsigned int index, cl_list_node_t *node, void *a)
 static int prepare_content(const struct xante_menu *menu,
     session_t *session)
 {
-    session->litems = calloc(session->number_of_items,
-                             sizeof(DIALOG_LISTITEM));
+    session->litems = session_alloc(session, session->number_of_items *
+                                             sizeof(DIALOG_LISTITEM));
 
     if (NULL == session->litems) {
         errno_set(XANTE_ERROR_NO_MEMORY);
         return -1;
     }
 
-    cl_list_map_indexed(menu->items, add_item_content, session->litems);
+    item_display_lock();
+    cl_list_map_indexed(menu->items, add_item_content, session);
+    item_display_unlock();
 
     return 0;
 }
@@ -291,6 +321,13 @@ static widget_result_t call_menu_object(struct xante_app *xpp,
         xante_menu_search_by_object_id(menus,
                                        cl_string_valueof(selected_item->referenced_menu));
 
+    /* Dynamic menu copies are kept apart from the main list */
+    if (NULL == referenced_menu) {
+        referenced_menu =
+            dm_search_menu_by_object_id(xpp,
+                                        cl_string_valueof(selected_item->referenced_menu));
+    }
+
     if (NULL == referenced_menu) {
         xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
                              cl_tr("No menu '%s' was found!"),
@@ -299,6 +336,9 @@ static widget_result_t call_menu_object(struct xante_app *xpp,
         return ret;
     }
 
+    /* A dynamic menu copy gets its items when it's entered */
+    dm_materialize(xpp, referenced_menu);
+
     btn_cancel_label = strdup(cl_tr("Back"));
     manager_run(xpp, menus, referenced_menu, btn_cancel_label);
     free(btn_cancel_label);
@@ -491,7 +531,7 @@ static widget_result_t run_selected_object(session_t *session)
                 break;
 
             case DLG_EXIT_EXTRA:
-                if (item->button.extra == true)
+                if (item->details->button.extra == true)
                     event_call(EV_EXTRA_BUTTON_PRESSED, xpp, item);
 
                 break;
@@ -723,6 +763,9 @@ void ui_data_init(struct xante_app *xpp)
         return;
 
     xpp->ui.menus = cl_list_create(xante_menu_destroy, NULL, NULL, NULL);
+    xpp->ui.arena = arena_create(0);
+    xpp->ui.strings = intern_create();
+    xpp->ui.session_arena = arena_create(0);
 }
 
 /**
@@ -743,6 +786,14 @@ void ui_data_uninit(struct xante_app *xpp)
         cl_list_destroy(xpp->ui.menus);
 
     dm_uninit(xpp);
+
+    /* Every menu and item loaded from the JTF goes away at once */
+    arena_destroy(xpp->ui.arena);
+    xpp->ui.arena = NULL;
+    intern_destroy(xpp->ui.strings);
+    xpp->ui.strings = NULL;
+    arena_destroy(xpp->ui.session_arena);
+    xpp->ui.session_arena = NULL;
 }
 
 // DEBUG
@@ -772,6 +823,7 @@ static int print_menu(cl_list_node_t *node, void *a __attribute__((unused)))
 void ui_print_menu_tree(struct xante_app *xpp)
 {
     cl_list_map(xpp->ui.menus, print_menu, NULL);
+    dm_map_menus(xpp, print_menu, NULL);
 }
 
 /*
@@ -834,9 +886,7 @@ end_block:
 __PUB_API__ enum xante_return_value xante_manager_single_run(xante_t *xpp,
     const char *raw_si)
 {
-    enum xante_return_value exit_status = XANTE_RETURN_OK;
-    int ret_dialog = DLG_EXIT_CANCEL;
-    bool close_libdialog = false;
+    enum xante_return_value exit_status;
     struct xante_jts *jts = NULL;
 
     errno_clear();
@@ -846,37 +896,85 @@ __PUB_API__ enum xante_return_value xante_manager_single_run(xante_t *xpp,
         return XANTE_RETURN_ERROR;
     }
 
-    jts = jts_load(raw_si);
+    jts = jts_cache_get(xpp, raw_si);
 
     if (NULL == jts)
         return XANTE_RETURN_ERROR;
 
-    if (xante_runtime_ui_active(xpp) == false) {
-        ui_init(xpp);
-        close_libdialog = true;
+    exit_status = run_jts(xpp, jts);
+    jts_cache_put(xpp, jts);
+
+    return exit_status;
+}
+
+__PUB_API__ int xante_manager_register_template(xante_t *xpp,
+    const char *name, const char *jts)
+{
+    errno_clear();
+
+    if ((NULL == xpp) || (NULL == name) || (NULL == jts)) {
+        errno_set(XANTE_ERROR_NULL_ARG);
+        return -1;
     }
 
-    ret_dialog = ui_single_run(xpp, jts);
+    return jts_template_register(xpp, name, jts);
+}
 
-    if (jts != NULL)
-        jts_unload(jts);
+__PUB_API__ enum xante_return_value xante_manager_run_template(xante_t *xpp,
+    const char *name, const char *title, const char *default_value,
+    const char * const *options, int total_options)
+{
+    enum xante_return_value exit_status;
+    struct xante_jts *jts = NULL;
+    struct jts_arguments args = {
+        .title = title,
+        .default_value = default_value,
+        .options = options,
+        .total_options = (options != NULL) ? total_options : 0,
+    };
 
-#ifdef ALTERNATIVE_DIALOG
-    exit_status = (ret_dialog == DLG_EXIT_TIMEOUT) ? XANTE_RETURN_TIMEOUT
-                                                   : ((ret_dialog == DLG_EXIT_OK)
-                                                        ? XANTE_RETURN_OK
-                                                        : XANTE_RETURN_ERROR);
-#else
-    exit_status = (ret_dialog == DLG_EXIT_OK) ? XANTE_RETURN_OK
-                                              : XANTE_RETURN_ERROR;
-#endif
+    errno_clear();
 
-    if (close_libdialog == true)
-        ui_uninit(xpp);
+    if ((NULL == xpp) || (NULL == name)) {
+        errno_set(XANTE_ERROR_NULL_ARG);
+        return XANTE_RETURN_ERROR;
+    }
+
+    jts = jts_template_get(xpp, name, &args);
+
+    if (NULL == jts)
+        return XANTE_RETURN_ERROR;
+
+    exit_status = run_jts(xpp, jts);
+    jts_cache_put(xpp, jts);
 
     return exit_status;
 }
 
+__PUB_API__ enum xante_return_value xante_manager_apply(xante_t *xpp,
+    const char *changes)
+{
+    errno_clear();
+
+    if ((NULL == xpp) || (NULL == changes)) {
+        errno_set(XANTE_ERROR_NULL_ARG);
+        return XANTE_RETURN_ERROR;
+    }
+
+    /* Nothing was changed, but the settings are done with anyway */
+    if (apply_changes(xpp, changes) < 0) {
+        config_release(xpp);
+        return XANTE_RETURN_ERROR;
+    }
+
+    runtime_set_exit_value(xpp, XANTE_RETURN_OK);
+
+    if (config_write_changes(xpp) < 0)
+        return XANTE_RETURN_ERROR;
+
+    return xante_runtime_exit_value(xpp);
+}
+
 __PUB_API__ void xante_ui_suspend(void)
 {
     // TODO
@@ -64,10 +64,15 @@ static void __xante_menu_destroy(const struct cl_ref_s *ref)
     if (menu->dynamic_origin_item != NULL)
         cl_string_unref(menu->dynamic_origin_item);
 
+    if (menu->dynamic_template != NULL)
+        xante_menu_unref(menu->dynamic_template);
+
     if (menu->events != NULL)
         cl_json_delete(menu->events);
 
-    free(menu);
+    /* Menus from the JTF are released along with their arena */
+    if (menu->from_arena == false)
+        free(menu);
 }
 
 static int __search_menu_by_object_id(cl_list_node_t *node, void *a)
@@ -160,20 +165,27 @@ void xante_menu_unref(struct xante_menu *menu)
  * @param [in] creator: An information to say who is creating the menu, it may
  *                      be created when loaded from a JTF file or created when
  *                      a dynamic menu is requested.
+ * @param [in,out] arena: An optional arena where the menu will be allocated.
+ *                        Its memory is only released with the arena.
  *
  * @return On success returns a xante_menu structure or NULL otherwise.
  */
-struct xante_menu *xante_menu_create(enum xante_menu_creator creator)
+struct xante_menu *xante_menu_create(enum xante_menu_creator creator,
+    struct arena *arena)
 {
     struct xante_menu *menu = NULL;
 
-    menu = calloc(1, sizeof(struct xante_menu));
+    if (arena != NULL)
+        menu = arena_alloc(arena, sizeof(struct xante_menu));
+    else
+        menu = calloc(1, sizeof(struct xante_menu));
 
     if (NULL == menu) {
         errno_set(XANTE_ERROR_NO_MEMORY);
         return NULL;
     }
 
+    menu->from_arena = (arena != NULL);
     menu->creator = creator;
     menu->move_to_be_released = false;
     menu->copies = -1;
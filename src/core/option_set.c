@@ -0,0 +1,498 @@
+
+/*
+ * Description: Interned options of an item and ordered sets of them.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 12:24:09 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include "libxante.h"
+
+/* The minimum number of slots of the options hash table */
+#define OPTION_INDEX_MIN_SLOTS          16
+
+/* Options separator inside a saved set */
+#define OPTION_SET_SEPARATOR            ','
+
+/*
+ * Every option of an item gets an id, its position inside the JTF options
+ * array. Names are mapped to ids through an open addressing hash table, so
+ * they only need to be compared when loading a saved value. The index never
+ * changes after being loaded, so it can be shared between copies of an item.
+ */
+struct option_index {
+    int             total;
+    int             size;
+    cl_string_t     **names;
+    unsigned int    mask;
+    int             *slots;
+    struct cl_ref_s ref;
+};
+
+/*
+ * A set of option ids which keeps the order in which they were added. Since
+ * ids are dense, the position of each one inside the order is directly
+ * addressed.
+ */
+struct option_set {
+    int     capacity;
+    int     total;
+    int     *order;
+    int     *position;
+};
+
+/*
+ *
+ * Internal functions
+ *
+ */
+
+static unsigned int hash_name(const char *name, int length)
+{
+    unsigned int h = 2166136261u;
+    int i;
+
+    /* FNV-1a */
+    for (i = 0; i < length; i++) {
+        h ^= (unsigned char)name[i];
+        h *= 16777619u;
+    }
+
+    return h;
+}
+
+static bool name_equals(const cl_string_t *option, const char *name,
+    int length)
+{
+    return (cl_string_length(option) == length) &&
+           (memcmp(cl_string_valueof(option), name, length) == 0);
+}
+
+static void __destroy_option_index(const struct cl_ref_s *ref)
+{
+    struct option_index *index = cl_container_of(ref, struct option_index, ref);
+    int i;
+
+    if (NULL == index)
+        return;
+
+    for (i = 0; i < index->size; i++)
+        cl_string_unref(index->names[i]);
+
+    if (index->names != NULL)
+        free(index->names);
+
+    if (index->slots != NULL)
+        free(index->slots);
+
+    free(index);
+}
+
+/*
+ *
+ * Internal API
+ *
+ */
+
+/**
+ * @name option_index_create
+ * @brief Creates an empty index to hold the options of an item.
+ *
+ * @param [in] total: The number of options the index is going to hold.
+ *
+ * @return On success returns the new index or NULL otherwise.
+ */
+struct option_index *option_index_create(int total)
+{
+    struct option_index *index = NULL;
+    unsigned int slots = OPTION_INDEX_MIN_SLOTS, i;
+
+    index = calloc(1, sizeof(struct option_index));
+
+    if (NULL == index) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return NULL;
+    }
+
+    /* Keeps the table, at most, half full */
+    while (slots < (unsigned int)(2 * total))
+        slots <<= 1;
+
+    index->total = max(0, total);
+    index->mask = slots - 1;
+    index->names = calloc(max(1, index->total), sizeof(cl_string_t *));
+    index->slots = calloc(slots, sizeof(int));
+    index->ref.count = 1;
+    index->ref.free = __destroy_option_index;
+
+    if ((NULL == index->names) || (NULL == index->slots)) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        option_index_unref(index);
+        return NULL;
+    }
+
+    for (i = 0; i < slots; i++)
+        index->slots[i] = -1;
+
+    return index;
+}
+
+/**
+ * @name option_index_ref
+ * @brief Increases the reference count of an index.
+ *
+ * @param [in,out] index: The index.
+ *
+ * @return Returns the index itself.
+ */
+struct option_index *option_index_ref(struct option_index *index)
+{
+    if (NULL == index)
+        return NULL;
+
+    cl_ref_inc(&index->ref);
+
+    return index;
+}
+
+/**
+ * @name option_index_unref
+ * @brief Decreases the reference count of an index, releasing it when it
+ *        drops to 0.
+ *
+ * @param [in,out] index: The index.
+ */
+void option_index_unref(struct option_index *index)
+{
+    if (NULL == index)
+        return;
+
+    cl_ref_dec(&index->ref);
+}
+
+/**
+ * @name option_index_add
+ * @brief Adds the next option to an index.
+ *
+ * Repeated names get their own id, but looking them up always gives the
+ * first one.
+ *
+ * @param [in,out] index: The index.
+ * @param [in] name: The option name.
+ *
+ * @return On success returns the option id or -1 otherwise.
+ */
+int option_index_add(struct option_index *index, const cl_string_t *name)
+{
+    unsigned int slot;
+    int id, length;
+    const char *p;
+
+    if (index->size >= index->total) {
+        errno_set(XANTE_ERROR_INVALID_ARG);
+        return -1;
+    }
+
+    id = index->size++;
+    index->names[id] = cl_string_ref((cl_string_t *)name);
+    p = cl_string_valueof(name);
+    length = cl_string_length(name);
+    slot = hash_name(p, length) & index->mask;
+
+    while (index->slots[slot] >= 0) {
+        if (name_equals(index->names[index->slots[slot]], p, length))
+            return id;
+
+        slot = (slot + 1) & index->mask;
+    }
+
+    index->slots[slot] = id;
+
+    return id;
+}
+
+/**
+ * @name option_index_lookup
+ * @brief Gets the id of an option from its name.
+ *
+ * @param [in] index: The index.
+ * @param [in] name: The option name, which does not need to be terminated.
+ * @param [in] length: The option name length.
+ *
+ * @return Returns the option id or -1 if it's not an option of the index.
+ */
+int option_index_lookup(const struct option_index *index, const char *name,
+    int length)
+{
+    unsigned int slot;
+
+    if (NULL == index)
+        return -1;
+
+    slot = hash_name(name, length) & index->mask;
+
+    while (index->slots[slot] >= 0) {
+        if (name_equals(index->names[index->slots[slot]], name, length))
+            return index->slots[slot];
+
+        slot = (slot + 1) & index->mask;
+    }
+
+    return -1;
+}
+
+/**
+ * @name option_index_name
+ * @brief Gets the name of an option from its id.
+ *
+ * @param [in] index: The index.
+ * @param [in] id: The option id.
+ *
+ * @return Returns the option name or NULL if the id is invalid.
+ */
+const char *option_index_name(const struct option_index *index, int id)
+{
+    if ((NULL == index) || (id < 0) || (id >= index->size))
+        return NULL;
+
+    return cl_string_valueof(index->names[id]);
+}
+
+/**
+ * @name option_index_size
+ * @brief Gets the number of options of an index.
+ *
+ * @param [in] index: The index. It may be NULL, for an item without options.
+ *
+ * @return Returns the number of options.
+ */
+int option_index_size(const struct option_index *index)
+{
+    if (NULL == index)
+        return 0;
+
+    return index->size;
+}
+
+/**
+ * @name option_set_create
+ * @brief Creates an empty set of options.
+ *
+ * @param [in] total: The number of options which may be added to the set.
+ *
+ * @return On success returns the new set or NULL otherwise.
+ */
+struct option_set *option_set_create(int total)
+{
+    struct option_set *set = NULL;
+    int i;
+
+    set = calloc(1, sizeof(struct option_set));
+
+    if (NULL == set) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return NULL;
+    }
+
+    set->capacity = max(0, total);
+    set->order = calloc(max(1, set->capacity), sizeof(int));
+    set->position = calloc(max(1, set->capacity), sizeof(int));
+
+    if ((NULL == set->order) || (NULL == set->position)) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        option_set_destroy(set);
+        return NULL;
+    }
+
+    for (i = 0; i < set->capacity; i++)
+        set->position[i] = -1;
+
+    return set;
+}
+
+/**
+ * @name option_set_destroy
+ * @brief Releases a set of options.
+ *
+ * @param [in] set: The set.
+ */
+void option_set_destroy(struct option_set *set)
+{
+    if (NULL == set)
+        return;
+
+    if (set->order != NULL)
+        free(set->order);
+
+    if (set->position != NULL)
+        free(set->position);
+
+    free(set);
+}
+
+/**
+ * @name option_set_add
+ * @brief Appends an option to a set, if it's not already there.
+ *
+ * @param [in,out] set: The set.
+ * @param [in] id: The option id.
+ *
+ * @return Returns true if the option was added or false otherwise.
+ */
+bool option_set_add(struct option_set *set, int id)
+{
+    if ((id < 0) || (id >= set->capacity) || (set->position[id] >= 0))
+        return false;
+
+    set->position[id] = set->total;
+    set->order[set->total++] = id;
+
+    return true;
+}
+
+/**
+ * @name option_set_contains
+ * @brief Checks if an option is inside a set.
+ *
+ * @param [in] set: The set.
+ * @param [in] id: The option id.
+ *
+ * @return Returns true if the option is inside the set or false otherwise.
+ */
+bool option_set_contains(const struct option_set *set, int id)
+{
+    if ((id < 0) || (id >= set->capacity))
+        return false;
+
+    return set->position[id] >= 0;
+}
+
+/**
+ * @name option_set_size
+ * @brief Gets the number of options inside a set.
+ *
+ * @param [in] set: The set.
+ *
+ * @return Returns the number of options.
+ */
+int option_set_size(const struct option_set *set)
+{
+    return set->total;
+}
+
+/**
+ * @name option_set_equals
+ * @brief Checks if two sets hold the same options, in any order.
+ *
+ * @param [in] a: The first set.
+ * @param [in] b: The second set.
+ *
+ * @return Returns true if both sets hold the same options or false otherwise.
+ */
+bool option_set_equals(const struct option_set *a, const struct option_set *b)
+{
+    int i;
+
+    if (a->total != b->total)
+        return false;
+
+    for (i = 0; i < a->total; i++)
+        if (option_set_contains(b, a->order[i]) == false)
+            return false;
+
+    return true;
+}
+
+/**
+ * @name option_set_from_cstring
+ * @brief Loads a set from a string with option names separated by commas.
+ *
+ * Names which are not options of the \a index are discarded, and logged,
+ * since they may come from a config file written with older options.
+ *
+ * @param [in] index: The options index. It may be NULL, giving an empty set.
+ * @param [in] value: The saved set. It may be NULL.
+ *
+ * @return On success returns the loaded set or NULL otherwise.
+ */
+struct option_set *option_set_from_cstring(const struct option_index *index,
+    const cl_string_t *value)
+{
+    struct option_set *set = NULL;
+    const char *p, *end, *next;
+    int id;
+
+    set = option_set_create(option_index_size(index));
+
+    if ((NULL == set) || (NULL == value))
+        return set;
+
+    p = cl_string_valueof(value);
+    end = p + cl_string_length(value);
+
+    while (p < end) {
+        next = memchr(p, OPTION_SET_SEPARATOR, end - p);
+
+        if (NULL == next)
+            next = end;
+
+        id = option_index_lookup(index, p, next - p);
+
+        if (id >= 0)
+            option_set_add(set, id);
+        else if (next > p)
+            xante_log_warning(cl_tr("Discarding '%.*s', it's not an option "
+                                    "anymore"), (int)(next - p), p);
+
+        p = next + 1;
+    }
+
+    return set;
+}
+
+/**
+ * @name option_set_to_cstring
+ * @brief Gives the names of the options inside a set, separated by commas
+ *        and in the order they were added.
+ *
+ * @param [in] index: The options index.
+ * @param [in] set: The set.
+ *
+ * @return Returns a cl_string_t with the option names.
+ */
+cl_string_t *option_set_to_cstring(const struct option_index *index,
+    const struct option_set *set)
+{
+    cl_string_t *s = NULL;
+    int i;
+
+    s = cl_string_create_empty(0);
+
+    for (i = 0; i < set->total; i++)
+        cl_string_cat(s, "%s%c", option_index_name(index, set->order[i]),
+                      OPTION_SET_SEPARATOR);
+
+    if (cl_string_isempty(s) == false)
+        cl_string_truncate(s, -1);
+
+    return s;
+}
+
@@ -24,267 +24,244 @@
  * USA
  */
 
+#include <pthread.h>
+
 #include "libxante.h"
 
 struct widget_events {
-    enum xante_object   type;
     int                 (*run)(struct session *);
     bool                (*validate_result)(struct session *);
     bool                (*value_changed)(struct session *);
     void                (*update_value)(struct session *);
 };
 
-static struct widget_events __widget_events[] = {
-    {
-        .type = XANTE_WIDGET_UNKNOWN,
+/* The functions of every builtin object, indexed by its type */
+static const struct widget_events __widget_events[] = {
+    [XANTE_WIDGET_UNKNOWN] = {
         .run = NULL,
         .value_changed = NULL,
         .update_value = NULL,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_WIDGET_MENU_REFERENCE,
+    [XANTE_WIDGET_MENU_REFERENCE] = {
         .run = NULL,
         .value_changed = NULL,
         .update_value = NULL,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_WIDGET_INPUT_INT,
+    [XANTE_WIDGET_INPUT_INT] = {
         .run = input,
         .validate_result = input_validate_result,
         .value_changed = input_value_changed,
         .update_value = input_update_value,
     },
 
-    {
-        .type = XANTE_WIDGET_INPUT_FLOAT,
+    [XANTE_WIDGET_INPUT_FLOAT] = {
         .run = input,
         .value_changed = input_value_changed,
         .update_value = input_update_value,
         .validate_result = input_validate_result
     },
 
-    {
-        .type = XANTE_WIDGET_INPUT_DATE,
+    [XANTE_WIDGET_INPUT_DATE] = {
         .run = input,
         .value_changed = input_value_changed,
         .update_value = input_update_value,
         .validate_result = input_validate_result
     },
 
-    {
-        .type = XANTE_WIDGET_INPUT_STRING,
+    [XANTE_WIDGET_INPUT_STRING] = {
         .run = input,
         .value_changed = input_value_changed,
         .update_value = input_update_value,
         .validate_result = input_validate_result
     },
 
-    {
-        .type = XANTE_WIDGET_INPUT_PASSWD,
+    [XANTE_WIDGET_INPUT_PASSWD] = {
         .run = input,
         .value_changed = input_value_changed,
         .update_value = input_update_value,
         .validate_result = input_validate_result
     },
 
-    {
-        .type = XANTE_WIDGET_INPUT_TIME,
+    [XANTE_WIDGET_INPUT_TIME] = {
         .run = input,
         .value_changed = input_value_changed,
         .update_value = input_update_value,
         .validate_result = input_validate_result
     },
 
-    {
-        .type = XANTE_WIDGET_CALENDAR,
+    [XANTE_WIDGET_CALENDAR] = {
         .run = calendar,
         .value_changed = calendar_value_changed,
         .update_value = calendar_update_value,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_WIDGET_TIMEBOX,
+    [XANTE_WIDGET_TIMEBOX] = {
         .run = timebox,
         .value_changed = timebox_value_changed,
         .update_value = timebox_update_value,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_WIDGET_RADIO_CHECKLIST,
+    [XANTE_WIDGET_RADIO_CHECKLIST] = {
         .run = checklist,
         .value_changed = checklist_value_changed,
         .update_value = checklist_update_value,
         .validate_result = checklist_validate_result
     },
 
-    {
-        .type = XANTE_WIDGET_CHECKLIST,
+    [XANTE_WIDGET_CHECKLIST] = {
         .run = checklist,
         .value_changed = checklist_value_changed,
         .update_value = checklist_update_value,
         .validate_result = checklist_validate_result
     },
 
-    {
-        .type = XANTE_WIDGET_YES_NO,
+    [XANTE_WIDGET_YES_NO] = {
         .run = yesno,
         .value_changed = yesno_value_changed,
         .update_value = yesno_update_value,
         .validate_result = yesno_validate_result
     },
 
-    {
-        .type = XANTE_WIDGET_DYNAMIC_MENU_REFERENCE,
+    [XANTE_WIDGET_DYNAMIC_MENU_REFERENCE] = {
         .run = NULL,
         .value_changed = NULL,
         .update_value = NULL,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_WIDGET_DELETE_DYNAMIC_MENU_ITEM,
+    [XANTE_WIDGET_DELETE_DYNAMIC_MENU_ITEM] = {
         .run = delete_dm,
         .value_changed = delete_dm_value_changed,
         .update_value = NULL,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_WIDGET_ADD_DYNAMIC_MENU_ITEM,
+    [XANTE_WIDGET_ADD_DYNAMIC_MENU_ITEM] = {
         .run = add_dm,
         .value_changed = add_dm_value_changed,
         .update_value = NULL,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_WIDGET_CUSTOM,
+    [XANTE_WIDGET_CUSTOM] = {
         .run = NULL,
         .value_changed = NULL,
         .update_value = NULL,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_WIDGET_PROGRESS,
+    [XANTE_WIDGET_PROGRESS] = {
         .run = progress,
         .value_changed = NULL,
         .update_value = NULL,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_WIDGET_SPINNER_SYNC,
+    [XANTE_WIDGET_SPINNER_SYNC] = {
         .run = sync_object,
         .value_changed = NULL,
         .update_value = NULL,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_WIDGET_DOTS_SYNC,
+    [XANTE_WIDGET_DOTS_SYNC] = {
         .run = sync_object,
         .value_changed = NULL,
         .update_value = NULL,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_WIDGET_RANGE,
+    [XANTE_WIDGET_RANGE] = {
         .run = input,
         .value_changed = input_value_changed,
         .update_value = input_update_value,
         .validate_result = input_validate_result
     },
 
-    {
-        .type = XANTE_WIDGET_FILE_SELECT,
+    [XANTE_WIDGET_FILE_SELECT] = {
         .run = fselect,
         .value_changed = fselect_value_changed,
         .update_value = fselect_update_value,
         .validate_result = fselect_validate_result
     },
 
-    {
-        .type = XANTE_WIDGET_DIR_SELECT,
+    [XANTE_WIDGET_DIR_SELECT] = {
         .run = fselect,
         .value_changed = fselect_value_changed,
         .update_value = fselect_update_value,
         .validate_result = fselect_validate_result
     },
 
-    {
-        .type = XANTE_WIDGET_FILE_VIEW,
+    [XANTE_WIDGET_FILE_VIEW] = {
         .run = file_view,
         .value_changed = NULL,
         .update_value = NULL,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_WIDGET_TAILBOX,
+    [XANTE_WIDGET_TAILBOX] = {
         .run = tailbox,
         .value_changed = NULL,
         .update_value = NULL,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_WIDGET_SCROLLTEXT,
+    [XANTE_WIDGET_SCROLLTEXT] = {
         .run = scrolltext,
         .value_changed = NULL,
         .update_value = NULL,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_WIDGET_UPDATE_OBJECT,
+    [XANTE_WIDGET_UPDATE_OBJECT] = {
         .run = update_object,
         .value_changed = NULL,
         .update_value = NULL,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_WIDGET_INPUTSCROLL,
+    [XANTE_WIDGET_INPUTSCROLL] = {
         .run = input,
         .value_changed = input_value_changed,
         .update_value = input_update_value,
         .validate_result = input_validate_result
     },
 
-    {
-        .type = XANTE_WIDGET_MIXEDFORM,
+    [XANTE_WIDGET_MIXEDFORM] = {
         .run = mixedform,
         .value_changed = mixedform_value_changed,
         .update_value = NULL,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_WIDGET_BUILDLIST,
+    [XANTE_WIDGET_BUILDLIST] = {
         .run = buildlist,
         .value_changed = buildlist_value_changed,
         .update_value = NULL,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_WIDGET_SPREADSHEET,
+    [XANTE_WIDGET_SPREADSHEET] = {
         .run = spreadsheet,
         .value_changed = spreadsheet_value_changed,
         .update_value = NULL,
         .validate_result = NULL
     },
 
-    {
-        .type = XANTE_GADGET_CLOCK,
+    [XANTE_WIDGET_MULTI_PROGRESS] = {
+        .run = multi_progress,
+        .value_changed = NULL,
+        .update_value = NULL,
+        .validate_result = NULL
+    },
+
+    [XANTE_GADGET_CLOCK] = {
         .run = gadget_clock,
         .value_changed = NULL,
         .update_value = NULL,
@@ -293,7 +270,33 @@ static struct widget_events __widget_events[] = {
 };
 
 #define MAX_UI_DIALOG       \
-    (sizeof(__widget_events) / sizeof(__widget_events[0]))
+    (int)(sizeof(__widget_events) / sizeof(__widget_events[0]))
+
+/* Fails to build if an object type was left out of __widget_events */
+typedef char __widget_events_check[(MAX_UI_DIALOG == XANTE_GADGET_CLOCK + 1)
+                                   ? 1 : -1];
+
+/* The maximum number of widgets registered at runtime */
+#define MAX_REGISTERED_WIDGETS          32
+
+/*
+ * A widget type registered by the application or one of its modules. Its
+ * object type is placed right after the builtin ones. A slot whose widget
+ * was unregistered has no name and is reused by the next registration, so
+ * the object types of the others never change.
+ */
+struct registered_widget {
+    char                        *name;
+    size_t                      length;
+    struct xante_widget_ops     ops;
+    void                        *data;
+    const void                  *owner;     /* The module registering it */
+};
+
+static struct registered_widget __registered_widgets[MAX_REGISTERED_WIDGETS];
+static int __total_registered_widgets = 0;
+static const void *__registering_owner = NULL;
+static pthread_mutex_t __registered_lock = PTHREAD_MUTEX_INITIALIZER;
 
 /*
  *
@@ -301,15 +304,124 @@ static struct widget_events __widget_events[] = {
  *
  */
 
-static struct widget_events *get_function_events(enum xante_object type)
+static struct registered_widget *get_registered_widget(enum xante_object type)
 {
-    unsigned int i;
+    struct registered_widget *widget = NULL;
 
-    for (i = 0; i < MAX_UI_DIALOG; i++)
-        if (__widget_events[i].type == type)
-            return &__widget_events[i];
+    pthread_mutex_lock(&__registered_lock);
 
-    return NULL;
+    if (((int)type >= MAX_UI_DIALOG) &&
+        ((int)type < MAX_UI_DIALOG + __total_registered_widgets) &&
+        (__registered_widgets[type - MAX_UI_DIALOG].name != NULL))
+    {
+        widget = &__registered_widgets[type - MAX_UI_DIALOG];
+    }
+
+    pthread_mutex_unlock(&__registered_lock);
+
+    return widget;
+}
+
+static int find_registered_widget(const char *name, size_t length)
+{
+    int i;
+
+    for (i = 0; i < __total_registered_widgets; i++)
+        if ((__registered_widgets[i].name != NULL) &&
+            (__registered_widgets[i].length == length) &&
+            (memcmp(__registered_widgets[i].name, name, length) == 0))
+        {
+            return i;
+        }
+
+    return -1;
+}
+
+/* Must be called with the registry lock held */
+static void release_registered_widget(struct registered_widget *widget)
+{
+    free(widget->name);
+    memset(widget, 0, sizeof(struct registered_widget));
+}
+
+static int registered_run(session_t *session)
+{
+    struct registered_widget *widget = NULL;
+
+    widget = get_registered_widget(session->item->widget_type);
+
+    return (widget->ops.run)(session->xpp, session->item, &session->result,
+                             widget->data);
+}
+
+static bool registered_validate_result(session_t *session)
+{
+    struct registered_widget *widget = NULL;
+
+    widget = get_registered_widget(session->item->widget_type);
+
+    if (NULL == widget->ops.validate)
+        return true;
+
+    return (widget->ops.validate)(session->xpp, session->item,
+                                  session->result, widget->data);
+}
+
+static bool registered_value_changed(session_t *session)
+{
+    struct xante_item *item = session->item;
+    bool changed = false;
+    cl_string_t *str_value = NULL;
+
+    /* The widget may have nothing to store */
+    if (NULL == session->result)
+        return false;
+
+    str_value = cl_object_to_cstring(item_value(item));
+
+    /* An item without a value is compared (and logged) as an empty one */
+    if (NULL == str_value)
+        str_value = cl_string_create_empty(0);
+
+    if (cl_string_cmp(str_value, session->result) != 0) {
+        changed = true;
+
+        /* Set up details to save inside the internal changes list */
+        session->change_item_name = cl_string_ref(item->name);
+        session->change_old_value = cl_string_ref(str_value);
+        session->change_new_value = cl_string_ref(session->result);
+    }
+
+    if (str_value != NULL)
+        cl_string_unref(str_value);
+
+    return changed;
+}
+
+static void registered_update_value(session_t *session)
+{
+    item_set_value(session->item, cl_object_from_cstring(session->result));
+}
+
+static void set_session_events(session_t *session, enum xante_object type)
+{
+    const struct widget_events *ptr = NULL;
+
+    if (((int)type > XANTE_WIDGET_UNKNOWN) && ((int)type < MAX_UI_DIALOG)) {
+        ptr = &__widget_events[type];
+        session->run = ptr->run;
+        session->validate_result = ptr->validate_result;
+        session->value_changed = ptr->value_changed;
+        session->update_value = ptr->update_value;
+        return;
+    }
+
+    if (get_registered_widget(type) != NULL) {
+        session->run = registered_run;
+        session->validate_result = registered_validate_result;
+        session->value_changed = registered_value_changed;
+        session->update_value = registered_update_value;
+    }
 }
 
 /*
@@ -333,8 +445,6 @@ static struct widget_events *get_function_events(enum xante_object type)
 void session_init(struct xante_app *xpp, struct xante_item *item,
     session_t *session)
 {
-    struct widget_events *ptr = NULL;
-
     memset(session, 0, sizeof(session_t));
 
     session->result = NULL;
@@ -362,12 +472,14 @@ void session_init(struct xante_app *xpp, struct xante_item *item,
         else
             session->editable_value = true;
 
-        ptr = get_function_events(item->widget_type);
+        /*
+         * Widgets registered by a module are only known after the JTF was
+         * loaded, so their items are resolved on the first time they run.
+         */
+        if ((item->widget_type == XANTE_WIDGET_UNKNOWN) && (item->type != NULL))
+            item->widget_type = translate_string_widget_type(item->type);
 
-        if (ptr != NULL) {
-            session->run = ptr->run;
-            session->validate_result = ptr->validate_result;
-        }
+        set_session_events(session, item->widget_type);
     }
 }
 
@@ -376,39 +488,29 @@ void session_init(struct xante_app *xpp, struct xante_item *item,
  * @brief Clears the session of a selected item.
  *
  * Clears all session releasing all previously allocated memory for the items'
- * property
+ * property. The memory taken from the dialogs arena is given back to it, to
+ * be reused by the next session.
  *
  * @param [in,out] session: The session of the item.
  */
 void session_uninit(session_t *session)
 {
     int i;
-    DIALOG_LISTITEM *item = NULL;
-    DIALOG_FORMITEM *fitem = NULL;
 
     if (session->scroll_content != NULL)
         free(session->scroll_content);
 
-    if (session->litems != NULL) {
-        for (i = 0; i < session->number_of_items; i++) {
-            item = &session->litems[i];
-            free(item->text);
-            free(item->name);
-            free(item->help);
-        }
-
-        free(session->litems);
-    }
-
-    if (session->fitems != NULL) {
-        for (i = 0; i < session->number_of_items; i++) {
-            fitem = &session->fitems[i];
-            free(fitem->name);
-            free(fitem->text);
-        }
+    /*
+     * Form items texts may be replaced by libdialog while the user edits
+     * them, so they are the only ones not coming from the dialogs arena.
+     */
+    if (session->fitems != NULL)
+        for (i = 0; i < session->number_of_items; i++)
+            free(session->fitems[i].text);
 
-        free(session->fitems);
-    }
+    /* litems, fitems and their strings go away at once */
+    if (session->arena_in_use == true)
+        arena_rewind(session->xpp->ui.session_arena, session->arena_position);
 
     if (session->text != NULL)
         cl_string_unref(session->text);
@@ -438,3 +540,238 @@ void session_uninit(session_t *session)
         spreadsheet_st_destroy(session->sheet);
 }
 
+
+/**
+ * @name session_registered_widget_type
+ * @brief Gives the object type of a widget registered at runtime.
+ *
+ * @param [in] name: The widget type name, as used inside a JTF.
+ * @param [in] length: The name length.
+ *
+ * @return Returns the object type of the widget or XANTE_WIDGET_UNKNOWN if
+ *         no widget was registered with this name.
+ */
+enum xante_object session_registered_widget_type(const char *name,
+    size_t length)
+{
+    int index;
+
+    pthread_mutex_lock(&__registered_lock);
+    index = find_registered_widget(name, length);
+    pthread_mutex_unlock(&__registered_lock);
+
+    if (index < 0)
+        return XANTE_WIDGET_UNKNOWN;
+
+    return MAX_UI_DIALOG + index;
+}
+
+/**
+ * @name session_is_registered_widget
+ * @brief Checks if an object type belongs to a widget registered at runtime.
+ *
+ * @param [in] type: The object type.
+ *
+ * @return Returns true if the object type was registered or false otherwise.
+ */
+bool session_is_registered_widget(enum xante_object type)
+{
+    return get_registered_widget(type) != NULL;
+}
+
+/**
+ * @name session_widgets_owner
+ * @brief Sets who owns the widgets registered from now on.
+ *
+ * It's meant to be set to the application module while its initialization
+ * function runs, so its widgets may be unregistered before it's unloaded.
+ *
+ * @param [in] owner: The owner or NULL for the application itself.
+ */
+void session_widgets_owner(const void *owner)
+{
+    pthread_mutex_lock(&__registered_lock);
+    __registering_owner = owner;
+    pthread_mutex_unlock(&__registered_lock);
+}
+
+/**
+ * @name session_unregister_widgets
+ * @brief Unregisters every widget registered by an owner.
+ *
+ * @param [in] owner: The owner.
+ */
+void session_unregister_widgets(const void *owner)
+{
+    int i;
+
+    if (NULL == owner)
+        return;
+
+    pthread_mutex_lock(&__registered_lock);
+
+    for (i = 0; i < __total_registered_widgets; i++)
+        if ((__registered_widgets[i].name != NULL) &&
+            (__registered_widgets[i].owner == owner))
+        {
+            release_registered_widget(&__registered_widgets[i]);
+        }
+
+    pthread_mutex_unlock(&__registered_lock);
+}
+
+/**
+ * @name session_alloc
+ * @brief Allocates zeroed memory which lives until the session is finished.
+ *
+ * Dialogs are displayed from a single thread and their sessions are always
+ * finished in the reverse order they were started, so their memory comes
+ * from a single arena which is rewound by session_uninit and keeps its
+ * capacity between dialogs.
+ *
+ * @param [in,out] session: The session.
+ * @param [in] size: The size of the requested memory.
+ *
+ * @return On success returns a pointer to the memory or NULL otherwise.
+ */
+void *session_alloc(session_t *session, size_t size)
+{
+    struct arena *arena = session->xpp->ui.session_arena;
+
+    if (session->arena_in_use == false) {
+        session->arena_position = arena_position(arena);
+        session->arena_in_use = true;
+    }
+
+    return arena_alloc(arena, size);
+}
+
+/**
+ * @name session_strdup
+ * @brief Duplicates a string inside the session memory.
+ *
+ * @param [in,out] session: The session.
+ * @param [in] s: The string to be duplicated.
+ *
+ * @return On success returns the new string or NULL otherwise.
+ */
+char *session_strdup(session_t *session, const char *s)
+{
+    char *p = NULL;
+    size_t length;
+
+    if (NULL == s)
+        s = "";
+
+    length = strlen(s);
+    p = session_alloc(session, length + 1);
+
+    if (p != NULL)
+        memcpy(p, s, length);
+
+    return p;
+}
+
+/*
+ *
+ * API
+ *
+ */
+
+__PUB_API__ int xante_widget_register(const char *type,
+    const struct xante_widget_ops *ops, void *data)
+{
+    struct registered_widget *widget = NULL;
+    int object_type = -1, i;
+    cl_string_t *name = NULL;
+
+    errno_clear();
+
+    if ((NULL == type) || (NULL == ops) || (NULL == ops->run)) {
+        errno_set(XANTE_ERROR_NULL_ARG);
+        return -1;
+    }
+
+    /* A builtin or already registered widget can't be replaced */
+    name = cl_string_create("%s", type);
+
+    if (NULL == name) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return -1;
+    }
+
+    if (translate_string_widget_type(name) != XANTE_WIDGET_UNKNOWN) {
+        errno_set(XANTE_ERROR_INVALID_ARG);
+        goto end_block;
+    }
+
+    pthread_mutex_lock(&__registered_lock);
+
+    if (find_registered_widget(type, strlen(type)) >= 0) {
+        errno_set(XANTE_ERROR_INVALID_ARG);
+        goto unlock_block;
+    }
+
+    /* Slots left by unregistered widgets come first */
+    for (i = 0; i < __total_registered_widgets; i++)
+        if (NULL == __registered_widgets[i].name)
+            break;
+
+    if (i == MAX_REGISTERED_WIDGETS) {
+        errno_set(XANTE_ERROR_INVALID_ARG);
+        goto unlock_block;
+    }
+
+    widget = &__registered_widgets[i];
+    widget->name = strdup(type);
+
+    if (NULL == widget->name) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        goto unlock_block;
+    }
+
+    widget->length = strlen(type);
+    widget->ops = *ops;
+    widget->data = data;
+    widget->owner = __registering_owner;
+    object_type = MAX_UI_DIALOG + i;
+
+    if (i == __total_registered_widgets)
+        __total_registered_widgets++;
+
+unlock_block:
+    pthread_mutex_unlock(&__registered_lock);
+
+end_block:
+    cl_string_unref(name);
+
+    return object_type;
+}
+
+__PUB_API__ int xante_widget_unregister(const char *type)
+{
+    int index;
+
+    errno_clear();
+
+    if (NULL == type) {
+        errno_set(XANTE_ERROR_NULL_ARG);
+        return -1;
+    }
+
+    pthread_mutex_lock(&__registered_lock);
+    index = find_registered_widget(type, strlen(type));
+
+    if (index >= 0)
+        release_registered_widget(&__registered_widgets[index]);
+
+    pthread_mutex_unlock(&__registered_lock);
+
+    if (index < 0) {
+        errno_set(XANTE_ERROR_INVALID_ARG);
+        return -1;
+    }
+
+    return 0;
+}
+
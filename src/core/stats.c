@@ -0,0 +1,685 @@
+
+/*
+ * Description: Counters and latency histograms of the event functions
+ *              called by an application, and its startup phase timers.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 17:15:02 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "libxante.h"
+
+/*
+ * Latencies are kept in microseconds inside logarithmic buckets. Every power
+ * of two is split into STATS_SUB_BUCKETS linear buckets, so a bucket is at
+ * most 25% wide, up to 2^32 microseconds.
+ */
+#define STATS_SUB_BUCKET_BITS           2
+#define STATS_SUB_BUCKETS               (1 << STATS_SUB_BUCKET_BITS)
+#define STATS_MAX_MSB                   31
+#define STATS_HISTOGRAM_BUCKETS         \
+    (STATS_SUB_BUCKETS * (STATS_MAX_MSB - STATS_SUB_BUCKET_BITS + 2))
+
+/* How many entries are allocated each time we need more of them */
+#define STATS_EVENTS_CHUNK              16
+
+/* Maximum number of phases timed while an application starts */
+#define STATS_MAX_PHASES                32
+
+/* Maximum number of phases running inside one another */
+#define STATS_MAX_PHASE_DEPTH           4
+
+/** Statistics of a single function of an event */
+struct event_stats {
+    char                *event_name;
+    char                *function;
+    enum stats_origin   origin;
+    unsigned int        calls;
+    unsigned int        errors;
+    unsigned long long  total_us;
+    unsigned long long  min_us;
+    unsigned long long  max_us;
+    unsigned int        histogram[STATS_HISTOGRAM_BUCKETS];
+};
+
+/** A timed step of the application startup */
+struct stats_phase {
+    const char          *name;
+    struct timespec     start;
+    struct timespec     end;
+    bool                finished;
+};
+
+struct xante_stats {
+    pthread_mutex_t     lock;
+    struct event_stats  *events;
+    int                 total_events;
+    int                 allocated_events;
+    bool                log_on_exit;
+    struct stats_phase  phases[STATS_MAX_PHASES];
+    int                 total_phases;
+    int                 running_phases[STATS_MAX_PHASE_DEPTH];
+    int                 depth;
+};
+
+/*
+ *
+ * Internal functions
+ *
+ */
+
+static unsigned long long elapsed_us(const struct timespec *from,
+    const struct timespec *to)
+{
+    return (to->tv_sec - from->tv_sec) * 1000000ULL +
+           (to->tv_nsec - from->tv_nsec) / 1000;
+}
+
+static int bucket_index(unsigned long long us)
+{
+    int msb;
+
+    if (us < STATS_SUB_BUCKETS)
+        return (int)us;
+
+    msb = 63 - __builtin_clzll(us);
+
+    if (msb > STATS_MAX_MSB)
+        return STATS_HISTOGRAM_BUCKETS - 1;
+
+    return STATS_SUB_BUCKETS +
+           (msb - STATS_SUB_BUCKET_BITS) * STATS_SUB_BUCKETS +
+           (int)((us >> (msb - STATS_SUB_BUCKET_BITS)) & (STATS_SUB_BUCKETS - 1));
+}
+
+/* The highest latency which fits inside a bucket */
+static unsigned long long bucket_limit(int index)
+{
+    int shift, sub;
+
+    if (index < STATS_SUB_BUCKETS)
+        return index;
+
+    shift = (index - STATS_SUB_BUCKETS) / STATS_SUB_BUCKETS;
+    sub = (index - STATS_SUB_BUCKETS) % STATS_SUB_BUCKETS;
+
+    return ((unsigned long long)(STATS_SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+static unsigned long long histogram_percentile(const unsigned int *histogram,
+    unsigned int calls, int percentile, unsigned long long max_us)
+{
+    unsigned long long threshold, count = 0;
+    int i;
+
+    if (calls == 0)
+        return 0;
+
+    threshold = ((unsigned long long)calls * percentile + 99) / 100;
+
+    if (threshold == 0)
+        threshold = 1;
+
+    for (i = 0; i < STATS_HISTOGRAM_BUCKETS; i++) {
+        count += histogram[i];
+
+        if (count >= threshold)
+            return min(bucket_limit(i), max_us);
+    }
+
+    return max_us;
+}
+
+static const char *origin_name(enum stats_origin origin)
+{
+    switch (origin) {
+        case STATS_ORIGIN_INTERNAL:
+            return "internal";
+
+        case STATS_ORIGIN_EXTERNAL:
+            return "external";
+
+        default:
+            break;
+    }
+
+    return "module";
+}
+
+/*
+ * Gives the entry of a function from an event, creating it if it's the first
+ * time we see it. It must be called with the stats lock held.
+ */
+static struct event_stats *get_event_stats(struct xante_stats *stats,
+    const char *event_name, const char *function, enum stats_origin origin)
+{
+    struct event_stats *ev = NULL, *events = NULL;
+    int i;
+
+    for (i = 0; i < stats->total_events; i++) {
+        ev = &stats->events[i];
+
+        if ((ev->origin == origin) &&
+            (strcmp(ev->event_name, event_name) == 0) &&
+            (strcmp(ev->function, function) == 0))
+        {
+            return ev;
+        }
+    }
+
+    if (stats->total_events == stats->allocated_events) {
+        events = realloc(stats->events,
+                         (stats->allocated_events + STATS_EVENTS_CHUNK) *
+                                sizeof(struct event_stats));
+
+        if (NULL == events)
+            return NULL;
+
+        stats->events = events;
+        stats->allocated_events += STATS_EVENTS_CHUNK;
+    }
+
+    ev = &stats->events[stats->total_events];
+    memset(ev, 0, sizeof(struct event_stats));
+    ev->event_name = strdup(event_name);
+    ev->function = strdup(function);
+    ev->origin = origin;
+    ev->min_us = ~0ULL;
+    stats->total_events++;
+
+    return ev;
+}
+
+static void release_events(struct xante_stats *stats)
+{
+    int i;
+
+    for (i = 0; i < stats->total_events; i++) {
+        free(stats->events[i].event_name);
+        free(stats->events[i].function);
+    }
+
+    free(stats->events);
+    stats->events = NULL;
+    stats->total_events = 0;
+    stats->allocated_events = 0;
+}
+
+static unsigned long long mean_latency(const struct event_stats *ev)
+{
+    return (ev->calls > 0) ? ev->total_us / ev->calls : 0;
+}
+
+/*
+ * A phase still running when we need it, because the startup has failed,
+ * is accounted until now.
+ */
+static unsigned long long phase_duration(const struct stats_phase *phase)
+{
+    struct timespec now;
+
+    if (phase->finished)
+        return elapsed_us(&phase->start, &phase->end);
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return elapsed_us(&phase->start, &now);
+}
+
+static void log_stats(struct xante_app *xpp)
+{
+    struct xante_stats *stats = xpp->stats;
+    struct event_stats *ev = NULL;
+    unsigned int lookups;
+    size_t saved_bytes;
+    int i, strings;
+
+    for (i = 0; i < stats->total_phases; i++) {
+        xante_log_info(cl_tr("Startup phase [%s]: %llu us"),
+                       stats->phases[i].name,
+                       phase_duration(&stats->phases[i]));
+    }
+
+    for (i = 0; i < stats->total_events; i++) {
+        ev = &stats->events[i];
+        xante_log_info(cl_tr("Event [%s] function [%s] (%s): %u calls, "
+                             "%u errors, mean %llu us, p50 %llu us, "
+                             "p99 %llu us, max %llu us"),
+                       ev->event_name, ev->function, origin_name(ev->origin),
+                       ev->calls, ev->errors, mean_latency(ev),
+                       histogram_percentile(ev->histogram, ev->calls, 50,
+                                            ev->max_us),
+                       histogram_percentile(ev->histogram, ev->calls, 99,
+                                            ev->max_us),
+                       ev->max_us);
+    }
+
+    intern_info(xpp->ui.strings, &strings, &lookups, &saved_bytes);
+    xante_log_info(cl_tr("Shared strings: %d unique from %u, %zu bytes saved"),
+                   strings, lookups, saved_bytes);
+}
+
+/*
+ *
+ * Internal API
+ *
+ */
+
+/**
+ * @name stats_init
+ * @brief Starts the application statistics.
+ *
+ * @param [in,out] xpp: The library main object.
+ *
+ * @return On success returns 0 or -1 otherwise.
+ */
+int stats_init(struct xante_app *xpp)
+{
+    struct xante_stats *stats = NULL;
+
+    stats = calloc(1, sizeof(struct xante_stats));
+
+    if (NULL == stats) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return -1;
+    }
+
+    pthread_mutex_init(&stats->lock, NULL);
+    xpp->stats = stats;
+
+    return 0;
+}
+
+/**
+ * @name stats_uninit
+ * @brief Finishes the application statistics.
+ *
+ * If requested, the statistics are written to the log file before being
+ * released.
+ *
+ * @param [in,out] xpp: The library main object.
+ */
+void stats_uninit(struct xante_app *xpp)
+{
+    struct xante_stats *stats = xpp->stats;
+
+    if (NULL == stats)
+        return;
+
+    if (stats->log_on_exit)
+        log_stats(xpp);
+
+    release_events(stats);
+    pthread_mutex_destroy(&stats->lock);
+    free(stats);
+    xpp->stats = NULL;
+}
+
+/**
+ * @name stats_event_start
+ * @brief Marks the moment an event function is going to be called.
+ *
+ * @param [out] start: The moment.
+ */
+void stats_event_start(struct timespec *start)
+{
+    clock_gettime(CLOCK_MONOTONIC, start);
+}
+
+/**
+ * @name stats_event_record
+ * @brief Accounts a call of an event function.
+ *
+ * It may be called from any thread.
+ *
+ * @param [in,out] xpp: The library main object.
+ * @param [in] event_name: The event name.
+ * @param [in] function: The called function name.
+ * @param [in] origin: Where the function was found.
+ * @param [in] start: The moment the function was called, from
+ *                    stats_event_start.
+ * @param [in] failed: A flag indicating if the call has failed.
+ */
+void stats_event_record(struct xante_app *xpp, const char *event_name,
+    const char *function, enum stats_origin origin,
+    const struct timespec *start, bool failed)
+{
+    struct xante_stats *stats = xpp->stats;
+    struct event_stats *ev = NULL;
+    struct timespec now;
+    unsigned long long us;
+
+    if (NULL == stats)
+        return;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    us = elapsed_us(start, &now);
+
+    pthread_mutex_lock(&stats->lock);
+    ev = get_event_stats(stats, event_name, function, origin);
+
+    if (ev != NULL) {
+        ev->calls++;
+        ev->total_us += us;
+        ev->min_us = min(ev->min_us, us);
+        ev->max_us = max(ev->max_us, us);
+        ev->histogram[bucket_index(us)]++;
+
+        if (failed)
+            ev->errors++;
+    }
+
+    pthread_mutex_unlock(&stats->lock);
+}
+
+/**
+ * @name stats_phase_begin
+ * @brief Starts timing a startup phase.
+ *
+ * A phase may be started inside another one, and it's finished with
+ * stats_phase_end.
+ *
+ * @param [in,out] xpp: The library main object.
+ * @param [in] name: The phase name. It must remain valid while the
+ *                   application is running.
+ */
+void stats_phase_begin(struct xante_app *xpp, const char *name)
+{
+    struct xante_stats *stats = xpp->stats;
+    struct stats_phase *phase = NULL;
+
+    if (NULL == stats)
+        return;
+
+    pthread_mutex_lock(&stats->lock);
+
+    if ((stats->total_phases < STATS_MAX_PHASES) &&
+        (stats->depth < STATS_MAX_PHASE_DEPTH))
+    {
+        phase = &stats->phases[stats->total_phases];
+        phase->name = name;
+        phase->finished = false;
+        clock_gettime(CLOCK_MONOTONIC, &phase->start);
+        stats->running_phases[stats->depth++] = stats->total_phases++;
+    }
+
+    pthread_mutex_unlock(&stats->lock);
+}
+
+/**
+ * @name stats_phase_end
+ * @brief Finishes the last startup phase started.
+ *
+ * @param [in,out] xpp: The library main object.
+ */
+void stats_phase_end(struct xante_app *xpp)
+{
+    struct xante_stats *stats = xpp->stats;
+    struct stats_phase *phase = NULL;
+
+    if (NULL == stats)
+        return;
+
+    pthread_mutex_lock(&stats->lock);
+
+    if (stats->depth > 0) {
+        phase = &stats->phases[stats->running_phases[--stats->depth]];
+        clock_gettime(CLOCK_MONOTONIC, &phase->end);
+        phase->finished = true;
+    }
+
+    pthread_mutex_unlock(&stats->lock);
+}
+
+/**
+ * @name stats_trace_export
+ * @brief Writes the startup phases to a file, using the Chrome trace event
+ *        format.
+ *
+ * The file can be opened with chrome://tracing or any compatible viewer.
+ *
+ * @param [in] xpp: The library main object.
+ * @param [in] pathname: The file path.
+ *
+ * @return On success returns 0 or -1 otherwise.
+ */
+int stats_trace_export(struct xante_app *xpp, const char *pathname)
+{
+    struct xante_stats *stats = xpp->stats;
+    struct stats_phase *phase = NULL;
+    FILE *fp = NULL;
+    int i;
+
+    if ((NULL == stats) || (stats->total_phases == 0))
+        return 0;
+
+    fp = fopen(pathname, "w");
+
+    if (NULL == fp)
+        return -1;
+
+    pthread_mutex_lock(&stats->lock);
+    fprintf(fp, "{\"traceEvents\":[");
+
+    /* Timestamps are relative to the first phase */
+    for (i = 0; i < stats->total_phases; i++) {
+        phase = &stats->phases[i];
+        fprintf(fp, "%s\n{\"name\":\"%s\",\"cat\":\"startup\",\"ph\":\"X\","
+                    "\"ts\":%llu,\"dur\":%llu,\"pid\":%d,\"tid\":%d}",
+                (i > 0) ? "," : "", phase->name,
+                elapsed_us(&stats->phases[0].start, &phase->start),
+                phase_duration(phase), getpid(), getpid());
+    }
+
+    fprintf(fp, "\n],\"displayTimeUnit\":\"ms\"}\n");
+    pthread_mutex_unlock(&stats->lock);
+    fclose(fp);
+
+    return 0;
+}
+
+/*
+ *
+ * API
+ *
+ */
+
+__PUB_API__ int xante_stats_set_log_on_exit(xante_t *xpp, bool log_on_exit)
+{
+    struct xante_app *x = (struct xante_app *)xpp;
+
+    errno_clear();
+
+    if ((NULL == xpp) || (NULL == x->stats)) {
+        errno_set(XANTE_ERROR_NULL_ARG);
+        return -1;
+    }
+
+    x->stats->log_on_exit = log_on_exit;
+
+    return 0;
+}
+
+__PUB_API__ int xante_stats_reset(xante_t *xpp)
+{
+    struct xante_app *x = (struct xante_app *)xpp;
+
+    errno_clear();
+
+    if ((NULL == xpp) || (NULL == x->stats)) {
+        errno_set(XANTE_ERROR_NULL_ARG);
+        return -1;
+    }
+
+    pthread_mutex_lock(&x->stats->lock);
+    release_events(x->stats);
+    pthread_mutex_unlock(&x->stats->lock);
+
+    return 0;
+}
+
+__PUB_API__ int xante_stats_event_calls(const xante_t *xpp,
+    const char *event_name)
+{
+    struct xante_app *x = (struct xante_app *)xpp;
+    int i, calls = 0;
+
+    errno_clear();
+
+    if ((NULL == xpp) || (NULL == x->stats) || (NULL == event_name)) {
+        errno_set(XANTE_ERROR_NULL_ARG);
+        return -1;
+    }
+
+    pthread_mutex_lock(&x->stats->lock);
+
+    for (i = 0; i < x->stats->total_events; i++)
+        if (strcmp(x->stats->events[i].event_name, event_name) == 0)
+            calls += x->stats->events[i].calls;
+
+    pthread_mutex_unlock(&x->stats->lock);
+
+    return calls;
+}
+
+__PUB_API__ long long xante_stats_event_latency(const xante_t *xpp,
+    const char *event_name, int percentile)
+{
+    struct xante_app *x = (struct xante_app *)xpp;
+    struct event_stats *ev = NULL;
+    unsigned int histogram[STATS_HISTOGRAM_BUCKETS] = { 0 }, calls = 0;
+    unsigned long long max_us = 0;
+    int i, j;
+
+    errno_clear();
+
+    if ((NULL == xpp) || (NULL == x->stats) || (NULL == event_name)) {
+        errno_set(XANTE_ERROR_NULL_ARG);
+        return -1;
+    }
+
+    if ((percentile < 0) || (percentile > 100)) {
+        errno_set(XANTE_ERROR_INVALID_ARG);
+        return -1;
+    }
+
+    pthread_mutex_lock(&x->stats->lock);
+
+    /* Every function of the event is accounted together */
+    for (i = 0; i < x->stats->total_events; i++) {
+        ev = &x->stats->events[i];
+
+        if (strcmp(ev->event_name, event_name) != 0)
+            continue;
+
+        for (j = 0; j < STATS_HISTOGRAM_BUCKETS; j++)
+            histogram[j] += ev->histogram[j];
+
+        calls += ev->calls;
+        max_us = max(max_us, ev->max_us);
+    }
+
+    pthread_mutex_unlock(&x->stats->lock);
+
+    return (long long)histogram_percentile(histogram, calls, percentile,
+                                           max_us);
+}
+
+__PUB_API__ char *xante_stats_info(const xante_t *xpp)
+{
+    struct xante_app *x = (struct xante_app *)xpp;
+    struct event_stats *ev = NULL;
+    cl_string_t *info = NULL;
+    char *s = NULL;
+    unsigned int lookups;
+    size_t saved_bytes;
+    bool first;
+    int i, j, strings;
+
+    errno_clear();
+
+    if ((NULL == xpp) || (NULL == x->stats)) {
+        errno_set(XANTE_ERROR_NULL_ARG);
+        return NULL;
+    }
+
+    info = cl_string_create("{\"events\":[");
+    pthread_mutex_lock(&x->stats->lock);
+
+    for (i = 0; i < x->stats->total_events; i++) {
+        ev = &x->stats->events[i];
+        cl_string_cat(info, "%s{\"event\":\"%s\",\"function\":\"%s\","
+                            "\"origin\":\"%s\",\"calls\":%u,\"errors\":%u,"
+                            "\"min_us\":%llu,\"mean_us\":%llu,\"max_us\":%llu,"
+                            "\"p50_us\":%llu,\"p90_us\":%llu,\"p99_us\":%llu,"
+                            "\"histogram\":[",
+                      (i > 0) ? "," : "", ev->event_name, ev->function,
+                      origin_name(ev->origin), ev->calls, ev->errors,
+                      (ev->calls > 0) ? ev->min_us : 0, mean_latency(ev),
+                      ev->max_us,
+                      histogram_percentile(ev->histogram, ev->calls, 50,
+                                           ev->max_us),
+                      histogram_percentile(ev->histogram, ev->calls, 90,
+                                           ev->max_us),
+                      histogram_percentile(ev->histogram, ev->calls, 99,
+                                           ev->max_us));
+
+        /* Only buckets with some call, as [limit_us, calls] pairs */
+        for (j = 0, first = true; j < STATS_HISTOGRAM_BUCKETS; j++) {
+            if (ev->histogram[j] == 0)
+                continue;
+
+            cl_string_cat(info, "%s[%llu,%u]", first ? "" : ",",
+                          bucket_limit(j), ev->histogram[j]);
+
+            first = false;
+        }
+
+        cl_string_cat(info, "]}");
+    }
+
+    cl_string_cat(info, "],\"phases\":[");
+
+    for (i = 0; i < x->stats->total_phases; i++) {
+        cl_string_cat(info, "%s{\"name\":\"%s\",\"start_us\":%llu,"
+                            "\"duration_us\":%llu}",
+                      (i > 0) ? "," : "", x->stats->phases[i].name,
+                      elapsed_us(&x->stats->phases[0].start,
+                                 &x->stats->phases[i].start),
+                      phase_duration(&x->stats->phases[i]));
+    }
+
+    pthread_mutex_unlock(&x->stats->lock);
+    intern_info(x->ui.strings, &strings, &lookups, &saved_bytes);
+    cl_string_cat(info, "],\"strings\":{\"unique\":%d,\"lookups\":%u,"
+                        "\"saved_bytes\":%zu}}",
+                  strings, lookups, saved_bytes);
+
+    s = strdup(cl_string_valueof(info));
+    cl_string_unref(info);
+
+    return s;
+}
+
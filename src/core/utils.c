@@ -24,41 +24,130 @@
  * USA
  */
 
+#include <pthread.h>
+
 #include "libxante.h"
 
+/* Number of slots of the widget name hash table (a power of two) */
+#define WIDGET_HASH_SLOTS               256
+
+/* Every supported JTF object name, indexed by its type */
+static const char *__widget_names[] = {
+    [XANTE_WIDGET_UNKNOWN] = "",
+    [XANTE_WIDGET_MENU_REFERENCE] = XANTE_STR_WIDGET_MENU,
+    [XANTE_WIDGET_INPUT_INT] = XANTE_STR_WIDGET_INPUT_INT,
+    [XANTE_WIDGET_INPUT_FLOAT] = XANTE_STR_WIDGET_INPUT_FLOAT,
+    [XANTE_WIDGET_INPUT_DATE] = XANTE_STR_WIDGET_INPUT_DATE,
+    [XANTE_WIDGET_INPUT_STRING] = XANTE_STR_WIDGET_INPUT_STRING,
+    [XANTE_WIDGET_INPUT_PASSWD] = XANTE_STR_WIDGET_INPUT_PASSWD,
+    [XANTE_WIDGET_INPUT_TIME] = XANTE_STR_WIDGET_INPUT_TIME,
+    [XANTE_WIDGET_CALENDAR] = XANTE_STR_WIDGET_CALENDAR,
+    [XANTE_WIDGET_TIMEBOX] = XANTE_STR_WIDGET_TIMEBOX,
+    [XANTE_WIDGET_RADIO_CHECKLIST] = XANTE_STR_WIDGET_RADIO_CHECKLIST,
+    [XANTE_WIDGET_CHECKLIST] = XANTE_STR_WIDGET_CHECKLIST,
+    [XANTE_WIDGET_YES_NO] = XANTE_STR_WIDGET_YESNO,
+    [XANTE_WIDGET_DYNAMIC_MENU_REFERENCE] = XANTE_STR_WIDGET_DYNAMIC_MENU,
+    [XANTE_WIDGET_DELETE_DYNAMIC_MENU_ITEM] = XANTE_STR_WIDGET_DELETE_DYNAMIC_MENU,
+    [XANTE_WIDGET_ADD_DYNAMIC_MENU_ITEM] = XANTE_STR_WIDGET_ADD_DYNAMIC_MENU,
+    [XANTE_WIDGET_CUSTOM] = XANTE_STR_WIDGET_CUSTOM,
+    [XANTE_WIDGET_PROGRESS] = XANTE_STR_WIDGET_PROGRESS,
+    [XANTE_WIDGET_SPINNER_SYNC] = XANTE_STR_WIDGET_SPINNER_SYNC,
+    [XANTE_WIDGET_DOTS_SYNC] = XANTE_STR_WIDGET_DOTS_SYNC,
+    [XANTE_WIDGET_RANGE] = XANTE_STR_WIDGET_RANGE,
+    [XANTE_WIDGET_FILE_SELECT] = XANTE_STR_WIDGET_FILE_SELECT,
+    [XANTE_WIDGET_DIR_SELECT] = XANTE_STR_WIDGET_DIR_SELECT,
+    [XANTE_WIDGET_FILE_VIEW] = XANTE_STR_WIDGET_FILE_VIEW,
+    [XANTE_WIDGET_TAILBOX] = XANTE_STR_WIDGET_TAILBOX,
+    [XANTE_WIDGET_SCROLLTEXT] = XANTE_STR_WIDGET_SCROLLTEXT,
+    [XANTE_WIDGET_UPDATE_OBJECT] = XANTE_STR_WIDGET_UPDATE_OBJECT,
+    [XANTE_WIDGET_INPUTSCROLL] = XANTE_STR_WIDGET_INPUTSCROLL,
+    [XANTE_WIDGET_MIXEDFORM] = XANTE_STR_WIDGET_MIXEDFORM,
+    [XANTE_WIDGET_BUILDLIST] = XANTE_STR_WIDGET_BUILDLIST,
+    [XANTE_WIDGET_SPREADSHEET] = XANTE_STR_WIDGET_SPREADSHEET,
+    [XANTE_WIDGET_MULTI_PROGRESS] = XANTE_STR_WIDGET_MULTI_PROGRESS,
+    [XANTE_GADGET_CLOCK] = XANTE_STR_GADGET_PREFIX ":" XANTE_STR_GADGET_CLOCK,
+};
+
+#define WIDGET_NAMES                    \
+    (int)(sizeof(__widget_names) / sizeof(__widget_names[0]))
+
+/* Fails to build if an object type was left out of __widget_names */
+typedef char __widget_names_check[(WIDGET_NAMES == XANTE_GADGET_CLOCK + 1)
+                                  ? 1 : -1];
+
+/*
+ * A perfect hash over __widget_names: every known name owns one slot of
+ * __widget_slots, so translating a name is a single hash and compare.
+ */
+static unsigned char __widget_slots[WIDGET_HASH_SLOTS];
+static unsigned int __widget_seed = 0;
+static pthread_once_t __widget_hash_once = PTHREAD_ONCE_INIT;
+
 /*
  *
  * Internal functions
  *
  */
 
-static cl_string_t *extract_object_type(const cl_string_t *type)
+static unsigned int hash_widget_name(unsigned int seed, const char *name,
+    size_t length)
 {
-    cl_stringlist_t *l = NULL;
-    cl_string_t *prefix = NULL, *object = NULL;
+    unsigned int h = 2166136261u ^ seed;
+    size_t i;
+
+    /* FNV-1a */
+    for (i = 0; i < length; i++) {
+        h ^= (unsigned char)name[i];
+        h *= 16777619u;
+    }
 
-    l = cl_string_split(type, ":");
+    return h & (WIDGET_HASH_SLOTS - 1);
+}
 
-    if ((NULL == l) || (cl_stringlist_size(l) != 2))
-        goto end_block;
+static void build_widget_hash(void)
+{
+    unsigned int seed, h;
+    int i;
 
-    prefix = cl_stringlist_get(l, 0);
+    /*
+     * Looks for the first seed where every known name falls into its own
+     * slot, so a lookup never needs to probe more than once.
+     */
+    for (seed = 0; ; seed++) {
+        memset(__widget_slots, 0, sizeof(__widget_slots));
 
-    if (strcmp(cl_string_valueof(prefix), "gadget") != 0)
-        goto end_block;
+        for (i = XANTE_WIDGET_UNKNOWN + 1; i < WIDGET_NAMES; i++) {
+            h = hash_widget_name(seed, __widget_names[i],
+                                 strlen(__widget_names[i]));
 
-    object = cl_stringlist_get(l, 1);
+            if (__widget_slots[h] != XANTE_WIDGET_UNKNOWN)
+                break;
 
-end_block:
-    cl_stringlist_destroy(l);
-    cl_string_unref(prefix);
+            __widget_slots[h] = i;
+        }
 
-    if (object != NULL) {
-        errno_set(XANTE_ERROR_UNKNOWN_OBJECT_PREFIX);
-        errno_store_additional_content(cl_string_valueof(type));
+        if (i == WIDGET_NAMES)
+            break;
     }
 
-    return object;
+    __widget_seed = seed;
+}
+
+static enum xante_object lookup_widget_name(const char *name, size_t length)
+{
+    enum xante_object widget;
+
+    pthread_once(&__widget_hash_once, build_widget_hash);
+    widget = __widget_slots[hash_widget_name(__widget_seed, name, length)];
+
+    if ((widget == XANTE_WIDGET_UNKNOWN) ||
+        (strlen(__widget_names[widget]) != length) ||
+        (memcmp(__widget_names[widget], name, length) != 0))
+    {
+        return XANTE_WIDGET_UNKNOWN;
+    }
+
+    return widget;
 }
 
 /*
@@ -78,45 +167,10 @@ end_block:
  */
 bool is_valid_ui_object(enum xante_object type)
 {
-    switch (type) {
-        case XANTE_WIDGET_MENU_REFERENCE:
-        case XANTE_WIDGET_INPUT_INT:
-        case XANTE_WIDGET_INPUT_FLOAT:
-        case XANTE_WIDGET_INPUT_DATE:
-        case XANTE_WIDGET_INPUT_STRING:
-        case XANTE_WIDGET_INPUT_PASSWD:
-        case XANTE_WIDGET_INPUT_TIME:
-        case XANTE_WIDGET_CALENDAR:
-        case XANTE_WIDGET_TIMEBOX:
-        case XANTE_WIDGET_CHECKLIST:
-        case XANTE_WIDGET_RADIO_CHECKLIST:
-        case XANTE_WIDGET_YES_NO:
-        case XANTE_WIDGET_DYNAMIC_MENU_REFERENCE:
-        case XANTE_WIDGET_DELETE_DYNAMIC_MENU_ITEM:
-        case XANTE_WIDGET_ADD_DYNAMIC_MENU_ITEM:
-        case XANTE_WIDGET_CUSTOM:
-        case XANTE_WIDGET_PROGRESS:
-        case XANTE_WIDGET_SPINNER_SYNC:
-        case XANTE_WIDGET_DOTS_SYNC:
-        case XANTE_WIDGET_RANGE:
-        case XANTE_WIDGET_FILE_SELECT:
-        case XANTE_WIDGET_DIR_SELECT:
-        case XANTE_WIDGET_FILE_VIEW:
-        case XANTE_WIDGET_TAILBOX:
-        case XANTE_WIDGET_SCROLLTEXT:
-        case XANTE_WIDGET_UPDATE_OBJECT:
-        case XANTE_WIDGET_INPUTSCROLL:
-        case XANTE_WIDGET_MIXEDFORM:
-        case XANTE_WIDGET_BUILDLIST:
-        case XANTE_WIDGET_SPREADSHEET:
-        case XANTE_GADGET_CLOCK:
-            return true;
+    if ((type > XANTE_WIDGET_UNKNOWN) && (type < WIDGET_NAMES))
+        return true;
 
-        default:
-            break;
-    }
-
-    return false;
+    return session_is_registered_widget(type);
 }
 
 /**
@@ -169,89 +223,26 @@ enum xante_menu_type translate_string_menu_type(const char *type)
  */
 enum xante_object translate_string_widget_type(const cl_string_t *type)
 {
-    enum xante_object widget = XANTE_WIDGET_UNKNOWN;
-    cl_string_t *object = NULL;
-    char *ptype = NULL;
-
-    /* Are we a gadget? */
-    if (cl_string_find(type, ':') >= 0) {
-        object = extract_object_type(type);
-
-        if (NULL == object)
-            return widget;
-
-        ptype = (char *)cl_string_valueof(object);
-
-        if (strcmp(ptype, XANTE_STR_GADGET_CLOCK) == 0)
-            widget = XANTE_GADGET_CLOCK;
-
-        cl_string_unref(object);
-        return widget;
+    enum xante_object widget;
+    const char *ptype = cl_string_valueof(type);
+    size_t length = cl_string_length(type);
+
+    widget = lookup_widget_name(ptype, length);
+
+    /* Maybe a widget provided by the application or one of its modules */
+    if (widget == XANTE_WIDGET_UNKNOWN)
+        widget = session_registered_widget_type(ptype, length);
+
+    /* An unknown object with an unsupported prefix */
+    if ((widget == XANTE_WIDGET_UNKNOWN) &&
+        (memchr(ptype, ':', length) != NULL) &&
+        (strncmp(ptype, XANTE_STR_GADGET_PREFIX ":",
+                 strlen(XANTE_STR_GADGET_PREFIX ":")) != 0))
+    {
+        errno_set(XANTE_ERROR_UNKNOWN_OBJECT_PREFIX);
+        errno_store_additional_content(ptype);
     }
 
-    ptype = (char *)cl_string_valueof(type);
-
-    if (strcmp(ptype, XANTE_STR_WIDGET_MENU) == 0)
-        widget = XANTE_WIDGET_MENU_REFERENCE;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_INPUT_INT) == 0)
-        widget = XANTE_WIDGET_INPUT_INT;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_INPUT_FLOAT) == 0)
-        widget = XANTE_WIDGET_INPUT_FLOAT;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_INPUT_DATE) == 0)
-        widget = XANTE_WIDGET_INPUT_DATE;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_INPUT_STRING) == 0)
-        widget = XANTE_WIDGET_INPUT_STRING;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_INPUT_PASSWD) == 0)
-        widget = XANTE_WIDGET_INPUT_PASSWD;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_INPUT_TIME) == 0)
-        widget = XANTE_WIDGET_INPUT_TIME;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_CALENDAR) == 0)
-        widget = XANTE_WIDGET_CALENDAR;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_TIMEBOX) == 0)
-        widget = XANTE_WIDGET_TIMEBOX;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_RADIO_CHECKLIST) == 0)
-        widget = XANTE_WIDGET_RADIO_CHECKLIST;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_CHECKLIST) == 0)
-        widget = XANTE_WIDGET_CHECKLIST;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_YESNO) == 0)
-        widget = XANTE_WIDGET_YES_NO;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_DYNAMIC_MENU) == 0)
-        widget = XANTE_WIDGET_DYNAMIC_MENU_REFERENCE;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_DELETE_DYNAMIC_MENU) == 0)
-        widget = XANTE_WIDGET_DELETE_DYNAMIC_MENU_ITEM;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_ADD_DYNAMIC_MENU) == 0)
-        widget = XANTE_WIDGET_ADD_DYNAMIC_MENU_ITEM;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_CUSTOM) == 0)
-        widget = XANTE_WIDGET_CUSTOM;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_PROGRESS) == 0)
-        widget = XANTE_WIDGET_PROGRESS;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_SPINNER_SYNC) == 0)
-        widget = XANTE_WIDGET_SPINNER_SYNC;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_DOTS_SYNC) == 0)
-        widget = XANTE_WIDGET_DOTS_SYNC;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_RANGE) == 0)
-        widget = XANTE_WIDGET_RANGE;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_FILE_SELECT) == 0)
-        widget = XANTE_WIDGET_FILE_SELECT;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_DIR_SELECT) == 0)
-        widget = XANTE_WIDGET_DIR_SELECT;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_FILE_VIEW) == 0)
-        widget = XANTE_WIDGET_FILE_VIEW;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_TAILBOX) == 0)
-        widget = XANTE_WIDGET_TAILBOX;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_SCROLLTEXT) == 0)
-        widget = XANTE_WIDGET_SCROLLTEXT;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_UPDATE_OBJECT) == 0)
-        widget = XANTE_WIDGET_UPDATE_OBJECT;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_INPUTSCROLL) == 0)
-        widget = XANTE_WIDGET_INPUTSCROLL;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_MIXEDFORM) == 0)
-        widget = XANTE_WIDGET_MIXEDFORM;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_BUILDLIST) == 0)
-        widget = XANTE_WIDGET_BUILDLIST;
-    else if (strcmp(ptype, XANTE_STR_WIDGET_SPREADSHEET) == 0)
-        widget = XANTE_WIDGET_SPREADSHEET;
-
     return widget;
 }
 
@@ -267,7 +258,8 @@ bool is_menu_item(const cl_string_t *type)
 {
     enum xante_object dlg_type;
 
-    dlg_type = translate_string_widget_type(type);
+    dlg_type = lookup_widget_name(cl_string_valueof(type),
+                                  cl_string_length(type));
 
     switch (dlg_type) {
         case XANTE_WIDGET_MENU_REFERENCE:
@@ -0,0 +1,391 @@
+
+/*
+ * Description: Typed validation of an input item content.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 14:11:36 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <errno.h>
+#include <float.h>
+#include <limits.h>
+#include <stdlib.h>
+
+#include "libxante.h"
+
+static const char *__description[] = {
+    "ok",
+    "invalid format",
+    "value out of range",
+    "value too long",
+    "invalid day",
+    "invalid month",
+    "invalid year",
+    "invalid hour",
+    "invalid minutes",
+    "invalid seconds",
+};
+
+/*
+ *
+ * Internal functions
+ *
+ */
+
+static enum validator_type validator_type_of(enum xante_object type)
+{
+    switch (type) {
+        case XANTE_WIDGET_INPUT_INT:
+        case XANTE_WIDGET_RANGE:
+            return VALIDATOR_INT;
+
+        case XANTE_WIDGET_INPUT_FLOAT:
+            return VALIDATOR_FLOAT;
+
+        case XANTE_WIDGET_INPUT_DATE:
+            return VALIDATOR_DATE;
+
+        case XANTE_WIDGET_INPUT_TIME:
+            return VALIDATOR_TIME;
+
+        case XANTE_WIDGET_INPUT_STRING:
+        case XANTE_WIDGET_INPUT_PASSWD:
+        case XANTE_WIDGET_INPUTSCROLL:
+            return VALIDATOR_STRING;
+
+        case XANTE_WIDGET_RADIO_CHECKLIST:
+        case XANTE_WIDGET_YES_NO:
+            return VALIDATOR_CHOICE;
+
+        case XANTE_WIDGET_CHECKLIST:
+            return VALIDATOR_SELECTION;
+
+        default:
+            break;
+    }
+
+    return VALIDATOR_NONE;
+}
+
+/*
+ * Reads an unsigned decimal field which must end with @delimiter. Returns
+ * a pointer to the next field or NULL if the field is not a number.
+ */
+static const char *scan_field(const char *p, char delimiter, int *field)
+{
+    int n = 0, digits = 0;
+
+    while ((*p >= '0') && (*p <= '9')) {
+        if (n > (INT_MAX - 9) / 10)
+            return NULL;
+
+        n = (n * 10) + (*p - '0');
+        digits++;
+        p++;
+    }
+
+    if ((digits == 0) || (*p != delimiter))
+        return NULL;
+
+    *field = n;
+
+    return (delimiter == '\0') ? p : p + 1;
+}
+
+/*
+ * Splits a value with the format "a<delimiter>b<delimiter>c" into its three
+ * fields, without copying it.
+ */
+static bool scan_fields(const char *value, char delimiter, int *a, int *b,
+    int *c)
+{
+    const char *p = value;
+
+    p = scan_field(p, delimiter, a);
+
+    if (NULL == p)
+        return false;
+
+    p = scan_field(p, delimiter, b);
+
+    if (NULL == p)
+        return false;
+
+    return scan_field(p, '\0', c) != NULL;
+}
+
+static enum validator_status check_int(const struct item_validator *validator,
+    const char *value)
+{
+    char *end = NULL;
+    long n;
+
+    errno = 0;
+    n = strtol(value, &end, 10);
+
+    if ((end == value) || (*end != '\0'))
+        return VALIDATOR_INVALID_FORMAT;
+
+    if ((errno == ERANGE) || (n < validator->range.i.min) ||
+        (n > validator->range.i.max))
+    {
+        return VALIDATOR_OUT_OF_RANGE;
+    }
+
+    return VALIDATOR_OK;
+}
+
+static enum validator_status check_float(const struct item_validator *validator,
+    const char *value)
+{
+    char *end = NULL;
+    float n;
+
+    errno = 0;
+    n = strtof(value, &end);
+
+    if ((end == value) || (*end != '\0'))
+        return VALIDATOR_INVALID_FORMAT;
+
+    /* This also refuses a NaN */
+    if ((errno == ERANGE) || !((n >= validator->range.f.min) &&
+                               (n <= validator->range.f.max)))
+    {
+        return VALIDATOR_OUT_OF_RANGE;
+    }
+
+    return VALIDATOR_OK;
+}
+
+static enum validator_status check_date(const char *value)
+{
+    int day, month, year;
+
+    if (scan_fields(value, '/', &day, &month, &year) == false)
+        return VALIDATOR_INVALID_FORMAT;
+
+    if ((day <= 0) || (day > 31))
+        return VALIDATOR_INVALID_DAY;
+
+    if ((month <= 0) || (month > 12))
+        return VALIDATOR_INVALID_MONTH;
+
+    if (year <= 0)
+        return VALIDATOR_INVALID_YEAR;
+
+    return VALIDATOR_OK;
+}
+
+static enum validator_status check_time(const char *value)
+{
+    int hour, minute, second;
+
+    if (scan_fields(value, ':', &hour, &minute, &second) == false)
+        return VALIDATOR_INVALID_FORMAT;
+
+    if (hour > 23)
+        return VALIDATOR_INVALID_HOUR;
+
+    if (minute > 59)
+        return VALIDATOR_INVALID_MINUTE;
+
+    if (second > 59)
+        return VALIDATOR_INVALID_SECOND;
+
+    return VALIDATOR_OK;
+}
+
+/* The index of one of the item options */
+static enum validator_status check_choice(const struct item_validator *validator,
+    const char *value)
+{
+    int choice;
+
+    if (scan_field(value, '\0', &choice) == NULL)
+        return VALIDATOR_INVALID_FORMAT;
+
+    if (choice >= validator->choices)
+        return VALIDATOR_OUT_OF_RANGE;
+
+    return VALIDATOR_OK;
+}
+
+/*
+ * Counts the UTF-8 characters of @value, the same unit used by the item
+ * maximum length, stopping as soon as it goes over @limit.
+ */
+static int utf8_length(const char *value, int limit)
+{
+    const unsigned char *p = (const unsigned char *)value;
+    int length = 0;
+
+    for (; (*p != '\0') && (length <= limit); p++)
+        if ((*p & 0xC0) != 0x80)
+            length++;
+
+    return length;
+}
+
+static enum validator_status check_string(const struct item_validator *validator,
+    const char *value)
+{
+    if ((validator->string_length > 0) &&
+        (utf8_length(value, validator->string_length) >
+            validator->string_length))
+    {
+        return VALIDATOR_TOO_LONG;
+    }
+
+    return VALIDATOR_OK;
+}
+
+static enum validator_status
+check_selection(const struct item_validator *validator, const char *value)
+{
+    if (bitset_validate_cstring(value, validator->choices) == false)
+        return VALIDATOR_OUT_OF_RANGE;
+
+    return VALIDATOR_OK;
+}
+
+/*
+ *
+ * Internal API
+ *
+ */
+
+/**
+ * @name validator_compile
+ * @brief Builds the validator of an item from its JTF constraints.
+ *
+ * It must be called after the item's ranges have been adjusted.
+ *
+ * @param [out] validator: The validator to be built.
+ * @param [in] item: The item.
+ */
+void validator_compile(struct item_validator *validator,
+    const struct xante_item *item)
+{
+    memset(validator, 0, sizeof(struct item_validator));
+    validator->type = validator_type_of(item->widget_type);
+    validator->string_length = item->string_length;
+
+    switch (validator->type) {
+        case VALIDATOR_INT:
+            validator->range.i.min = (item->min != NULL)
+                                        ? CL_OBJECT_AS_INT(item->min)
+                                        : INT_MIN;
+
+            validator->range.i.max = (item->max != NULL)
+                                        ? CL_OBJECT_AS_INT(item->max)
+                                        : INT_MAX;
+
+            break;
+
+        case VALIDATOR_FLOAT:
+            validator->range.f.min = (item->min != NULL)
+                                        ? CL_OBJECT_AS_FLOAT(item->min)
+                                        : -FLT_MAX;
+
+            validator->range.f.max = (item->max != NULL)
+                                        ? CL_OBJECT_AS_FLOAT(item->max)
+                                        : FLT_MAX;
+
+            break;
+
+        case VALIDATOR_CHOICE:
+        case VALIDATOR_SELECTION:
+            validator->choices = (item->widget_type == XANTE_WIDGET_YES_NO)
+                                    ? 2
+                                    : ((item->list_items != NULL)
+                                        ? cl_stringlist_size(item->list_items)
+                                        : 0);
+
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @name validator_check
+ * @brief Checks if a value satisfies a validator.
+ *
+ * The value is parsed where it is, no memory is allocated while doing it.
+ *
+ * @param [in] validator: The validator.
+ * @param [in] value: The value, as a NUL terminated string.
+ *
+ * @return Returns VALIDATOR_OK if the value is valid or the reason why it
+ *         isn't.
+ */
+enum validator_status validator_check(const struct item_validator *validator,
+    const char *value)
+{
+    if (NULL == value)
+        return VALIDATOR_INVALID_FORMAT;
+
+    switch (validator->type) {
+        case VALIDATOR_INT:
+            return check_int(validator, value);
+
+        case VALIDATOR_FLOAT:
+            return check_float(validator, value);
+
+        case VALIDATOR_DATE:
+            return check_date(value);
+
+        case VALIDATOR_TIME:
+            return check_time(value);
+
+        case VALIDATOR_STRING:
+            return check_string(validator, value);
+
+        case VALIDATOR_CHOICE:
+            return check_choice(validator, value);
+
+        case VALIDATOR_SELECTION:
+            return check_selection(validator, value);
+
+        default:
+            break;
+    }
+
+    return VALIDATOR_OK;
+}
+
+/**
+ * @name validator_strerror
+ * @brief Gives a short description of a validator status.
+ *
+ * @param [in] status: The validator status.
+ *
+ * @return Returns the description.
+ */
+const char *validator_strerror(enum validator_status status)
+{
+    if (status > VALIDATOR_INVALID_SECOND)
+        return __description[VALIDATOR_INVALID_FORMAT];
+
+    return __description[status];
+}
+
@@ -24,10 +24,17 @@
  * USA
  */
 
+#include <limits.h>
+
 #include "libxante.h"
 
 #define STEXT                               -1
 
+/*
+ * Interval, in milliseconds, to ask again for a pending input validation.
+ */
+#define CHECK_POLL_INTERVAL                 50
+
 #define VIEW_BINDINGS   \
     DLG_KEYS_DATA(DLGK_GRID_UP, KEY_UP), \
     DLG_KEYS_DATA(DLGK_GRID_DOWN, KEY_DOWN)
@@ -139,6 +146,50 @@ static int calc_string_length(const char *s,
     return len;
 }
 
+/*
+ * Validates the input, giving the attribute to display it. While the check
+ * function can't give an answer the current attribute is kept and both
+ * windows stop blocking on keys, so we may ask again in a while.
+ */
+static bool check_input(const char *input_s, WINDOW *dialog, WINDOW *editor,
+    int (*input_check)(const char *, void *), void *data, chtype *form_attr)
+{
+#ifdef ALTERNATIVE_DIALOG
+    int ret;
+
+    if (input_check != NULL) {
+        ret = (input_check)(input_s, data);
+
+        if (ret == DLGX_INPUT_CHECK_PENDING) {
+            wtimeout(dialog, CHECK_POLL_INTERVAL);
+            wtimeout(editor, CHECK_POLL_INTERVAL);
+            return true;
+        }
+
+        wtimeout(dialog, -1);
+        wtimeout(editor, -1);
+
+        /*
+         * If we detect something invalid inside the string we can change its
+         * color.
+         */
+        *form_attr = (ret < 0) ? inputbox_error_attr : form_active_text_attr;
+
+        return false;
+    }
+#else
+    (void)input_s;
+    (void)dialog;
+    (void)editor;
+    (void)input_check;
+    (void)data;
+#endif
+
+    *form_attr = form_active_text_attr;
+
+    return false;
+}
+
 /*
  *
  * Internal API
@@ -155,7 +206,8 @@ static int calc_string_length(const char *s,
  *
  * This dialog can also validate the input text by showing to the user a
  * wrong status, changing the text color. This feature is enabled when using
- * \a input_check.
+ * \a input_check. If it returns DLGX_INPUT_CHECK_PENDING the validation is
+ * asked again, for the same text, until a result is available.
  *
  * At the inputbox line is displayed the maximum number of input characters
  * and the number of "consumed" characters (as the user types inside it).
@@ -214,7 +266,8 @@ int dlgx_inputbox(int width, int height, const char *title,
     struct dlgx_text t;
     size_t len=0;
     char s[16]={0}, tmp[2048]={0};
-    chtype blocked_attr, form_attr;
+    chtype blocked_attr, form_attr = form_active_text_attr;
+    bool check_pending = false;
 
     if (edit == true) {
         selected_btn = dialog_vars.defaultno ? dlg_defaultno_button() : STEXT;
@@ -322,6 +375,19 @@ int dlgx_inputbox(int width, int height, const char *title,
             key = dlg_mouse_wgetch((selected_btn == STEXT) ? editor : dialog,
                                    &fkey);
 
+            /* No key was pressed while waiting for a pending validation */
+            if ((key == ERR) && check_pending) {
+                check_pending = check_input(input_s, dialog, editor,
+                                            input_check, data, &form_attr);
+
+                if (check_pending == false) {
+                    dlg_show_string(dialog, input_s, chr_offset, form_attr,
+                                    cur_y - 1, 3, width - 6, FALSE, first);
+                }
+
+                continue;
+            }
+
 #ifdef ALTERNATIVE_DIALOG
             if (key == DLG_EXIT_TIMEOUT) {
                 result = DLG_EXIT_TIMEOUT;
@@ -355,19 +421,8 @@ int dlgx_inputbox(int width, int height, const char *title,
                     continue;
                 }
 
-                if (input_check != NULL) {
-#ifdef ALTERNATIVE_DIALOG
-                    /*
-                     * If we detect something invalid inside the string we can
-                     * change its color.
-                     */
-                    if ((input_check)(input_s, data) < 0)
-                        form_attr = inputbox_error_attr;
-                    else
-                        form_attr = form_active_text_attr;
-#endif
-                } else
-                    form_attr = form_active_text_attr;
+                check_pending = check_input(input_s, dialog, editor,
+                                            input_check, data, &form_attr);
 
                 /* Updates string */
                 dlg_show_string(dialog, input_s, chr_offset, form_attr,
@@ -435,6 +490,7 @@ int dlgx_inputbox(int width, int height, const char *title,
         }
     }
 
+    wtimeout(dialog, -1);
     dlg_del_window(counter);
     dlg_unregister_window(editor);
     dlg_del_window(editor);
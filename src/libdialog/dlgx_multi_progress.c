@@ -0,0 +1,157 @@
+
+/*
+ * Description:
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 10:12:37 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include "libxante.h"
+
+#define MIN_HIGH                (4)
+#define MIN_WIDE                (10 + 2 * (2 + MARGIN))
+
+/* Rows used by the window borders and the aggregate bar box */
+#define AGGREGATE_ROWS          (5)
+
+/*
+ *
+ * Internal functions
+ *
+ */
+
+/*
+ * Draws a single bar, @width columns wide, with its percentage centered
+ * over it. A negative @percent marks a task which has been aborted.
+ */
+static void draw_bar(WINDOW *dialog, int y, int x, int width, int percent)
+{
+    int i, filled;
+
+    (void)wmove(dialog, y, x);
+    wattrset(dialog, title_attr);
+
+    for (i = 0; i < width; i++)
+        (void)waddch(dialog, ' ');
+
+    (void)wmove(dialog, y, x + (width / 2) - 2);
+
+    if (percent < 0) {
+        (void)wprintw(dialog, "%s", "fail");
+        return;
+    }
+
+    (void)wprintw(dialog, "%3d%%", percent);
+    filled = (min(percent, 100) * width) / 100;
+
+    if ((title_attr & A_REVERSE) != 0)
+        wattroff(dialog, A_REVERSE);
+    else
+        wattrset(dialog, A_REVERSE);
+
+    (void)wmove(dialog, y, x);
+
+    for (i = 0; i < filled; i++) {
+        chtype ch = winch(dialog);
+
+        if (title_attr & A_REVERSE)
+            ch &= ~A_REVERSE;
+
+        (void)waddch(dialog, ch);
+    }
+}
+
+/*
+ *
+ * Internal API
+ *
+ */
+
+/**
+ * @name dlgx_multi_progress
+ * @brief Creates a progress object with several bars.
+ *
+ * Every task gets its own labeled bar, drawn above a boxed bar holding the
+ * aggregate of all of them.
+ *
+ * @param [in] title: Object window title.
+ * @param [in] cprompt: Object message to be displayed.
+ * @param [in] height: Window height.
+ * @param [in] width: Window width.
+ * @param [in] labels: The name of each task.
+ * @param [in] percents: The consumed percentage of each task.
+ * @param [in] count: The number of tasks.
+ * @param [in] total: The aggregate percentage.
+ *
+ * @return Returns DLG_EXIT_OK (always).
+ */
+int dlgx_multi_progress(const char *title, const char *cprompt, int height,
+    int width, const char **labels, const int *percents, int count, int total)
+{
+    int i, x, y, label_width, bar_width;
+    char *prompt = dlg_strclone(cprompt);
+    WINDOW *dialog;
+
+    curs_set(0);
+    dlg_tab_correct_str(prompt);
+    dlg_auto_size(title, prompt, &height, &width, MIN_HIGH + count, MIN_WIDE);
+    dlg_print_size(height, width);
+    dlg_ctl_size(height, width);
+
+    /* center dialog box on screen */
+    x = dlg_box_x_ordinate(width);
+    y = dlg_box_y_ordinate(height);
+
+    dialog = dlg_new_window(height, width, y, x);
+    (void)werase(dialog);
+    dlg_draw_box(dialog, 0, 0, height, width, dialog_attr, border_attr);
+    dlg_draw_title(dialog, title);
+    wattrset(dialog, dialog_attr);
+
+    /* The prompt may only use the rows above the task bars */
+    dlg_print_autowrap(dialog, prompt, height - count, width);
+
+    label_width = (width - 2 * (2 + MARGIN)) / 3;
+    bar_width = width - 2 * (2 + MARGIN) - label_width - 1;
+
+    for (i = 0; i < count; i++) {
+        y = height - AGGREGATE_ROWS - count + i;
+        wattrset(dialog, dialog_attr);
+        (void)wmove(dialog, y, 2 + MARGIN);
+        (void)wprintw(dialog, "%-*.*s", label_width, label_width, labels[i]);
+        draw_bar(dialog, y, 2 + MARGIN + label_width + 1, bar_width,
+                 percents[i]);
+    }
+
+    wattrset(dialog, dialog_attr);
+    dlg_draw_box(dialog, height - 4, 2 + MARGIN, 2 + MARGIN,
+                 width - 2 * (2 + MARGIN), dialog_attr, border_attr);
+
+    draw_bar(dialog, height - 3, 4, width - 2 * (3 + MARGIN), total);
+
+    (void)wrefresh(dialog);
+    curs_set(1);
+    dlg_del_window(dialog);
+    free(prompt);
+
+    return DLG_EXIT_OK;
+}
+
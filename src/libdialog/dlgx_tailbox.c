@@ -0,0 +1,472 @@
+
+/*
+ * Description: A tailbox dialog which is notified by the kernel (inotify)
+ *              when its file changes, instead of polling it.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 09:12:40 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+
+#include "libxante.h"
+
+#define NAVIGATE_BINDINGS \
+    DLG_KEYS_DATA(DLGK_FIELD_NEXT, KEY_RIGHT), \
+    DLG_KEYS_DATA(DLGK_FIELD_NEXT, TAB), \
+    DLG_KEYS_DATA(DLGK_FIELD_PREV, KEY_LEFT), \
+    DLG_KEYS_DATA(DLGK_FIELD_PREV, KEY_BTAB)
+
+/* Number of discarded columns inside the text window */
+#define INTERNAL_H_MARGIN                   6
+
+/* Maximum number of bytes from the file end that we keep in memory */
+#define TAIL_BUFFER_SIZE                    65536
+
+/* Minimum interval between two screen redraws, in milliseconds */
+#define TAIL_REDRAW_INTERVAL                100
+
+/* Interval to check the dialog timeout while nothing happens */
+#define TAIL_IDLE_INTERVAL                  1000
+
+/* Events that we want to know about the file itself */
+#define TAIL_FILE_EVENTS                    \
+    (IN_MODIFY | IN_MOVE_SELF | IN_DELETE_SELF)
+
+/* Events that we want to know about the file directory (rotation) */
+#define TAIL_DIR_EVENTS                     \
+    (IN_CREATE | IN_MOVED_TO)
+
+struct tail_file {
+    const char  *pathname;
+    const char  *name;
+    int         ifd;
+    int         file_wd;
+    int         dir_wd;
+    int         fd;
+    off_t       offset;
+
+    /* The last TAIL_BUFFER_SIZE bytes read from the file */
+    char        *data;
+    size_t      size;
+};
+
+/*
+ *
+ * Internal functions
+ *
+ */
+
+static void tail_append(struct tail_file *tf, const char *s, size_t n)
+{
+    size_t drop;
+
+    if (n >= TAIL_BUFFER_SIZE) {
+        s += n - TAIL_BUFFER_SIZE;
+        n = TAIL_BUFFER_SIZE;
+        tf->size = 0;
+    }
+
+    if (tf->size + n > TAIL_BUFFER_SIZE) {
+        drop = tf->size + n - TAIL_BUFFER_SIZE;
+        memmove(tf->data, tf->data + drop, tf->size - drop);
+        tf->size -= drop;
+    }
+
+    memcpy(tf->data + tf->size, s, n);
+    tf->size += n;
+}
+
+/*
+ * Reads only the bytes appended to the file since the last time we've been
+ * here. If the file got smaller it was truncated, so we start again from its
+ * beginning.
+ *
+ * Returns true if something new was read.
+ */
+static bool tail_read(struct tail_file *tf)
+{
+    struct stat st;
+    char chunk[4096];
+    ssize_t n;
+    bool changed = false;
+
+    if (tf->fd < 0)
+        return false;
+
+    if (fstat(tf->fd, &st) < 0)
+        return false;
+
+    /* Truncated: what we're displaying isn't inside the file anymore */
+    if (st.st_size < tf->offset) {
+        tf->offset = 0;
+        tf->size = 0;
+        changed = true;
+    }
+
+    while ((n = pread(tf->fd, chunk, sizeof(chunk), tf->offset)) > 0) {
+        tail_append(tf, chunk, n);
+        tf->offset += n;
+        changed = true;
+    }
+
+    return changed;
+}
+
+static void tail_close(struct tail_file *tf)
+{
+    if (tf->fd < 0)
+        return;
+
+    if (tf->file_wd >= 0) {
+        inotify_rm_watch(tf->ifd, tf->file_wd);
+        tf->file_wd = -1;
+    }
+
+    close(tf->fd);
+    tf->fd = -1;
+}
+
+/*
+ * Opens the file and starts watching it. When @skip_old is true, only the last
+ * TAIL_BUFFER_SIZE bytes of the file are read.
+ */
+static int tail_open(struct tail_file *tf, bool skip_old)
+{
+    struct stat st;
+
+    tf->fd = open(tf->pathname, O_RDONLY | O_CLOEXEC);
+
+    if (tf->fd < 0)
+        return -1;
+
+    tf->offset = 0;
+
+    if (skip_old && (fstat(tf->fd, &st) == 0) &&
+        (st.st_size > TAIL_BUFFER_SIZE))
+    {
+        tf->offset = st.st_size - TAIL_BUFFER_SIZE;
+    }
+
+    tf->file_wd = inotify_add_watch(tf->ifd, tf->pathname, TAIL_FILE_EVENTS);
+
+    if (tf->file_wd < 0) {
+        close(tf->fd);
+        tf->fd = -1;
+        return -1;
+    }
+
+    return 0;
+}
+
+static void tail_uninit(struct tail_file *tf)
+{
+    tail_close(tf);
+
+    if (tf->ifd >= 0)
+        close(tf->ifd);
+
+    if (tf->data != NULL)
+        free(tf->data);
+}
+
+static int tail_init(struct tail_file *tf, const char *pathname)
+{
+    char *dir = NULL, *p;
+
+    memset(tf, 0, sizeof(struct tail_file));
+    tf->fd = -1;
+    tf->file_wd = -1;
+    tf->dir_wd = -1;
+    tf->pathname = pathname;
+    tf->ifd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (tf->ifd < 0)
+        return -1;
+
+    tf->data = malloc(TAIL_BUFFER_SIZE);
+
+    if (NULL == tf->data)
+        goto error_block;
+
+    /*
+     * We also watch the file directory, so we know when a rotated file is
+     * created again.
+     */
+    p = strrchr(pathname, '/');
+
+    if (NULL == p) {
+        tf->name = pathname;
+        tf->dir_wd = inotify_add_watch(tf->ifd, ".", TAIL_DIR_EVENTS);
+    } else {
+        tf->name = p + 1;
+        dir = strndup(pathname, (p == pathname) ? 1 : p - pathname);
+
+        if (NULL == dir)
+            goto error_block;
+
+        tf->dir_wd = inotify_add_watch(tf->ifd, dir, TAIL_DIR_EVENTS);
+        free(dir);
+    }
+
+    if (tail_open(tf, true) < 0)
+        goto error_block;
+
+    tail_read(tf);
+
+    return 0;
+
+error_block:
+    tail_uninit(tf);
+    return -1;
+}
+
+/*
+ * Handles all pending inotify events.
+ *
+ * Returns true if new content was read from the file.
+ */
+static bool tail_handle_events(struct tail_file *tf)
+{
+    char buffer[4096]
+        __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    const struct inotify_event *ev;
+    ssize_t len;
+    char *p;
+    bool changed = false;
+
+    while ((len = read(tf->ifd, buffer, sizeof(buffer))) > 0) {
+        for (p = buffer; p < buffer + len;
+             p += sizeof(struct inotify_event) + ev->len)
+        {
+            ev = (const struct inotify_event *)p;
+
+            if ((ev->wd == tf->file_wd) && (tf->file_wd >= 0)) {
+                if (ev->mask & IN_MODIFY)
+                    changed |= tail_read(tf);
+
+                if (ev->mask & (IN_MOVE_SELF | IN_DELETE_SELF)) {
+                    /* Rotated: get whatever was left and wait for the new one */
+                    changed |= tail_read(tf);
+
+                    if (ev->mask & IN_DELETE_SELF)
+                        tf->file_wd = -1; /* Already removed by the kernel */
+
+                    tail_close(tf);
+                }
+            } else if ((ev->wd == tf->dir_wd) && (ev->len > 0) &&
+                       (ev->mask & TAIL_DIR_EVENTS) &&
+                       (strcmp(ev->name, tf->name) == 0))
+            {
+                tail_close(tf);
+
+                if (tail_open(tf, false) == 0)
+                    changed |= tail_read(tf);
+            }
+        }
+    }
+
+    return changed;
+}
+
+/*
+ * Puts the last lines from the buffer inside the view window. Lines bigger
+ * than the window are cut.
+ */
+static void tail_draw(WINDOW *view, const struct tail_file *tf, int lines,
+    int columns)
+{
+    const char *start, *end, *eol;
+    int i, n = 0, len;
+
+    end = tf->data + tf->size;
+
+    if ((end > tf->data) && (end[-1] == '\n'))
+        end--;
+
+    start = end;
+
+    while (start > tf->data) {
+        if ((start[-1] == '\n') && (++n == lines))
+            break;
+
+        start--;
+    }
+
+    wattrset(view, dialog_attr);
+    werase(view);
+
+    for (i = 0; (i < lines) && (start < end); i++) {
+        eol = memchr(start, '\n', end - start);
+        len = (eol != NULL) ? eol - start : end - start;
+        mvwaddnstr(view, i, 0, start, min(len, columns));
+        start = (eol != NULL) ? eol + 1 : end;
+    }
+
+    wnoutrefresh(view);
+}
+
+/*
+ *
+ * Internal API
+ *
+ */
+
+/**
+ * @name dlgx_tailbox
+ * @brief Creates a dialog to follow the end of a file.
+ *
+ * The file is watched through inotify, so the dialog sleeps until something
+ * is appended to it, and only the new bytes are read. Truncated and rotated
+ * files are followed by their name. Screen redraws are limited to one for
+ * each TAIL_REDRAW_INTERVAL milliseconds.
+ *
+ * @param [in] width: Window width.
+ * @param [in] height: Window height.
+ * @param [in] title: Window title.
+ * @param [in] pathname: The file to be followed.
+ *
+ * @return Returns libdialog's default return values of a selected button or
+ *         DLG_EXIT_ERROR if the file could not be watched.
+ */
+int dlgx_tailbox(int width, int height, const char *title,
+    const char *pathname)
+{
+    static DLG_KEYS_BINDING dialog_b[] = {
+        ENTERKEY_BINDINGS,
+        NAVIGATE_BINDINGS,
+        END_KEYS_BINDING
+    };
+
+    WINDOW *dialog, *view;
+    const char **buttons_str = dlg_exit_label();
+    int result = DLG_EXIT_UNKNOWN, key = 0, fkey = 0, dlg_x, dlg_y,
+        view_lines, view_columns;
+    bool dirty = false;
+    cl_timeout_t *redraw = NULL, *dlg_timeout = NULL;
+    struct tail_file tf;
+    struct pollfd fds[2];
+
+    if (tail_init(&tf, pathname) < 0)
+        return DLG_EXIT_ERROR;
+
+    dlg_y = dlg_box_y_ordinate(height);
+    dlg_x = dlg_box_x_ordinate(width);
+    view_lines = height - 6;
+    view_columns = width - INTERNAL_H_MARGIN;
+    redraw = cl_timeout_create(TAIL_REDRAW_INTERVAL, CL_TM_MSECONDS);
+
+    if (dialog_vars.timeout_secs)
+        dlg_timeout = cl_timeout_create(dialog_vars.timeout_secs, CL_TM_SECONDS);
+
+    /* main window */
+    dialog = dlg_new_window(height, width, dlg_y, dlg_x);
+    dlg_register_window(dialog, "dlg_tailbox", dialog_b);
+    dlg_draw_box(dialog, 0, 0, height, width, dialog_attr, border_attr);
+    dlg_draw_bottom_box(dialog);
+    dlg_draw_title(dialog, title);
+    dlg_draw_box(dialog, 1, 2, height - 4, width - 4, border2_attr,
+                 border2_attr);
+
+    view = dlg_sub_window(dialog, view_lines, view_columns, dlg_y + 2,
+                          dlg_x + 3);
+
+    dlg_draw_buttons(dialog, height - 2, 0, buttons_str, 0, FALSE, width);
+    tail_draw(view, &tf, view_lines, view_columns);
+    wrefresh(dialog);
+
+    fds[0].fd = STDIN_FILENO;
+    fds[0].events = POLLIN;
+    fds[1].fd = tf.ifd;
+    fds[1].events = POLLIN;
+
+    while (result == DLG_EXIT_UNKNOWN) {
+        if (dirty && cl_timeout_expired(redraw)) {
+            tail_draw(view, &tf, view_lines, view_columns);
+            wrefresh(dialog);
+            cl_timeout_reset(redraw, TAIL_REDRAW_INTERVAL, CL_TM_MSECONDS);
+            dirty = false;
+        }
+
+        /* Sleeps until a key is pressed, the file changes or a redraw is due */
+        if (poll(fds, 2, dirty ? TAIL_REDRAW_INTERVAL
+                               : TAIL_IDLE_INTERVAL) < 0)
+        {
+            continue;
+        }
+
+        if (fds[1].revents & POLLIN)
+            dirty |= tail_handle_events(&tf);
+
+        if (fds[0].revents & POLLIN) {
+            key = dlg_mouse_wgetch_nowait(dialog, &fkey);
+
+#ifdef ALTERNATIVE_DIALOG
+            if (key == DLG_EXIT_TIMEOUT) {
+                result = DLG_EXIT_TIMEOUT;
+                break;
+            }
+#endif
+
+            /* Clears the internal library timeout */
+            if (dialog_vars.timeout_secs) {
+                cl_timeout_reset(dlg_timeout, dialog_vars.timeout_secs,
+                                 CL_TM_SECONDS);
+            }
+
+            if (dlg_result_key(key, fkey, &result))
+                break;
+        } else {
+            /* Checks the internal library timeout */
+            if (dialog_vars.timeout_secs)
+                if (cl_timeout_expired(dlg_timeout) == true) {
+#ifdef ALTERNATIVE_DIALOG
+                    result = DLG_EXIT_TIMEOUT;
+#endif
+                    break;
+                }
+        }
+
+        if (fkey) {
+            if (key == DLGK_ENTER)
+                result = DLG_EXIT_OK;
+
+            fkey = 0;
+        }
+    }
+
+    if (dlg_timeout != NULL)
+        cl_timeout_destroy(dlg_timeout);
+
+    if (redraw != NULL)
+        cl_timeout_destroy(redraw);
+
+    tail_uninit(&tf);
+    dlg_del_window(view);
+
+    return dlgx_cleanup_result(result, dialog);
+}
+
@@ -33,11 +33,19 @@
 # endif
 #endif
 
+#include "line_scan.h"
+
 #define MAX_CELL_DATA                       512
 
 /* Default maximum number of items of a dialog */
 #define MAX_DLG_ITEMS                       15
 
+/*
+ * Returned by an inputbox check function when it can't tell yet if the input
+ * is valid. The inputbox asks again for it in a while.
+ */
+#define DLGX_INPUT_CHECK_PENDING            INT_MIN
+
 /* Gets the number of items from a dialog */
 #define dlgx_get_dlg_items(a)               \
     ((a) > MAX_DLG_ITEMS ? MAX_DLG_ITEMS : (a))
@@ -121,7 +129,6 @@ void dlgx_put_item_brief(const char *brief);
 void dlgx_uninit(struct xante_app *xpp);
 void dlgx_init(bool temporarily);
 void dlgx_set_backtitle(struct xante_app *xpp);
-char *dlgx_get_item_value_as_text(const struct xante_item *item);
 int dlgx_count_lines_by_delimiters(const char *text);
 int dlgx_count_lines(const char *text, int width);
 void dlgx_update_cancel_button_label(const cl_string_t *label);
@@ -141,6 +148,11 @@ void dlgx_session_uninit(const struct xante_item *item);
 int dlgx_simple_progress(const char *title, const char *cprompt, int height,
                          int width, int percent);
 
+/* multi progress */
+int dlgx_multi_progress(const char *title, const char *cprompt, int height,
+                        int width, const char **labels, const int *percents,
+                        int count, int total);
+
 /* scrolltext */
 int dlgx_scrolltext(int width, int height, const char *title,
                     const char *subtitle, const char *text);
@@ -164,6 +176,10 @@ const char *spreadsheet_st_get_data(struct dlgx_spreadsheet_st *table, int pos);
 int dlgx_spreadsheet(const char *title, const char *subtitle,
                      struct dlgx_spreadsheet_st *table);
 
+/* tailbox */
+int dlgx_tailbox(int width, int height, const char *title,
+                 const char *pathname);
+
 /* update object */
 int dlgx_update_object(int width, int height, const char *title,
                        const char *subtitle, int update_interval,
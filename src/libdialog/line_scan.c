@@ -0,0 +1,182 @@
+/*
+ * Description: Scans texts looking for line delimiters.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 20:41:07 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <stdlib.h>
+
+#if defined(__AVX2__)
+# include <immintrin.h>
+#elif defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
+/*
+ * This file does not depend on the rest of the library, so it can also be
+ * built by the benchmark inside examples/.
+ */
+#include "line_scan.h"
+
+/* Initial number of entries of a line offsets table */
+#define LINE_SCAN_INITIAL_SIZE          16
+
+/*
+ *
+ * Internal functions
+ *
+ */
+
+#if defined(__SSE2__)
+/*
+ * Handles a block bitmask, where each bit set means a delimiter at
+ * @base + bit position. When @scan is NULL we're only counting.
+ */
+static int line_scan_mask(struct dlgx_line_scan *scan, unsigned int mask,
+    size_t base, int *count)
+{
+    if (NULL == scan) {
+        *count += __builtin_popcount(mask);
+        return 0;
+    }
+
+    while (mask != 0) {
+        if (dlgx_line_scan_push(scan, base + __builtin_ctz(mask) + 1) < 0)
+            return -1;
+
+        (*count)++;
+        mask &= mask - 1;
+    }
+
+    return 0;
+}
+#endif
+
+/*
+ *
+ * Internal API
+ *
+ */
+
+/**
+ * @name dlgx_line_scan_push
+ * @brief Appends an offset to a line offsets table.
+ *
+ * @param [in,out] scan: The table.
+ * @param [in] offset: The offset.
+ *
+ * @return Returns 0 on success or -1 otherwise.
+ */
+int dlgx_line_scan_push(struct dlgx_line_scan *scan, int offset)
+{
+    int *p = NULL, n;
+
+    if (scan->size == scan->allocated) {
+        n = (scan->allocated == 0) ? LINE_SCAN_INITIAL_SIZE
+                                   : scan->allocated * 2;
+
+        p = realloc(scan->offsets, n * sizeof(int));
+
+        if (NULL == p)
+            return -1;
+
+        scan->offsets = p;
+        scan->allocated = n;
+    }
+
+    scan->offsets[scan->size] = offset;
+    scan->size++;
+
+    return 0;
+}
+
+/**
+ * @name dlgx_scan_delimiters
+ * @brief Scans a text looking for line delimiters in a single pass.
+ *
+ * Blocks of 32 or 16 bytes are compared at once when the compiler enables
+ * AVX2 or SSE2.
+ *
+ * @param [in] text: The text.
+ * @param [in] len: The text length.
+ * @param [in] d1: A delimiter.
+ * @param [in] d2: Another delimiter (it may be the same as @d1).
+ * @param [in,out] scan: If not NULL the index right after each delimiter
+ *                       found is stored inside it.
+ *
+ * @return Returns the number of delimiters found or -1 on error.
+ */
+int dlgx_scan_delimiters(const char *text, size_t len, char d1, char d2,
+    struct dlgx_line_scan *scan)
+{
+    size_t i = 0;
+    int count = 0;
+
+#if defined(__AVX2__)
+    const __m256i v1 = _mm256_set1_epi8(d1), v2 = _mm256_set1_epi8(d2);
+    __m256i b;
+
+    for (; i + 32 <= len; i += 32) {
+        b = _mm256_loadu_si256((const __m256i *)&text[i]);
+
+        if (line_scan_mask(scan,
+                           (unsigned int)_mm256_movemask_epi8(
+                                _mm256_or_si256(_mm256_cmpeq_epi8(b, v1),
+                                                _mm256_cmpeq_epi8(b, v2))),
+                           i, &count) < 0)
+        {
+            return -1;
+        }
+    }
+#endif
+
+#if defined(__SSE2__)
+    const __m128i w1 = _mm_set1_epi8(d1), w2 = _mm_set1_epi8(d2);
+    __m128i c;
+
+    for (; i + 16 <= len; i += 16) {
+        c = _mm_loadu_si128((const __m128i *)&text[i]);
+
+        if (line_scan_mask(scan,
+                           (unsigned int)_mm_movemask_epi8(
+                                _mm_or_si128(_mm_cmpeq_epi8(c, w1),
+                                             _mm_cmpeq_epi8(c, w2))),
+                           i, &count) < 0)
+        {
+            return -1;
+        }
+    }
+#endif
+
+    for (; i < len; i++) {
+        if ((text[i] != d1) && (text[i] != d2))
+            continue;
+
+        if ((scan != NULL) && (dlgx_line_scan_push(scan, i + 1) < 0))
+            return -1;
+
+        count++;
+    }
+
+    return count;
+}
+
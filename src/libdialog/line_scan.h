@@ -0,0 +1,46 @@
+/*
+ * Description: Scans texts looking for line delimiters.
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 20:41:07 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#ifndef _LIBXANTE_LIBDIALOG_LINE_SCAN_H
+#define _LIBXANTE_LIBDIALOG_LINE_SCAN_H
+
+#include <stddef.h>
+
+/*
+ * Holds every offset found while scanning a text for line delimiters. The
+ * table grows geometrically so a long text only triggers a few reallocations.
+ */
+struct dlgx_line_scan {
+    int     *offsets;
+    int     size;
+    int     allocated;
+};
+
+int dlgx_line_scan_push(struct dlgx_line_scan *scan, int offset);
+int dlgx_scan_delimiters(const char *text, size_t len, char d1, char d2,
+                         struct dlgx_line_scan *scan);
+
+#endif
+
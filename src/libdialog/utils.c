@@ -75,40 +75,30 @@ static int get_longest_line_length(const cl_string_t *text)
  * screen with size limited by @t.
  *
  */
-static int count_lines(const char *text, struct dlgx_text *t)
+static int count_lines(const char *text, size_t len, struct dlgx_text *t)
 {
-    int l=0;
-    size_t i, len;
-
-    len = strlen(text);
+    struct dlgx_line_scan scan = { NULL, 0, 0 };
+    int l;
 
     /*
      * We initialize the array with the inicial index of the first line,
      * which must always be 0 ;-).
      */
-    t->line_breaks_inside_text = realloc(t->line_breaks_inside_text,
-                                         (l + 1) * sizeof(int));
-
-    if (!t->line_breaks_inside_text)
+    if (dlgx_line_scan_push(&scan, 0) < 0)
         return -1;
 
-    t->line_breaks_inside_text[0] = 0;
-
     /*
      * Stores the index of every line break found in t->line_breaks_inside_text
      * to ease its future copies.
      */
-    for (i = 0; i < len; i++)
-        if ((text[i] == '\n')) {
-            t->line_breaks_inside_text = realloc(t->line_breaks_inside_text,
-                                                 (l + 2) * sizeof(int));
+    l = dlgx_scan_delimiters(text, len, '\n', '\n', &scan);
 
-            if (!t->line_breaks_inside_text)
-                return -1;
+    if (l < 0) {
+        free(scan.offsets);
+        return -1;
+    }
 
-            t->line_breaks_inside_text[l + 1] = (text[i] == '\n') ? i + 1 : i;
-            l++; /* number of lines */
-        }
+    t->line_breaks_inside_text = scan.offsets;
 
     if (len % t->maximum_columns_of_line)
         l++;
@@ -119,9 +109,9 @@ static int count_lines(const char *text, struct dlgx_text *t)
 /*
  * Splits a string in lines to fit a specific screen width.
  */
-static void split_text(struct dlgx_text *t, const char *text)
+static void split_text(struct dlgx_text *t, const char *text, size_t len)
 {
-    int i, size;
+    int i, size, l;
 
     t->text = malloc(t->total_lines * sizeof(char *));
 
@@ -140,7 +130,7 @@ static void split_text(struct dlgx_text *t, const char *text)
          * difference between the total size and its current position.
          */
         if (i == (t->total_lines - 1))
-            size = strlen(text) - t->line_breaks_inside_text[i];
+            size = len - t->line_breaks_inside_text[i];
         else {
             size = t->line_breaks_inside_text[i + 1] -
                     t->line_breaks_inside_text[i];
@@ -157,10 +147,10 @@ static void split_text(struct dlgx_text *t, const char *text)
                 t->text[i][size - 1] = '\0';
         }
 
-        if (strlen(t->text[i]) < (size_t)t->maximum_columns_of_line) {
-            memset(&t->text[i][strlen(t->text[i])], ' ',
-                   t->maximum_columns_of_line - strlen(t->text[i]));
-        }
+        l = strlen(t->text[i]);
+
+        if (l < t->maximum_columns_of_line)
+            memset(&t->text[i][l], ' ', t->maximum_columns_of_line - l);
     }
 }
 
@@ -257,6 +247,8 @@ static int clear_backtitle(xante_t *xpp)
 int dlgx_text_init(WINDOW *window, struct dlgx_text *t, int height, int width,
     const char *text)
 {
+    size_t len;
+
     /* Saves current cursor position. */
     getyx(window, t->y, t->x);
 
@@ -267,13 +259,13 @@ int dlgx_text_init(WINDOW *window, struct dlgx_text *t, int height, int width,
     t->current_line_start_index = 0;
     t->current_line_final_index = 0;
     t->line_breaks_inside_text = NULL;
-
-    t->total_lines = count_lines(text, t);
+    len = strlen(text);
+    t->total_lines = count_lines(text, len, t);
 
     if (t->total_lines < 0)
         return -1;
 
-    split_text(t, text);
+    split_text(t, text, len);
 
     return 0;
 }
@@ -413,16 +405,10 @@ void dlgx_text_clear(WINDOW *window, struct dlgx_text *t)
  */
 int dlgx_get_subtitle_lines(const char *s)
 {
-    cl_string_t *tmp = NULL;
-    int c = 0;
-
-    if (s != NULL) {
-        tmp = cl_string_create("%s", s);
-        c = cl_string_cchr(tmp, '\n');
-        cl_string_unref(tmp);
-    }
+    if (NULL == s)
+        return 0;
 
-    return c;
+    return dlgx_scan_delimiters(s, strlen(s), '\n', '\n', NULL);
 }
 
 /**
@@ -532,70 +518,6 @@ void dlgx_set_backtitle(struct xante_app *xpp)
     dlg_put_backtitle();
 }
 
-/**
- * @name dlgx_get_item_value_as_text
- * @brief Gives an item current value as a text string.
- *
- * The function checks if the item has a value loaded from the JTF file (default
- * value) or from the configuration file (value).
- *
- * @param [in] item: The item.
- *
- * @return Case it's an item that may hold a value it's returned as a string
- *         (which must be released after use) or NULL otherwise.
- */
-char *dlgx_get_item_value_as_text(const struct xante_item *item)
-{
-    char *text = NULL;
-    cl_string_t *value = NULL;
-    int index = -1;
-
-    switch (item->widget_type) {
-        case XANTE_WIDGET_INPUT_INT:
-        case XANTE_WIDGET_INPUT_FLOAT:
-        case XANTE_WIDGET_INPUT_DATE:
-        case XANTE_WIDGET_INPUT_TIME:
-        case XANTE_WIDGET_CALENDAR:
-        case XANTE_WIDGET_TIMEBOX:
-        case XANTE_WIDGET_INPUT_STRING:
-        case XANTE_WIDGET_RANGE:
-        case XANTE_WIDGET_INPUTSCROLL:
-            value = cl_object_to_cstring(item_value(item));
-
-            if ((value != NULL) && (cl_string_length(value) > 0))
-                text = strdup(cl_string_valueof(value));
-
-            break;
-
-        case XANTE_WIDGET_RADIO_CHECKLIST:
-            index = CL_OBJECT_AS_INT(item_value(item));
-            value = cl_stringlist_get(item->list_items, index);
-
-            if (value != NULL)
-                text = strdup(cl_string_valueof(value));
-
-            break;
-
-        case XANTE_WIDGET_YES_NO:
-            index = CL_OBJECT_AS_INT(item_value(item));
-
-            if (index == 1)
-                text = strdup(cl_tr("Yes"));
-            else
-                text = strdup(cl_tr("No"));
-
-            break;
-
-        default:
-            break;
-    }
-
-    if (value != NULL)
-        cl_string_unref(value);
-
-    return text;
-}
-
 /**
  * @name dlgx_count_lines_by_delimiters
  * @brief Counts the number of lines of a string by looking at some delimiters.
@@ -610,14 +532,12 @@ char *dlgx_get_item_value_as_text(const struct xante_item *item)
 int dlgx_count_lines_by_delimiters(const char *text)
 {
     int c = 0;
-    cl_string_t *tmp = NULL;
 
     if (NULL == text)
         return 0; /* No lines */
 
-    tmp = cl_string_create("%s", text);
-    c = cl_string_cchr(tmp, '\n') + cl_string_cchr(tmp, XANTE_STR_LINE_BREAK);
-    cl_string_unref(tmp);
+    c = dlgx_scan_delimiters(text, strlen(text), '\n', XANTE_STR_LINE_BREAK,
+                             NULL);
 
     if (c == 0)
         return 1; /* No delimiter was found. We have one line. */
@@ -844,23 +764,23 @@ void dlgx_session_init(struct xante_app *xpp, const struct xante_item *item,
         /* Enables the help button */
         if (item->descriptive_help != NULL) {
             dialog_vars.help_button = 1;
-            dlgx_update_help_button_label(item->label.help);
+            dlgx_update_help_button_label(item->details->label.help);
         }
 
         /*
          * Enables the extra button and does not allow this button on
          * yesno dialogs.
          */
-        if (item->button.extra &&
+        if (item->details->button.extra &&
             (item->widget_type != XANTE_WIDGET_YES_NO))
         {
-            dlgx_update_extra_button_label(item->label.extra);
+            dlgx_update_extra_button_label(item->details->label.extra);
             dialog_vars.extra_button = 1;
         }
     }
 
-    dlgx_update_ok_button_label(item->label.ok);
-    dlgx_update_cancel_button_label(item->label.cancel);
+    dlgx_update_ok_button_label(item->details->label.ok);
+    dlgx_update_cancel_button_label(item->details->label.cancel);
 }
 
 /**
@@ -875,7 +795,7 @@ void dlgx_session_uninit(const struct xante_item *item)
         dialog_vars.help_button = 0;
 
     /* Removes the Extra button off the screen */
-    if (item->button.extra)
+    if (item->details->button.extra)
         dialog_vars.extra_button = 0;
 
     if ((item->widget_type == XANTE_WIDGET_CALENDAR) ||
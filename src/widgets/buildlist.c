@@ -46,35 +46,39 @@ static int prepare_content(struct xante_item *item,
     cl_string_t *p = NULL;
     int index;
 
-    session->litems = calloc(session->number_of_items,
-                             sizeof(DIALOG_LISTITEM));
+    session->litems = session_alloc(session, session->number_of_items *
+                                             sizeof(DIALOG_LISTITEM));
 
     if (NULL == session->litems) {
         errno_set(XANTE_ERROR_NO_MEMORY);
         return -1;
     }
 
-    /* Use the default value if we don't have already selected_items */
-    if (NULL == item->selected_items) {
-        p = CL_OBJECT_AS_CSTRING(item->default_value);
-        item->selected_items = cl_string_split(p, ",");
-        cl_string_unref(p);
+    /* Use the default value if we don't have already selected options */
+    if (NULL == item->selected_options) {
+        if (item->default_value != NULL)
+            p = CL_OBJECT_AS_CSTRING(item->default_value);
+
+        item->selected_options = option_set_from_cstring(item->options_index,
+                                                         p);
+
+        if (p != NULL)
+            cl_string_unref(p);
+
+        if (NULL == item->selected_options)
+            return -1;
     }
 
     for (index = 0; index < session->number_of_items; index++) {
         listitem = &session->litems[index];
-        p = cl_stringlist_get(item->list_items, index);
 
-        listitem->text = strdup(cl_string_valueof(p));
-        listitem->name = strdup("");
-        listitem->help = strdup("");
+        listitem->text = session_strdup(session,
+                                        option_index_name(item->options_index,
+                                                          index));
 
-        if (cl_stringlist_contains(item->selected_items, p))
-            listitem->state = 1;
-        else
-            listitem->state = 0;
-
-        cl_string_unref(p);
+        listitem->name = session_strdup(session, "");
+        listitem->help = session_strdup(session, "");
+        listitem->state = option_set_contains(item->selected_options, index);
     }
 
     return 0;
@@ -90,30 +94,43 @@ static void build_session(session_t *session)
     session->height = (item->geometry.height == 0) ? DIALOG_HEIGHT
                                                    : item->geometry.height;
 
-    session->number_of_items = cl_stringlist_size(item->list_items);
+    /* An item declared without options gets an empty list */
+    session->number_of_items = option_index_size(item->options_index);
     session->displayed_items = dlgx_get_dlg_items(session->number_of_items);
 
     /* Creates the UI content */
     prepare_content(item, session);
 }
 
-static cl_string_t *get_current_result(const session_t *session)
+static struct option_set *get_current_selection(const session_t *session)
 {
+    struct option_set *selection = NULL;
     int i;
-    cl_string_t *ret = NULL;
-    DIALOG_LISTITEM *item;
 
-    ret = cl_string_create_empty(0);
+    selection = option_set_create(session->number_of_items);
 
-    for (i = 0; i < session->number_of_items; i++) {
-        item = &session->litems[i];
+    if (NULL == selection)
+        return NULL;
 
-        if (item->state == 1)
-            cl_string_cat(ret, "%s,", item->text);
-    }
+    for (i = 0; i < session->number_of_items; i++)
+        if (session->litems[i].state == 1)
+            option_set_add(selection, i);
+
+    return selection;
+}
+
+static cl_string_t *get_current_result(const session_t *session)
+{
+    struct option_set *selection = NULL;
+    cl_string_t *ret = NULL;
+
+    selection = get_current_selection(session);
+
+    if (NULL == selection)
+        return NULL;
 
-    if (cl_string_isempty(ret) == false)
-        cl_string_truncate(ret, -1);
+    ret = option_set_to_cstring(session->item->options_index, selection);
+    option_set_destroy(selection);
 
     return ret;
 }
@@ -127,28 +144,30 @@ static cl_string_t *get_current_result(const session_t *session)
 bool buildlist_value_changed(session_t *session)
 {
     struct xante_item *item = session->item;
-    cl_string_t *old_value = NULL;
+    struct option_set *selection = NULL;
     bool changed = false;
 
-    old_value = cl_stringlist_flat(item->selected_items, ',');
+    selection = get_current_selection(session);
 
-    if (cl_string_cmp(old_value, session->result)) {
+    if (NULL == selection)
+        return false;
+
+    /* Only the chosen options matter, not the order they were saved */
+    if (option_set_equals(item->selected_options, selection) == false) {
         changed = true;
 
          /* Set up details to save inside the internal changes list */
         session->change_item_name = cl_string_ref(item->name);
-        session->change_old_value = cl_string_ref(old_value);
+        session->change_old_value =
+            option_set_to_cstring(item->options_index, item->selected_options);
+
         session->change_new_value = cl_string_ref(session->result);
 
        /* Updates the item value */
-        if (old_value != NULL)
-            cl_stringlist_destroy(item->selected_items);
-
-        item->selected_items = cl_string_split(session->result, ",");
-    }
-
-    if (old_value != NULL)
-        cl_string_unref(old_value);
+        option_set_destroy(item->selected_options);
+        item->selected_options = selection;
+    } else
+        option_set_destroy(selection);
 
     return changed;
 }
@@ -109,6 +109,8 @@ void calendar_update_value(session_t *session)
         item->value = cl_object_from_cstring(session->result);
     else
         cl_object_set(item->value, cl_string_valueof(session->result));
+
+    item_value_updated(item);
 }
 
 /**
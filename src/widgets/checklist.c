@@ -38,43 +38,78 @@
  *
  */
 
+/*
+ * Decodes a selection, as saved inside the item value, into a bitset. A
+ * radio checklist holds just the selected index.
+ */
+static struct xante_bitset *selection_from_cstring(const struct xante_item *item,
+    const cl_string_t *value, int total_items)
+{
+    struct xante_bitset *selection = NULL;
+
+    if (item->widget_checklist_type == FLAG_CHECK)
+        return bitset_from_cstring(value, total_items);
+
+    selection = bitset_create(total_items);
+
+    if ((selection != NULL) && (value != NULL))
+        bitset_set(selection, cl_string_to_int(value));
+
+    return selection;
+}
+
+static struct xante_bitset *item_selection(const struct xante_item *item,
+    int total_items)
+{
+    struct xante_bitset *selection = NULL;
+    cl_string_t *value = NULL;
+
+    if (item_value(item) != NULL)
+        value = cl_object_to_cstring(item_value(item));
+
+    selection = selection_from_cstring(item, value, total_items);
+
+    if (value != NULL)
+        cl_string_unref(value);
+
+    return selection;
+}
+
 static int prepare_content(const struct xante_item *item,
     session_t *session)
 {
     DIALOG_LISTITEM *listitem = NULL;
-    int index, current_value;
+    struct xante_bitset *selection = NULL;
+    int index;
     cl_string_t *option = NULL;
 
-    session->litems = calloc(session->number_of_items,
-                             sizeof(DIALOG_LISTITEM));
+    session->litems = session_alloc(session, session->number_of_items *
+                                             sizeof(DIALOG_LISTITEM));
 
     if (NULL == session->litems) {
         errno_set(XANTE_ERROR_NO_MEMORY);
         return -1;
     }
 
-    current_value = CL_OBJECT_AS_INT(item_value(item));
+    selection = item_selection(item, session->number_of_items);
+
+    if (NULL == selection)
+        return -1;
 
     for (index = 0; index < session->number_of_items; index++) {
         listitem = &session->litems[index];
         option = cl_stringlist_get(item->list_items, index);
 
-        listitem->name = strdup("");
-        listitem->help = strdup("");
-        listitem->text = strdup(cl_string_valueof(option));
-
-        if (((item->widget_checklist_type == FLAG_RADIO) &&
-             ((int)index == current_value)) ||
-            ((item->widget_checklist_type == FLAG_CHECK) &&
-             ((int)pow(2, index) & current_value)))
-        {
-            listitem->state = 1;
-        } else
-            listitem->state = 0;
+        listitem->name = session_strdup(session, "");
+        listitem->help = session_strdup(session, "");
+        listitem->text = session_strdup(session, cl_string_valueof(option));
+        listitem->state = bitset_test(selection, index);
 
         cl_string_unref(option);
     }
 
+    bitset_destroy(selection);
+
     return 0;
 }
 
@@ -96,7 +131,7 @@ static void build_session(const struct xante_item *item,
 }
 
 static cl_stringlist_t *get_checklist_entries(DIALOG_LISTITEM *dlg_items,
-    int total_items, int checklist_type, int selected_option)
+    const struct xante_bitset *selection)
 {
     cl_stringlist_t *selected_entries = NULL;
     cl_string_t *option = NULL;
@@ -107,54 +142,62 @@ static cl_stringlist_t *get_checklist_entries(DIALOG_LISTITEM *dlg_items,
     if (NULL == selected_entries)
         return NULL;
 
-    if (checklist_type == FLAG_RADIO) {
-        option = cl_string_create("%s", dlg_items[selected_option].text);
-        cl_stringlist_add(selected_entries, option);
-        cl_string_unref(option);
-    } else {
-        for (i = 0; i < total_items; i++) {
-            if ((int)pow(2, i) & selected_option) {
-                option = cl_string_create("%s", dlg_items[i].text);
-                cl_stringlist_add(selected_entries, option);
-                cl_string_unref(option);
-            }
+    for (i = 0; i < bitset_size(selection); i++) {
+        if (bitset_test(selection, i)) {
+            option = cl_string_create("%s", dlg_items[i].text);
+            cl_stringlist_add(selected_entries, option);
+            cl_string_unref(option);
         }
     }
 
     return selected_entries;
 }
 
-static int get_checklist_selected_value(DIALOG_LISTITEM *dlg_items,
+/*
+ * Gives the selected options in the same format that they are saved, or
+ * NULL if nothing was selected.
+ */
+static cl_string_t *get_checklist_selected_value(DIALOG_LISTITEM *dlg_items,
     int total_items, int checklist_type)
 {
-    int i, selected_value = 0;
+    struct xante_bitset *selection = NULL;
+    cl_string_t *value = NULL;
+    int i;
+
+    if (checklist_type == FLAG_RADIO) {
+        for (i = 0; i < total_items; i++)
+            if (dlg_items[i].state)
+                return cl_string_create("%d", i);
+
+        return NULL;
+    }
+
+    selection = bitset_create(total_items);
+
+    if (NULL == selection)
+        return NULL;
 
     for (i = 0; i < total_items; i++)
-        if (dlg_items[i].state) {
-            if (checklist_type == FLAG_RADIO)
-                return i;
-            else
-                selected_value += (int)pow(2, i);
-        }
+        if (dlg_items[i].state)
+            bitset_set(selection, i);
+
+    if (bitset_is_empty(selection) == false)
+        value = bitset_to_cstring(selection);
+
+    bitset_destroy(selection);
 
-    return (selected_value != 0) ? selected_value : -1;
+    return value;
 }
 
-static void add_internal_change(session_t *session, int current_value,
-    int selected_value)
+static void add_internal_change(session_t *session,
+    const struct xante_bitset *current, const struct xante_bitset *selected)
 {
     struct xante_item *item = session->item;
     DIALOG_LISTITEM *dlg_items = session->litems;
-    int total_items = session->number_of_items;
     cl_stringlist_t *current_entries = NULL, *selected_entries = NULL;
 
-    current_entries = get_checklist_entries(dlg_items, total_items,
-                                            item->widget_checklist_type,
-                                            current_value);
-
-    selected_entries = get_checklist_entries(dlg_items, total_items,
-                                             item->widget_checklist_type,
-                                             selected_value);
+    current_entries = get_checklist_entries(dlg_items, current);
+    selected_entries = get_checklist_entries(dlg_items, selected);
 
     /* Set up details to save inside the internal changes list */
     session->change_item_name = cl_string_ref(item->name);
@@ -174,10 +217,10 @@ static void update_item_brief(int current_index, void *a)
     struct xante_item *item = (struct xante_item *)a;
     cl_string_t *brief = NULL;
 
-    if (NULL == item->checklist_brief_options)
+    if (NULL == item->details->checklist_brief_options)
         return;
 
-    brief = cl_stringlist_get(item->checklist_brief_options, current_index);
+    brief = cl_stringlist_get(item->details->checklist_brief_options, current_index);
 
     if (NULL == brief)
         return;
@@ -204,17 +247,32 @@ bool checklist_validate_result(session_t *session)
 bool checklist_value_changed(session_t *session)
 {
     struct xante_item *item = session->item;
-    int current_value, selected_items;
+    struct xante_bitset *current = NULL, *selected = NULL;
     bool changed = false;
 
-    selected_items = cl_string_to_int(session->result);
-    current_value = CL_OBJECT_AS_INT(item_value(item));
+    current = item_selection(item, session->number_of_items);
+    selected = selection_from_cstring(item, session->result,
+                                      session->number_of_items);
+
+    if ((NULL == current) || (NULL == selected))
+        goto end_block;
 
-    if (current_value != selected_items) {
-        add_internal_change(session, current_value, selected_items);
+    /*
+     * Comparing the decoded selections also takes care of values saved
+     * with an older encoding.
+     */
+    if (bitset_equals(current, selected) == false) {
+        add_internal_change(session, current, selected);
         changed = true;
     }
 
+end_block:
+    if (selected != NULL)
+        bitset_destroy(selected);
+
+    if (current != NULL)
+        bitset_destroy(current);
+
     return changed;
 }
 
@@ -223,6 +281,24 @@ void checklist_update_value(session_t *session)
     struct xante_item *item = session->item;
     int selected_items;
 
+    /*
+     * A checklist selection is kept as an int while it fits in one, and in
+     * its encoded format otherwise.
+     */
+    if (item->widget_checklist_type == FLAG_CHECK) {
+        if (session->number_of_items <= BITSET_INT_BITS) {
+            selected_items =
+                bitset_cstring_to_int(cl_string_valueof(session->result));
+
+            item_set_value(item, cl_object_create(CL_INT, selected_items));
+        } else
+            item_set_value(item,
+                           cl_object_create(CL_STRING,
+                                            cl_string_valueof(session->result)));
+
+        return;
+    }
+
     selected_items = cl_string_to_int(session->result);
 
     /* Updates item value */
@@ -230,14 +306,18 @@ void checklist_update_value(session_t *session)
         item->value = cl_object_create(CL_INT, selected_items);
     else
         cl_object_set(item->value, selected_items);
+
+    item_value_updated(item);
 }
 
 /**
  * @name checklist
  * @brief Creates an object to choose an option inside a list of options.
  *
- * Since we (and libdialog) use an int variable to store the selected options,
- * we only have 32 available options.
+ * The selected options of a checklist are kept as a bitset, so there is no
+ * limit on the number of options. Its value is an int where each bit is an
+ * option, as long as there are up to 31 options. Wider selections are kept
+ * as a string with an hexadecimal number.
  *
  * @return Returns a ui_return_t value indicating if the item's value has been
  *         changed (true) or not (false) with the object selected button.
@@ -246,7 +326,8 @@ int checklist(session_t *session)
 {
     struct xante_app *xpp = session->xpp;
     struct xante_item *item = session->item;
-    int ret_dialog = DLG_EXIT_OK, selected_index = -1, selected_items;
+    int ret_dialog = DLG_EXIT_OK, selected_index = -1;
+    cl_string_t *selected_items = NULL;
 
     /* Prepares object content */
     build_session(item, session);
@@ -278,11 +359,11 @@ int checklist(session_t *session)
                                                       session->number_of_items,
                                                       item->widget_checklist_type);
 
-        if (selected_items < 0 ) {
+        if (NULL == selected_items) {
             xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
                                  "%s", cl_tr("No option was selected."));
         } else
-            session->result = cl_string_create("%d", selected_items);
+            session->result = selected_items;
     }
 
     return ret_dialog;
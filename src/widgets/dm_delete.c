@@ -41,13 +41,13 @@
 static int prepare_content(const struct xante_menu *dm_menu,
     session_t *session)
 {
-    DIALOG_LISTITEM *litems = NULL, *listitem = NULL;
+    DIALOG_LISTITEM *listitem = NULL;
     int index;
     cl_list_node_t *node = NULL;
     struct xante_item *item = NULL;
 
-    session->litems = calloc(session->number_of_items,
-                             sizeof(DIALOG_LISTITEM));
+    session->litems = session_alloc(session, session->number_of_items *
+                                             sizeof(DIALOG_LISTITEM));
 
     if (NULL == session->litems) {
         errno_set(XANTE_ERROR_NO_MEMORY);
@@ -58,16 +58,16 @@ static int prepare_content(const struct xante_menu *dm_menu,
         node = cl_list_at(dm_menu->items, index);
         item = cl_list_node_content(node);
 
-        listitem = &litems[index];
-        listitem->name = strdup("");
-        listitem->help = strdup("");
-        listitem->text = strdup(cl_string_valueof(item->name));
+        listitem = &session->litems[index];
+        listitem->name = session_strdup(session, "");
+        listitem->help = session_strdup(session, "");
+        listitem->text = session_strdup(session, cl_string_valueof(item->name));
 
         cl_list_node_unref(node);
     }
 
     /* Let the first option selected */
-    litems[0].state = 1;
+    session->litems[0].state = 1;
 
     return 0;
 }
@@ -172,7 +172,7 @@ int delete_dm(session_t *session)
 #endif
 
     if (ret_dialog == DLG_EXIT_OK) {
-        dm_delete(dm_menu, selected_index);
+        dm_delete(xpp, dm_menu, selected_index);
 
         /* We hold a simple string just to know that we have a change */
         session->result = cl_string_create("changed");
@@ -74,10 +74,7 @@ void fselect_update_value(session_t *session)
 {
     struct xante_item *item = session->item;
 
-    if (item->value != NULL)
-        cl_object_unref(item->value);
-
-    item->value = cl_object_from_cstring(session->result);
+    item_set_value(item, cl_object_from_cstring(session->result));
 }
 
 int fselect(session_t *session)
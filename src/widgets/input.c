@@ -26,17 +26,54 @@
 
 #include <limits.h>
 #include <float.h>
+#include <pthread.h>
+#include <time.h>
 
 #include "libxante.h"
 
+/* Number of module answers remembered while an inputscroll is running */
+#define INPUT_MEMO_SIZE                 64
+
+/* A module answer to a specific input content */
+struct input_memo {
+    unsigned int    hash;
+    char            *value;
+    int             result;
+};
+
+/*
+ * A EV_VALUE_CHECK event running in background. It belongs to its task, so
+ * it outlives the object if the module takes too long to answer.
+ */
+struct async_check {
+    pthread_mutex_t     lock;
+    struct xante_app    *xpp;
+    struct xante_item   *item;      /* A reference of its own */
+    char                *value;
+    int                 result;
+    bool                done;
+};
+
 /*
  * Since the callbacks used by the dlgx_inputscroll function receives a
  * void *, this structure is built to hold some information needed to
  * call events from the module while inside them.
+ *
+ * Every module answer is remembered, since the same content is usually
+ * validated several times while the user types and erases it.
  */
 struct inputscroll_data {
     struct xante_app    *xpp;
     struct xante_item   *item;
+    struct input_memo   len_memo[INPUT_MEMO_SIZE];
+    struct input_memo   check_memo[INPUT_MEMO_SIZE];
+
+    /* Debounce */
+    char                *last_value;
+    long long           last_change;
+
+    struct xante_task   *async_task;
+    struct async_check  *async;
 };
 
 /*
@@ -79,136 +116,355 @@ static int get_input_length(const struct xante_item *item)
     return l;
 }
 
-static bool validate_date(struct xante_app *xpp, cl_string_t *value)
+static void show_validation_error(struct xante_app *xpp,
+    const struct xante_item *item, enum validator_status status)
 {
-    cl_stringlist_t *date = NULL;
-    cl_string_t *tmp = NULL;
-    int day, month, year;
+    const struct item_validator *validator = &item->validator;
+
+    switch (status) {
+        case VALIDATOR_OUT_OF_RANGE:
+            if (validator->type == VALIDATOR_FLOAT) {
+                xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                                     cl_tr("The entered value must be between "
+                                           "'%.2f' and '%.2f'!"),
+                                     validator->range.f.min,
+                                     validator->range.f.max);
+            } else {
+                xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                                     cl_tr("The entered value must be between "
+                                           "'%d' and '%d'!"),
+                                     validator->range.i.min,
+                                     validator->range.i.max);
+            }
 
-    if (cl_string_cchr(value, '/') != 2) {
-        xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                             cl_tr("Invalid date format!"));
+            break;
 
-        return false;
-    }
+        case VALIDATOR_TOO_LONG:
+            xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                                 cl_tr("The entered value must have at most "
+                                       "%d characters!"),
+                                 validator->string_length);
 
-    date = cl_string_split(value, "/");
+            break;
 
-    /* DAY */
-    tmp = cl_stringlist_get(date, 0);
-    day = cl_string_to_int(tmp);
-    cl_string_unref(tmp);
+        case VALIDATOR_INVALID_DAY:
+            xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                                 cl_tr("The day must be between 1 and 31!"));
 
-    /* MONTH */
-    tmp = cl_stringlist_get(date, 1);
-    month = cl_string_to_int(tmp);
-    cl_string_unref(tmp);
+            break;
 
-    /* YEAR */
-    tmp = cl_stringlist_get(date, 2);
-    year = cl_string_to_int(tmp);
-    cl_string_unref(tmp);
+        case VALIDATOR_INVALID_MONTH:
+            xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                                 cl_tr("The month must be between 1 and 12!"));
 
-    cl_stringlist_destroy(date);
+            break;
 
-    if ((day <= 0) || (day > 31)) {
-        xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                             cl_tr("The day must be between 1 and 31!"));
+        case VALIDATOR_INVALID_YEAR:
+            xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                                 cl_tr("The year must be greater than 0!"));
 
-        return false;
+            break;
+
+        case VALIDATOR_INVALID_HOUR:
+            xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                                 cl_tr("The hour must be between 0 and 23!"));
+
+            break;
+
+        case VALIDATOR_INVALID_MINUTE:
+            xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                                 cl_tr("The minutes must be between 0 and 59!"));
+
+            break;
+
+        case VALIDATOR_INVALID_SECOND:
+            xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                                 cl_tr("The seconds must be between 0 and 59!"));
+
+            break;
+
+        default:
+            if (validator->type == VALIDATOR_DATE) {
+                xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                                     cl_tr("Invalid date format!"));
+            } else if (validator->type == VALIDATOR_TIME) {
+                xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                                     cl_tr("Invalid time format!"));
+            } else {
+                xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                                     cl_tr("The entered value is not a valid "
+                                           "number!"));
+            }
+
+            break;
     }
+}
 
-    if ((month <= 0) || (month > 12)) {
-        xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                             cl_tr("The month must be between 1 and 12!"));
+static long long monotonic_msec(void)
+{
+    struct timespec ts;
 
-        return false;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static unsigned int memo_hash(const char *value)
+{
+    unsigned int h = 2166136261u;
+
+    /* FNV-1a */
+    while (*value != '\0') {
+        h ^= (unsigned char)*value++;
+        h *= 16777619u;
     }
 
-    if (year <= 0) {
-        xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                             cl_tr("The year must be greater than 0!"));
+    return h;
+}
 
+static bool memo_get(const struct input_memo *memo, const char *value,
+    int *result)
+{
+    unsigned int h = memo_hash(value);
+    const struct input_memo *m = &memo[h % INPUT_MEMO_SIZE];
+
+    if ((NULL == m->value) || (m->hash != h) || strcmp(m->value, value))
         return false;
-    }
+
+    *result = m->result;
 
     return true;
 }
 
-static bool validate_time(struct xante_app *xpp, cl_string_t *value)
+static void memo_put(struct input_memo *memo, const char *value, int result)
 {
-    cl_stringlist_t *time = NULL;
-    cl_string_t *tmp = NULL;
-    int hour, minute, second;
+    unsigned int h = memo_hash(value);
+    struct input_memo *m = &memo[h % INPUT_MEMO_SIZE];
 
-    if (cl_string_cchr(value, ':') != 2) {
-        xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                             cl_tr("Invalid timeformat!"));
+    if (m->value != NULL)
+        free(m->value);
 
-        return false;
+    m->hash = h;
+    m->value = strdup(value);
+    m->result = result;
+}
+
+static void memo_clear(struct input_memo *memo)
+{
+    int i;
+
+    for (i = 0; i < INPUT_MEMO_SIZE; i++)
+        if (memo[i].value != NULL)
+            free(memo[i].value);
+}
+
+static void async_check_destroy(void *arg)
+{
+    struct async_check *check = (struct async_check *)arg;
+
+    if (check->value != NULL)
+        free(check->value);
+
+    if (check->item != NULL)
+        xante_item_unref(check->item);
+
+    pthread_mutex_destroy(&check->lock);
+    free(check);
+}
+
+static struct async_check *async_check_create(struct inputscroll_data *input,
+    const char *value)
+{
+    struct async_check *check = NULL;
+
+    check = calloc(1, sizeof(struct async_check));
+
+    if (NULL == check)
+        return NULL;
+
+    pthread_mutex_init(&check->lock, NULL);
+    check->xpp = input->xpp;
+    xante_item_ref(input->item);
+    check->item = input->item;
+    check->value = strdup(value);
+
+    if (NULL == check->value) {
+        async_check_destroy(check);
+        return NULL;
     }
 
-    time = cl_string_split(value, ":");
+    return check;
+}
 
-    /* HOUR */
-    tmp = cl_stringlist_get(time, 0);
-    hour = cl_string_to_int(tmp);
-    cl_string_unref(tmp);
+static void async_check_task(struct xante_task *task, void *arg)
+{
+    struct async_check *check = (struct async_check *)arg;
+    int ret;
 
-    /* MINUTE */
-    tmp = cl_stringlist_get(time, 1);
-    minute = cl_string_to_int(tmp);
-    cl_string_unref(tmp);
+    if (task_cancelled(task))
+        return;
 
-    /* SECOND */
-    tmp = cl_stringlist_get(time, 2);
-    second = cl_string_to_int(tmp);
-    cl_string_unref(tmp);
+    ret = event_call(EV_VALUE_CHECK, check->xpp, check->item, check->value);
 
-    cl_stringlist_destroy(time);
+    pthread_mutex_lock(&check->lock);
+    check->result = ret;
+    check->done = true;
+    pthread_mutex_unlock(&check->lock);
+}
 
-    if ((hour < 0) || (hour > 23)) {
-        xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                             cl_tr("The hour must be between 0 and 23!"));
+/*
+ * Remembers the answer of a finished background validation, so it can be
+ * looked up as any other.
+ */
+static void async_check_collect(struct inputscroll_data *input)
+{
+    struct async_check *check = input->async;
+    bool done;
 
-        return false;
+    if (NULL == input->async_task)
+        return;
+
+    pthread_mutex_lock(&check->lock);
+    done = check->done;
+    pthread_mutex_unlock(&check->lock);
+
+    if (done == false)
+        return;
+
+    memo_put(input->check_memo, check->value, check->result);
+
+    /* Releases the check too */
+    task_unref(input->async_task);
+    input->async_task = NULL;
+    input->async = NULL;
+}
+
+static int async_check_start(struct inputscroll_data *input, const char *value)
+{
+    struct async_check *check = NULL;
+
+    check = async_check_create(input, value);
+
+    if (NULL == check)
+        return -1;
+
+    input->async_task = executor_submit(input->xpp, async_check_task, check,
+                                        async_check_destroy);
+
+    if (NULL == input->async_task) {
+        async_check_destroy(check);
+        return -1;
     }
 
-    if ((minute < 0) || (minute > 59)) {
-        xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                             cl_tr("The minutes must be between 0 and 59!"));
+    input->async = check;
 
+    return 0;
+}
+
+/*
+ * Tells if the user is still typing, that is, if the content has changed
+ * inside the item debounce window.
+ */
+static bool debounce_pending(struct inputscroll_data *input, const char *value)
+{
+    int debounce = input->item->behaviour.check_debounce;
+    long long now;
+
+    if (debounce <= 0)
         return false;
+
+    now = monotonic_msec();
+
+    if ((NULL == input->last_value) || strcmp(input->last_value, value)) {
+        if (input->last_value != NULL)
+            free(input->last_value);
+
+        input->last_value = strdup(value);
+        input->last_change = now;
+
+        return true;
     }
 
-    if ((second < 0) || (second > 59)) {
-        xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                             cl_tr("The seconds must be between 0 and 59!"));
+    return (now - input->last_change) < debounce;
+}
 
-        return false;
+static void inputscroll_data_init(struct inputscroll_data *input,
+    struct xante_app *xpp, struct xante_item *item)
+{
+    memset(input, 0, sizeof(struct inputscroll_data));
+    input->xpp = xpp;
+    input->item = item;
+}
+
+static void inputscroll_data_uninit(struct inputscroll_data *input)
+{
+    /*
+     * A validation still running holds its own reference of the item, so
+     * it may outlive the object (or even the menu copy owning the item) and
+     * we don't need to wait more than a little for it. Its answer is not
+     * needed anymore.
+     */
+    if (input->async_task != NULL) {
+        task_stop(input->async_task, TASK_STOP_TIMEOUT);
+        task_unref(input->async_task);
     }
 
-    return true;
+    if (input->last_value != NULL)
+        free(input->last_value);
+
+    memo_clear(input->len_memo);
+    memo_clear(input->check_memo);
 }
 
 static int inputscroll_len(const char *value, void *data)
 {
     struct inputscroll_data *input = (struct inputscroll_data *)data;
+    int ret;
 
     if (NULL == data)
         return 0;
 
-    return event_call(EV_VALUE_STRLEN, input->xpp, input->item, value);
+    if (memo_get(input->len_memo, value, &ret))
+        return ret;
+
+    ret = event_call(EV_VALUE_STRLEN, input->xpp, input->item, value);
+    memo_put(input->len_memo, value, ret);
+
+    return ret;
 }
 
 static int inputscroll_check(const char *value, void *data)
 {
     struct inputscroll_data *input = (struct inputscroll_data *)data;
+    int ret;
 
     if (NULL == data)
         return 1;
 
-    return event_call(EV_VALUE_CHECK, input->xpp, input->item, value);
+    async_check_collect(input);
+
+    if (memo_get(input->check_memo, value, &ret))
+        return ret;
+
+    if (debounce_pending(input, value))
+        return DLGX_INPUT_CHECK_PENDING;
+
+    if (input->item->behaviour.async_check) {
+        /*
+         * Only one validation runs at a time. A newer content waits for the
+         * current one to finish.
+         */
+        if ((input->async_task != NULL) ||
+            (async_check_start(input, value) == 0))
+        {
+            return DLGX_INPUT_CHECK_PENDING;
+        }
+    }
+
+    ret = event_call(EV_VALUE_CHECK, input->xpp, input->item, value);
+    memo_put(input->check_memo, value, ret);
+
+    return ret;
 }
 
 static int dlgx_passwd(struct xante_item *item, char *input,
@@ -288,57 +544,26 @@ static void build_session(session_t *session, char *input,
 bool input_validate_result(session_t *session)
 {
     struct xante_item *item = session->item;
-    struct xante_app *xpp = session->xpp;
-    bool valid = false;
-    cl_object_t *value = NULL;
-    cl_string_t *str_value = NULL;
-
-    str_value = cl_string_ref(session->result);
-    value = cl_object_from_cstring(session->result);
-
-    if (item->widget_type == XANTE_WIDGET_INPUT_INT) {
-        valid = cl_spec_validate(item->value_spec, item_value(item), false,
-                                 CL_VALIDATE_RANGE, CL_OBJECT_AS_INT(value));
-
-        if (valid == false) {
-            xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                                 cl_tr("The entered value must be between "
-                                       "'%d' and '%d'!"),
-                                 CL_OBJECT_AS_INT(item->min),
-                                 CL_OBJECT_AS_INT(item->max));
-        }
-    } else if (item->widget_type == XANTE_WIDGET_INPUT_FLOAT) {
-        valid = cl_spec_validate(item->value_spec, item_value(item), false,
-                                 CL_VALIDATE_RANGE,
-                                 cl_string_to_float(str_value));
-
-        if (valid == false) {
-            xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                                 cl_tr("The entered value must be between "
-                                       "'%.2f' and '%.2f'!"),
-                                 CL_OBJECT_AS_FLOAT(item->min),
-                                 CL_OBJECT_AS_FLOAT(item->max));
-        }
-    } else if (item->widget_type == XANTE_WIDGET_INPUT_DATE) {
-        valid = validate_date(xpp, str_value);
-    } else if (item->widget_type == XANTE_WIDGET_INPUT_TIME) {
-        valid = validate_time(xpp, str_value);
-    } else {
-        /*
-         * XXX: A XANTE_WIDGET_INPUT_PASSWD and XANTE_WIDGET_RANGE must
-         *      be validated inside the module, in a EV_ITEM_VALUE_CONFIRM
-         *      event, which is called before this function.
-         *
-         *      We don't hold any information inside the JTF to compare them and
-         *      just return true to keep running.
-         */
-
-        valid = true;
+    enum validator_status status;
+
+    /*
+     * XXX: A XANTE_WIDGET_INPUT_PASSWD and XANTE_WIDGET_RANGE must
+     *      be validated inside the module, in a EV_ITEM_VALUE_CONFIRM
+     *      event, which is called before this function.
+     *
+     *      We don't hold any information inside the JTF to compare their
+     *      content, so here we only check what it tells us about them,
+     *      such as ranges and the maximum length in characters.
+     */
+    status = validator_check(&item->validator,
+                             cl_string_valueof(session->result));
+
+    if (status != VALIDATOR_OK) {
+        show_validation_error(session->xpp, item, status);
+        return false;
     }
 
-    cl_string_unref(str_value);
-
-    return valid;
+    return true;
 }
 
 bool input_value_changed(session_t *session)
@@ -372,19 +597,18 @@ void input_update_value(session_t *session)
     cl_string_t *result = NULL;
 
     /* Updates item value */
-    if (item->value != NULL)
-        cl_object_unref(item->value);
-
     result = cl_string_dup(session->result);
 
     if ((item->widget_type == XANTE_WIDGET_INPUT_INT) ||
         (item->widget_type == XANTE_WIDGET_RANGE))
     {
-        item->value = cl_object_create(CL_INT, cl_string_to_int(result));
-    } else if (item->widget_type == XANTE_WIDGET_INPUT_FLOAT)
-        item->value = cl_object_create(CL_FLOAT, cl_string_to_float(result));
-    else
-        item->value = cl_object_from_cstring(result);
+        item_set_value(item, cl_object_create(CL_INT,
+                                              cl_string_to_int(result)));
+    } else if (item->widget_type == XANTE_WIDGET_INPUT_FLOAT) {
+        item_set_value(item, cl_object_create(CL_FLOAT,
+                                              cl_string_to_float(result)));
+    } else
+        item_set_value(item, cl_object_from_cstring(result));
 
     cl_string_unref(result);
 }
@@ -402,10 +626,7 @@ int input(session_t *session)
     char input_result[MAX_INPUT_VALUE] = {0}, *range_value = NULL;
     struct xante_app *xpp = session->xpp;
     struct xante_item *item = session->item;
-    struct inputscroll_data input_data = {
-        .xpp = xpp,
-        .item = item,
-    };
+    struct inputscroll_data input_data;
 
     /* Prepares object content and session */
     build_session(session, input_result, sizeof(input_result));
@@ -433,6 +654,7 @@ int input(session_t *session)
 
         free(range_value);
     } else if (item->widget_type == XANTE_WIDGET_INPUTSCROLL) {
+        inputscroll_data_init(&input_data, xpp, item);
         ret_dialog = dlgx_inputbox(session->width, 20,// height,
                                    cl_string_valueof(item->name),
                                    cl_string_valueof(session->text),
@@ -442,6 +664,8 @@ int input(session_t *session)
                                    session->editable_value,
                                    inputscroll_len, inputscroll_check,
                                    &input_data);
+
+        inputscroll_data_uninit(&input_data);
     } else {
         ret_dialog = dlgx_inputbox(session->width, session->height,
                                    cl_string_valueof(item->name),
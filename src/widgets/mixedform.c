@@ -36,14 +36,14 @@
 
 static cl_json_t *get_fields_node(const struct xante_item *item)
 {
-    return cl_json_get_object_item(item->form_options, "fields");
+    return cl_json_get_object_item(item->details->form_options, "fields");
 }
 
 static cl_string_t *get_title(const struct xante_item *item)
 {
     cl_json_t *node;
 
-    node = cl_json_get_object_item(item->form_options, "title");
+    node = cl_json_get_object_item(item->details->form_options, "title");
 
     if (NULL == node)
         return NULL;
@@ -171,11 +171,13 @@ static int get_longest_element_name(const cl_json_t *fields, int total_fields)
 static int prepare_content(const cl_json_t *fields, session_t *session)
 {
     DIALOG_FORMITEM *item = NULL;
-    int i;
+    int i, length;
     char fmt[8] = {0};
+    const char *name = NULL;
     cl_json_t *field;
 
-    session->fitems = calloc(session->number_of_items, sizeof(DIALOG_FORMITEM));
+    session->fitems = session_alloc(session, session->number_of_items *
+                                             sizeof(DIALOG_FORMITEM));
 
     if (NULL == session->fitems) {
         errno_set(XANTE_ERROR_NO_MEMORY);
@@ -188,10 +190,15 @@ static int prepare_content(const cl_json_t *fields, session_t *session)
         item = &session->fitems[i];
         field = cl_json_get_array_item(fields, i);
 
-        asprintf(&item->name, fmt,
-                 cl_string_valueof(get_element_name(field)));
+        name = cl_string_valueof(get_element_name(field));
+        length = snprintf(NULL, 0, fmt, name);
+        item->name = session_alloc(session, length + 1);
+
+        if (NULL == item->name)
+            return -1;
 
-        item->name_len = strlen(item->name);
+        snprintf(item->name, length + 1, fmt, name);
+        item->name_len = length;
 
         item->text = mixedform_item_value(field);
         item->text_len = strlen(item->text);
@@ -456,7 +463,7 @@ void ui_save_mixedform_item(struct xante_app *xpp, struct xante_item *item)
     int total_fields = 0, i;
     cl_json_t *fields = NULL;
 
-    fields = cl_json_get_object_item(item->form_options, "fields");
+    fields = cl_json_get_object_item(item->details->form_options, "fields");
 
     if (NULL == fields)
         return;
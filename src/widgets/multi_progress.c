@@ -0,0 +1,395 @@
+
+/*
+ * Description:
+ *
+ * Author: Rodrigo Freitas
+ * Created at: Mon Oct 19 10:31:05 2026
+ * Project: libxante
+ *
+ * Copyright (C) 2017 Rodrigo Freitas
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ * USA
+ */
+
+#include <errno.h>
+#include <poll.h>
+
+#include "libxante.h"
+
+/* The object size onto the screen, without its tasks */
+#define DIALOG_HEIGHT                   8
+#define DIALOG_WIDTH                    60
+
+/* Minimum interval between two redraws, in milliseconds */
+#define PROGRESS_FRAME_INTERVAL         40
+
+/* Maximum time we sleep without looking at the tasks, in milliseconds */
+#define PROGRESS_WAIT_INTERVAL          500
+
+/* A task running inside the object */
+struct progress_job {
+    struct xante_item   *item;
+    struct xante_task   *task;
+    int                 percent;
+    bool                finished;
+};
+
+/*
+ *
+ * Internal functions
+ *
+ */
+
+static int job_percent(const struct progress_job *job)
+{
+    int max = CL_OBJECT_AS_INT(job->item->max);
+
+    if (job->percent < 0)
+        return -1;
+
+    if ((max <= 0) || ((job->percent + 1) >= max))
+        return 100;
+
+    return (job->percent * 100) / max;
+}
+
+/*
+ * Loads the last value posted by a task and tells if it has reached its
+ * end, either by being complete, cancelled or aborted.
+ */
+static bool job_update(struct progress_job *job)
+{
+    job->percent = item_progress_value(job->item);
+
+    if ((job->percent < 0) ||
+        ((job->percent + 1) >= CL_OBJECT_AS_INT(job->item->max)) ||
+        (job->item->cancel_update == true))
+    {
+        job->finished = true;
+    }
+
+    return job->finished;
+}
+
+/*
+ * Tells if a job has a routine running inside a worker right now.
+ */
+static bool job_running(const struct progress_job *job)
+{
+    return (job->task != NULL) && (job->finished == false) &&
+           task_started(job->task);
+}
+
+/*
+ * Gives up on a task that will not post anything else: its routine has
+ * returned, or it's still queued while no other job is running (@alive is
+ * false) and the executor tells it will never run. A task that never
+ * started is aborted.
+ *
+ * A queued task is never given up while another job runs, since it gets a
+ * worker as soon as one of them finishes, no matter how slow they are.
+ */
+static bool job_gone(struct progress_job *job, bool alive)
+{
+    if (NULL == job->task)
+        return false;
+
+    if (task_wait(job->task, 0) == 0) {
+        job_update(job);
+        job->finished = true;
+        return true;
+    }
+
+    if ((alive == false) && (task_runnable(job->task) == false)) {
+        task_cancel(job->task);
+        job->percent = -1;
+        job->finished = true;
+        return true;
+    }
+
+    return false;
+}
+
+/*
+ * Aborted tasks count as complete to the aggregate bar, since there is
+ * nothing left for them to do.
+ */
+static int aggregate_percent(const int *percents, int count)
+{
+    int i, total = 0;
+
+    for (i = 0; i < count; i++)
+        total += (percents[i] < 0) ? 100 : percents[i];
+
+    return total / count;
+}
+
+static void draw(session_t *session, struct progress_job *jobs,
+    const char **labels, int *percents, int count)
+{
+    struct xante_item *item = session->item;
+    int i;
+
+    for (i = 0; i < count; i++)
+        percents[i] = job_percent(&jobs[i]);
+
+    dlgx_multi_progress(cl_string_valueof(item->name),
+                        cl_string_valueof(item->options),
+                        session->height, session->width, labels, percents,
+                        count, aggregate_percent(percents, count));
+}
+
+/*
+ * Updates the object every time any of its tasks posts a new value. Every
+ * progress channel is watched at once, so the UI sleeps while nothing
+ * changes, no matter how many tasks are running. The sleep is bounded, so
+ * tasks that finish or never start do not keep us here forever.
+ */
+static void make_progress(session_t *session, struct progress_job *jobs,
+    int count)
+{
+    struct xante_item *item = session->item;
+    struct pollfd *pfd = NULL;
+    const char **labels = NULL;
+    int *percents = NULL;
+    int i, running;
+    bool changed = true, alive;
+
+    /* The last slot watches the object itself, to be woken up if cancelled */
+    pfd = calloc(count + 1, sizeof(struct pollfd));
+    labels = calloc(count, sizeof(char *));
+    percents = calloc(count, sizeof(int));
+
+    if ((NULL == pfd) || (NULL == labels) || (NULL == percents))
+        goto end_block;
+
+    session->width = (item->geometry.width == 0) ? DIALOG_WIDTH
+                                                 : item->geometry.width;
+
+    session->height = (item->geometry.height == 0) ? DIALOG_HEIGHT + count
+                                                   : item->geometry.height;
+
+    for (i = 0; i < count; i++) {
+        labels[i] = cl_string_valueof(jobs[i].item->name);
+        pfd[i].fd = jobs[i].item->progress.fd;
+        pfd[i].events = POLLIN;
+    }
+
+    pfd[count].fd = item->progress.fd;
+    pfd[count].events = POLLIN;
+
+    while ((item->cancel_update == false) &&
+           (xante_runtime_close_ui(session->xpp) == false))
+    {
+        running = 0;
+        alive = false;
+
+        for (i = 0; (i < count) && (alive == false); i++)
+            alive = job_running(&jobs[i]);
+
+        for (i = 0; i < count; i++) {
+            if (jobs[i].finished)
+                continue;
+
+            if (job_update(&jobs[i]) || job_gone(&jobs[i], alive))
+                changed = true;
+            else
+                running++;
+        }
+
+        if (changed) {
+            draw(session, jobs, labels, percents, count);
+            changed = false;
+
+            /*
+             * Values posted while we hold this frame are coalesced into the
+             * next redraw.
+             */
+            cl_msleep(PROGRESS_FRAME_INTERVAL);
+        }
+
+        if (running == 0)
+            break;
+
+        if (poll(pfd, count + 1, PROGRESS_WAIT_INTERVAL) <= 0)
+            continue;
+
+        if (pfd[count].revents & POLLIN)
+            item_progress_wait(item, 0);
+
+        for (i = 0; i < count; i++)
+            if ((pfd[i].revents & POLLIN) && item_progress_wait(jobs[i].item, 0))
+                changed = true;
+    }
+
+    /* Leaves the last stage of every task onto the screen */
+    if (changed)
+        draw(session, jobs, labels, percents, count);
+
+end_block:
+    if (percents != NULL)
+        free(percents);
+
+    if (labels != NULL)
+        free(labels);
+
+    if (pfd != NULL)
+        free(pfd);
+}
+
+/*
+ * Starts every task of the object. They are all queued at once, and the
+ * executor bounded pool decides how many of them actually run together.
+ */
+static int start_jobs(struct xante_app *xpp, struct xante_item *item,
+    struct progress_job *jobs, int count)
+{
+    cl_list_node_t *node = NULL;
+    struct xante_item *task_item = NULL;
+    void *data;
+    int i;
+
+    for (i = 0; i < count; i++) {
+        node = cl_list_at(item->details->tasks, i);
+        task_item = cl_list_node_content(node);
+        cl_list_node_unref(node);
+
+        task_item->cancel_update = false;
+        jobs[i].item = task_item;
+
+        if (item_progress_open(task_item) < 0) {
+            xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                                 cl_tr("Progress channel creation error: %s"),
+                                 strerror(errno));
+
+            return -1;
+        }
+
+        data = event_item_custom_data(xpp, task_item);
+
+        if (event_item_has(task_item, EV_UPDATE_ROUTINE) == false)
+            continue;
+
+        jobs[i].task = progress_routine_submit(xpp, task_item, data);
+
+        if (NULL == jobs[i].task) {
+            xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                                 cl_tr("Progress task creation error: %s"),
+                                 xante_strerror(xante_get_last_error()));
+
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/*
+ * Every task is asked to stop before we wait for any of them, so they all
+ * finish together. One that ignores the request is left behind.
+ */
+static void stop_jobs(struct progress_job *jobs, int count)
+{
+    int i;
+
+    for (i = 0; i < count; i++)
+        if (jobs[i].task != NULL)
+            task_cancel(jobs[i].task);
+
+    for (i = 0; i < count; i++) {
+        if (jobs[i].task != NULL) {
+            task_stop(jobs[i].task, TASK_STOP_TIMEOUT);
+            task_unref(jobs[i].task);
+        }
+    }
+}
+
+/*
+ *
+ * Internal API
+ *
+ */
+
+/**
+ * @name multi_progress
+ * @brief Creates an object of multi-progress type.
+ *
+ * This object runs several progress tasks in parallel, showing a bar for
+ * each one of them and another with the aggregate of all.
+ *
+ * Each task is a progress item declared inside the 'tasks' array of the
+ * object and follows the same rules of a single progress: its own
+ * EV_ITEM_CUSTOM_DATA and EV_UPDATE_ROUTINE events, or values pushed with
+ * 'xante_item_post_progress'. Tasks are run by the library executor, so
+ * only a bounded number of them execute at the same time while the others
+ * wait in its queue.
+ *
+ * Task items have no object_id, so they cannot be found with
+ * 'xante_item_search'. A module posting values or cancelling a single task
+ * must keep the item pointer received by its EV_ITEM_CUSTOM_DATA (or
+ * EV_UPDATE_ROUTINE) event, which is valid while the object is displayed.
+ *
+ * Cancelling the object, with 'xante_item_cancel_update', stops every task.
+ * A single one may be cancelled the same way, using its own item. Every
+ * task waits in the queue for as long as the others keep running. It's
+ * only aborted if the executor can never run it.
+ *
+ * @param [in] session: The current session.
+ *
+ * @return Returns DLG_EXIT_OK (always).
+ */
+int multi_progress(session_t *session)
+{
+    struct xante_app *xpp = session->xpp;
+    struct xante_item *item = session->item;
+    struct progress_job *jobs = NULL;
+    int count;
+
+    /* Assures that we will be able to, at least, start the progress */
+    item->cancel_update = false;
+    count = cl_list_size(item->details->tasks);
+
+    if (count <= 0)
+        return DLG_EXIT_OK;
+
+    jobs = calloc(count, sizeof(struct progress_job));
+
+    if (NULL == jobs) {
+        xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                             cl_tr("Progress task creation error: %s"),
+                             xante_strerror(XANTE_ERROR_NO_MEMORY));
+
+        return DLG_EXIT_OK;
+    }
+
+    if (item_progress_open(item) < 0) {
+        xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                             cl_tr("Progress channel creation error: %s"),
+                             strerror(errno));
+
+        free(jobs);
+        return DLG_EXIT_OK;
+    }
+
+    if (start_jobs(xpp, item, jobs, count) == 0)
+        make_progress(session, jobs, count);
+
+    stop_jobs(jobs, count);
+    free(jobs);
+
+    return DLG_EXIT_OK;
+}
+
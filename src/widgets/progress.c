@@ -24,15 +24,28 @@
  * USA
  */
 
+#include <errno.h>
+
 #include "libxante.h"
 
 /* The object size onto the screen */
 #define DIALOG_HEIGHT                   7
 #define DIALOG_WIDTH                    60
 
-struct progress_thread {
-    session_t     *session;
-    void          *data;
+/* Minimum interval between two redraws, in milliseconds */
+#define PROGRESS_FRAME_INTERVAL         40
+
+/* Interval between EV_UPDATE_ROUTINE event calls, in milliseconds */
+#define PROGRESS_ROUTINE_INTERVAL       100
+
+/* Maximum time waiting for a new value before checking the task again */
+#define PROGRESS_WAIT_INTERVAL          500
+
+/* Everything an update-routine task needs, owned by the task itself */
+struct progress_task {
+    struct xante_app    *xpp;
+    struct xante_item   *item;
+    void                *data;
 };
 
 /*
@@ -41,42 +54,105 @@ struct progress_thread {
  *
  */
 
+static void release_progress_task(void *a)
+{
+    struct progress_task *pt = (struct progress_task *)a;
+
+    xante_item_unref(pt->item);
+    free(pt);
+}
+
 /*
- * This is the thread that updates the progress bar object.
+ * The task to keep calling a module declared EV_UPDATE_ROUTINE event. Every
+ * value it returns is posted to the item progress channel, the same way a
+ * module pushing its own values would do.
  */
-static void *make_progress(cl_thread_t *thread)
+static void update_task(struct xante_task *task, void *arg)
 {
-    struct progress_thread *progress = cl_thread_get_user_data(thread);
-    session_t *session = progress->session;
-    struct xante_app *xpp = session->xpp;
-    struct xante_item *item = session->item;
+    struct progress_task *pt = (struct progress_task *)arg;
     int percent;
 
-    cl_thread_set_state(thread, CL_THREAD_ST_CREATED);
+    do {
+        percent = event_call(EV_UPDATE_ROUTINE, pt->xpp, pt->item, pt->data);
+        xante_item_post_progress(pt->item, percent);
+
+        /* Abort if we caught a invalid value */
+        if (percent < 0)
+            break;
+
+        if ((percent + 1) >= CL_OBJECT_AS_INT(pt->item->max))
+            break;
+    } while (task_sleep(task, PROGRESS_ROUTINE_INTERVAL) == false);
+}
+
+/*
+ * Tells if we should stop waiting for new values from @task: it has finished
+ * or it's still waiting for a free worker for too long.
+ */
+static bool task_gone(struct xante_task *task, cl_timeout_t *tm_start)
+{
+    if (NULL == task)
+        return false;
+
+    if (task_wait(task, 0) == 0)
+        return true;
+
+    if ((task_started(task) == false) && cl_timeout_expired(tm_start))
+        return true;
+
+    return false;
+}
+
+/*
+ * Updates the progress bar object every time a new value is posted. If the
+ * values come from @task, we only wait for it while it may post something.
+ */
+static void make_progress(session_t *session, struct xante_task *task)
+{
+    struct xante_item *item = session->item;
+    int percent, last_percent = -1;
+    cl_timeout_t *tm_start = NULL;
+
     session->width = (item->geometry.width == 0) ? DIALOG_WIDTH
                                                  : item->geometry.width;
 
     session->height = (item->geometry.height == 0) ? DIALOG_HEIGHT
                                                    : item->geometry.height;
 
-    cl_thread_set_state(thread, CL_THREAD_ST_INITIALIZED);
+    tm_start = cl_timeout_create(TASK_START_TIMEOUT, CL_TM_SECONDS);
+    percent = item_progress_value(item);
 
-    do {
-        percent = event_call(EV_UPDATE_ROUTINE, xpp, item, progress->data);
-        dlgx_simple_progress(cl_string_valueof(item->name),
-                             cl_string_valueof(item->options),
-                             session->height, session->width,
-                             percent);
+    /* Abort if we caught a invalid value */
+    while (percent >= 0) {
+        if (percent != last_percent) {
+            dlgx_simple_progress(cl_string_valueof(item->name),
+                                 cl_string_valueof(item->options),
+                                 session->height, session->width,
+                                 percent);
 
-        /* Abort if we caught a invalid value */
-        if (percent < 0)
+            last_percent = percent;
+
+            /*
+             * Values posted while we hold this frame are coalesced into the
+             * next redraw.
+             */
+            cl_msleep(PROGRESS_FRAME_INTERVAL);
+        }
+
+        if (((percent + 1) >= CL_OBJECT_AS_INT(item->max)) ||
+            (item->cancel_update == true) ||
+            (xante_runtime_close_ui(session->xpp) == true))
+        {
             break;
+        }
 
-        cl_msleep(100);
-    } while (((percent + 1) < CL_OBJECT_AS_INT(item->max)) &&
-             (item->cancel_update == false));
+        if (item_progress_wait(item, PROGRESS_WAIT_INTERVAL))
+            percent = item_progress_value(item);
+        else if (task_gone(task, tm_start))
+            break;
+    }
 
-    return NULL;
+    cl_timeout_destroy(tm_start);
 }
 
 /*
@@ -85,6 +161,45 @@ static void *make_progress(cl_thread_t *thread)
  *
  */
 
+/**
+ * @name progress_routine_submit
+ * @brief Starts a background task calling an item EV_UPDATE_ROUTINE event.
+ *
+ * Every value returned by the event is posted to the item progress channel,
+ * which must be already opened.
+ *
+ * @param [in] xpp: The main library object.
+ * @param [in] item: The progress item.
+ * @param [in] data: The item custom data passed to the update-routine.
+ *
+ * @return On success returns the running task, which must be released with
+ *         'task_unref', or NULL otherwise.
+ */
+struct xante_task *progress_routine_submit(struct xante_app *xpp,
+    struct xante_item *item, void *data)
+{
+    struct xante_task *task = NULL;
+    struct progress_task *pt = NULL;
+
+    pt = calloc(1, sizeof(struct progress_task));
+
+    if (NULL == pt) {
+        errno_set(XANTE_ERROR_NO_MEMORY);
+        return NULL;
+    }
+
+    xante_item_ref(item);
+    pt->xpp = xpp;
+    pt->item = item;
+    pt->data = data;
+    task = executor_submit(xpp, update_task, pt, release_progress_task);
+
+    if (NULL == task)
+        release_progress_task(pt);
+
+    return task;
+}
+
 /**
  * @name progress
  * @brief Creates an object of progress type.
@@ -100,6 +215,11 @@ static void *make_progress(cl_thread_t *thread)
  * EV_UPDATE_ROUTINE: which must return the new stage to be updated to the
  *                    user.
  *
+ * The EV_UPDATE_ROUTINE event is called from a background task. Instead of
+ * declaring it, the module may push every new stage, from any thread, with
+ * 'xante_item_post_progress'. The object only wakes up when a new stage is
+ * posted.
+ *
  * Anytime the user wants this routine may be cancelled by calling the
  * function 'xante_item_cancel_update'.
  *
@@ -113,34 +233,40 @@ int progress(session_t *session)
 {
     struct xante_app *xpp = session->xpp;
     struct xante_item *item = session->item;
-    cl_thread_t *thread;
-    struct progress_thread progress = {
-        .session = session,
-    };
+    struct xante_task *task = NULL;
+    void *data;
 
     /* Assures that we will be able to, at least, start the progress */
     item->cancel_update = false;
-    progress.data = event_item_custom_data(xpp, item);
-    thread = cl_thread_spawn(CL_THREAD_JOINABLE, make_progress, &progress);
 
-    if (NULL == thread) {
+    if (item_progress_open(item) < 0) {
         xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                             cl_tr("Sync thread creation error: %s"),
-                             cl_strerror(cl_get_last_error()));
+                             cl_tr("Progress channel creation error: %s"),
+                             strerror(errno));
 
         return DLG_EXIT_OK;
     }
 
-    if (cl_thread_wait_startup(thread) != 0) {
-        xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                             cl_tr("Error waiting for thread to initialize: %s"),
-                             cl_strerror(cl_get_last_error()));
+    data = event_item_custom_data(xpp, item);
 
-        return DLG_EXIT_OK;
+    if (event_item_has(item, EV_UPDATE_ROUTINE)) {
+        task = progress_routine_submit(xpp, item, data);
+
+        if (NULL == task) {
+            xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
+                                 cl_tr("Progress task creation error: %s"),
+                                 xante_strerror(xante_get_last_error()));
+
+            return DLG_EXIT_OK;
+        }
     }
 
-    /* Since there is a thread-join here it will wait for the thread to end. */
-    cl_thread_destroy(thread);
+    make_progress(session, task);
+
+    if (task != NULL) {
+        task_stop(task, TASK_STOP_TIMEOUT);
+        task_unref(task);
+    }
 
     return DLG_EXIT_OK;
 }
@@ -164,7 +164,7 @@ static int build_sheet(const struct xante_item *item,
     cl_string_t *value;
     int i, rows = 0, j, columns = 0;
 
-    sheet = cl_json_get_object_item(item->form_options, "sheet");
+    sheet = cl_json_get_object_item(item->details->form_options, "sheet");
 
     if (NULL == sheet)
         return -1;
@@ -226,7 +226,7 @@ static void build_session(session_t *session)
     cl_json_t *node;
 
     /* Window title */
-    node = cl_json_get_object_item(item->form_options, "title");
+    node = cl_json_get_object_item(item->details->form_options, "title");
 
     if (NULL == node)
         return;
@@ -242,7 +242,7 @@ static int get_form_number_of_rows(const struct xante_item *item)
 {
     cl_json_t *sheet = NULL;
 
-    sheet = cl_json_get_object_item(item->form_options, "sheet");
+    sheet = cl_json_get_object_item(item->details->form_options, "sheet");
 
     if (NULL == sheet)
         return 0;
@@ -254,7 +254,7 @@ static cl_json_t *get_form_row(const struct xante_item *item, int row)
 {
     cl_json_t *sheet = NULL;
 
-    sheet = cl_json_get_object_item(item->form_options, "sheet");
+    sheet = cl_json_get_object_item(item->details->form_options, "sheet");
 
     if (NULL == sheet)
         return 0;
@@ -535,7 +535,7 @@ bool spreadsheet_value_changed(session_t *session)
     if (NULL == result_sheet)
         goto end_block;
 
-    sheet = cl_json_get_object_item(item->form_options, "sheet");
+    sheet = cl_json_get_object_item(item->details->form_options, "sheet");
 
     if (NULL == sheet)
         goto end_block;
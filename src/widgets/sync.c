@@ -30,10 +30,15 @@
 #define DIALOG_HEIGHT               5
 #define DIALOG_WIDTH                60
 
-struct sync_thread {
-    session_t       *session;
-    void            *data;
-    cl_timeout_t    *tm_task;
+/* Interval between two sync bar updates, in milliseconds */
+#define SYNC_FRAME_INTERVAL         500
+
+/* Everything a sync task needs, owned by the task itself */
+struct sync_task {
+    struct xante_app    *xpp;
+    struct xante_item   *item;
+    void                *data;
+    int                 beats;      /* Number of routine calls returned */
 };
 
 struct sync {
@@ -54,13 +59,6 @@ static struct sync __sync[] = {
  *
  */
 
-static void task_signal(int signum)
-{
-    if (signum == SIGUSR1) {
-        xante_log_info("The sync task seemed to be freeze. We're going to end it.");
-    }
-}
-
 static struct sync *get_sync(enum xante_object sync)
 {
     unsigned int i;
@@ -94,27 +92,27 @@ static void update_synctext(cl_string_t *text, int step, enum xante_object sync)
     }
 }
 
-static void *call_task(cl_thread_t *thread)
+static void release_sync_task(void *a)
 {
-    struct sync_thread *sync = cl_thread_get_user_data(thread);
-    session_t *session = sync->session;
-    struct xante_app *xpp = session->xpp;
-    struct xante_item *item = session->item;
-    bool loop = false;
+    struct sync_task *st = (struct sync_task *)a;
 
-    cl_thread_set_state(thread, CL_THREAD_ST_CREATED);
+    xante_item_unref(st->item);
+    free(st);
+}
+
+/*
+ * The task running the module routine. It may outlive its widget when it gets
+ * blocked, so it only uses data that it owns.
+ */
+static void call_task(struct xante_task *task, void *arg)
+{
+    struct sync_task *st = (struct sync_task *)arg;
+    bool loop = false;
 
-    /*
-     * We monitor the SIGUSR1 signal so if this task gets blocked and reaches
-     * the timeout adjusted in its item->max attribute we can killed it without
-     * killing the all application.
-     */
-    cl_trap(SIGUSR1, task_signal);
-    cl_thread_set_state(thread, CL_THREAD_ST_INITIALIZED);
     xante_log_debug("%s: starting...", __FUNCTION__);
 
-    do {
-        loop = event_call(EV_SYNC_ROUTINE, xpp, item, sync->data);
+    while (task_cancelled(task) == false) {
+        loop = event_call(EV_SYNC_ROUTINE, st->xpp, st->item, st->data);
 
         /*
          * At one time the event function _must_ return a false value. Otherwise
@@ -123,66 +121,38 @@ static void *call_task(cl_thread_t *thread)
         if (loop == false)
             break;
 
-        cl_timeout_reset(sync->tm_task, CL_OBJECT_AS_INT(item->max),
-                         CL_TM_SECONDS);
-    } while (loop);
+        __atomic_add_fetch(&st->beats, 1, __ATOMIC_RELEASE);
+    }
 
-    item->cancel_update = true;
-    xante_log_debug("%s: finishing...", __FUNCTION__);
+    /* A cancelled task must not touch a newer sync of the same item */
+    task_set_flag(task, &st->item->cancel_update);
 
-    return NULL;
+    xante_log_debug("%s: finishing...", __FUNCTION__);
 }
 
 /*
- * This is the thread that updates the sync bar object.
+ * Updates the sync bar object while the task is running.
  */
-static void *make_sync(cl_thread_t *thread)
+static void make_sync(session_t *session, struct xante_task *task,
+    struct sync_task *st)
 {
-    struct sync_thread *sync = cl_thread_get_user_data(thread);
-    session_t *session = sync->session;
     struct xante_app *xpp = session->xpp;
     struct xante_item *item = session->item;
     struct sync *sync_model;
-    cl_thread_t *task = NULL;
+    cl_timeout_t *tm_task = NULL;
     cl_string_t *text = NULL;
-    int stepbar = 0;
+    int stepbar = 0, beats = 0, last_beats = 0;
     char *tmp = NULL;
 
-    cl_thread_set_state(thread, CL_THREAD_ST_CREATED);
     sync_model = get_sync(item->widget_type);
-
-    /* Creates a thread to run the user task (event) */
-    task = cl_thread_spawn(CL_THREAD_JOINABLE, call_task, sync);
-
-    if (NULL == task) {
-        xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                             cl_tr("Sync thread creation error: %s"),
-                             cl_strerror(cl_get_last_error()));
-
-        cl_thread_set_state(task, CL_THREAD_ST_INITIALIZED);
-        return NULL;
-    }
-
-    if (cl_thread_wait_startup(task) != 0) {
-        xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                             cl_tr("Error waiting for thread to initialize: %s"),
-                             cl_strerror(cl_get_last_error()));
-
-        cl_thread_set_state(task, CL_THREAD_ST_INITIALIZED);
-        return NULL;
-    }
-
-    sync->tm_task = cl_timeout_create(CL_OBJECT_AS_INT(item->max),
-                                      CL_TM_SECONDS);
-
+    tm_task = cl_timeout_create(CL_OBJECT_AS_INT(item->max), CL_TM_SECONDS);
     session->width = (item->geometry.width == 0) ? DIALOG_WIDTH
                                                  : item->geometry.width;
 
     session->height = (item->geometry.height == 0) ? DIALOG_HEIGHT
                                                    : item->geometry.height;
 
-    cl_thread_set_state(thread, CL_THREAD_ST_INITIALIZED);
-    xante_log_debug("%s: started sync thread", __FUNCTION__);
+    xante_log_debug("%s: started sync", __FUNCTION__);
 
     do {
         text = cl_string_dup(item->options);
@@ -207,25 +177,39 @@ static void *make_sync(cl_thread_t *thread)
             stepbar = 0;
 
         cl_string_unref(text);
-        cl_msleep(500);
 
-        /*
-         * Checks if the task is consuming more time than the item's maximum
-         * timeout. If it is, we ended it.
-         */
-        if (cl_timeout_expired(sync->tm_task)) {
-            cl_thread_force_finish(task);
-            item->cancel_update = true;
+        /* Sleeps until the next frame or until the task finishes */
+        if (task_wait(task, SYNC_FRAME_INTERVAL) == 0)
+            break;
+
+        beats = __atomic_load_n(&st->beats, __ATOMIC_ACQUIRE);
+
+        if (beats != last_beats) {
+            last_beats = beats;
+            cl_timeout_reset(tm_task, CL_OBJECT_AS_INT(item->max),
+                             CL_TM_SECONDS);
+        } else if (cl_timeout_expired(tm_task)) {
+            /*
+             * The task is consuming more time than the item's maximum
+             * timeout. We cancel it and stop waiting for it.
+             */
+            task_abandon(task);
+            __atomic_store_n(&item->cancel_update, true, __ATOMIC_RELEASE);
             xante_dlg_messagebox(xpp, XANTE_MSGBOX_WARNING, cl_tr("Warning"),
                                  cl_tr("The task running in background seems "
-                                       "to be blocked. We're killing it!"));
+                                       "to be blocked. We're cancelling it!"));
         }
-    } while (item->cancel_update == false);
+    } while (__atomic_load_n(&item->cancel_update, __ATOMIC_ACQUIRE) == false);
 
-    cl_thread_destroy(task);
-    xante_log_debug("%s: finish sync thread", __FUNCTION__);
+    /*
+     * The sync may also be cancelled by the module itself, so we ask the task
+     * to stop and wait for it. A blocked task is left behind to be joined when
+     * the application finishes.
+     */
+    task_stop(task, TASK_STOP_TIMEOUT);
 
-    return NULL;
+    cl_timeout_destroy(tm_task);
+    xante_log_debug("%s: finish sync", __FUNCTION__);
 }
 
 /*
@@ -248,38 +232,40 @@ static void *make_sync(cl_thread_t *thread)
  */
 int sync_object(session_t *session)
 {
-    void *data;
-    cl_thread_t *thread;
     struct xante_app *xpp = session->xpp;
     struct xante_item *item = session->item;
-    struct sync_thread sync = {
-        .session = session,
-    };
+    struct xante_task *task = NULL;
+    struct sync_task *st = NULL;
 
-    /* Assures that we will be able to, at least, start the sync */
-    item->cancel_update = false;
-    data = event_item_custom_data(xpp, item);
-    sync.data = data;
-    thread = cl_thread_spawn(CL_THREAD_JOINABLE, make_sync, &sync);
+    st = calloc(1, sizeof(struct sync_task));
 
-    if (NULL == thread) {
+    if (NULL == st) {
         xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                             cl_tr("Sync thread creation error: %s"),
-                             cl_strerror(cl_get_last_error()));
+                             cl_tr("Sync task creation error: %s"),
+                             xante_strerror(XANTE_ERROR_NO_MEMORY));
 
         return DLG_EXIT_OK;
     }
 
-    if (cl_thread_wait_startup(thread) != 0) {
+    /* Assures that we will be able to, at least, start the sync */
+    __atomic_store_n(&item->cancel_update, false, __ATOMIC_RELEASE);
+    xante_item_ref(item);
+    st->xpp = xpp;
+    st->item = item;
+    st->data = event_item_custom_data(xpp, item);
+    task = executor_submit(xpp, call_task, st, release_sync_task);
+
+    if (NULL == task) {
         xante_dlg_messagebox(xpp, XANTE_MSGBOX_ERROR, cl_tr("Error"),
-                             cl_tr("Error waiting for thread to initialize: %s"),
-                             cl_strerror(cl_get_last_error()));
+                             cl_tr("Sync task creation error: %s"),
+                             xante_strerror(xante_get_last_error()));
 
+        release_sync_task(st);
         return DLG_EXIT_OK;
     }
 
-    /* Since there is a thread-join here it will wait for the thread to end. */
-    cl_thread_destroy(thread);
+    make_sync(session, task, st);
+    task_unref(task);
 
     return DLG_EXIT_OK;
 }
@@ -41,6 +41,7 @@ int tailbox(session_t *session)
     struct xante_app *xpp = session->xpp;
     struct xante_item *item = session->item;
     cl_object_t *value = NULL;
+    int ret_dialog = DLG_EXIT_OK;
 
     session->width = (item->geometry.width == 0) ? DIALOG_WIDTH
                                                  : item->geometry.width;
@@ -68,9 +69,21 @@ int tailbox(session_t *session)
         return DLG_EXIT_OK;
     }
 
-    return dialog_tailbox(cl_string_valueof(item->name),
-                          cl_string_valueof(session->text),
-                          session->height,
-                          session->width, false);
+    ret_dialog = dlgx_tailbox(session->width, session->height,
+                              cl_string_valueof(item->name),
+                              cl_string_valueof(session->text));
+
+    /* Without inotify support we fall back to the libdialog's polling tail */
+    if (ret_dialog == DLG_EXIT_ERROR) {
+        xante_log_debug("Unable to watch '%s', using the polling tailbox",
+                        cl_string_valueof(session->text));
+
+        ret_dialog = dialog_tailbox(cl_string_valueof(item->name),
+                                    cl_string_valueof(session->text),
+                                    session->height,
+                                    session->width, false);
+    }
+
+    return ret_dialog;
 }
 
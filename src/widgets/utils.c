@@ -48,6 +48,7 @@ char *widget_statusbar_text(enum xante_object type, bool editable,
                 break;
 
             case XANTE_WIDGET_PROGRESS:
+            case XANTE_WIDGET_MULTI_PROGRESS:
             case XANTE_WIDGET_SPINNER_SYNC:
             case XANTE_WIDGET_DOTS_SYNC:
                 t = cl_string_create_empty(0);
@@ -158,6 +159,10 @@ char *widget_statusbar_text(enum xante_object type, bool editable,
             cl_string_cat(t, "%s", cl_tr("Wait the process to end."));
             break;
 
+        case XANTE_WIDGET_MULTI_PROGRESS:
+            cl_string_cat(t, "%s", cl_tr("Wait all processes to end."));
+            break;
+
         case XANTE_WIDGET_SPINNER_SYNC:
         case XANTE_WIDGET_DOTS_SYNC:
             cl_string_cat(t, "%s",
@@ -114,6 +114,10 @@ typedef struct session {
     DIALOG_LISTITEM     *litems;    /** buildlist, checklist, dm_delete, menu */
     DIALOG_FORMITEM     *fitems;    /** mixedform */
 
+    /* Where the session memory starts inside the dialogs arena */
+    bool                arena_in_use;
+    size_t              arena_position;
+
     /* Dialog functions to run it */
     int                 (*run)(struct session *);
     bool                (*validate_result)(struct session *);
@@ -169,6 +173,12 @@ bool add_dm_value_changed(session_t *session);
 
 /* progress */
 int progress(session_t *session);
+struct xante_task *progress_routine_submit(struct xante_app *xpp,
+                                           struct xante_item *item,
+                                           void *data);
+
+/* multi-progress */
+int multi_progress(session_t *session);
 
 /* sync */
 int sync_object(session_t *session);
@@ -62,6 +62,8 @@ void yesno_update_value(session_t *session)
         item->value = cl_object_create(CL_INT, choice);
     else
         cl_object_set(item->value, choice);
+
+    item_value_updated(item);
 }
 
 /**
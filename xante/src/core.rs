@@ -15,6 +15,13 @@ use rcollections::object::ClObject;
 extern {
     fn xante_get_last_error() -> i32;
     fn xante_manager_single_run(xpp: *const u8, dialog: *const c_char) -> i32;
+    fn xante_manager_register_template(xpp: *const u8, name: *const c_char,
+                                       dialog: *const c_char) -> i32;
+    fn xante_manager_run_template(xpp: *const u8, name: *const c_char,
+                                  title: *const c_char,
+                                  default_value: *const c_char,
+                                  options: *const *const c_char,
+                                  total_options: i32) -> i32;
     fn xante_dlg_messagebox_ex(xpp: *const u8, msg_type: i32, title: *const c_char,
                                message: *const c_char) -> i32;
 }
@@ -77,6 +84,38 @@ impl XanteApp {
         }
     }
 
+    pub fn register_template(&self, name: &str, dialog: &str) -> i32 {
+        let n = CString::new(name).unwrap();
+        let d = CString::new(dialog).unwrap();
+
+        unsafe {
+            xante_manager_register_template(self.data, n.as_ptr(), d.as_ptr())
+        }
+    }
+
+    pub fn run_template(&self, name: &str, title: Option<&str>,
+                        default_value: Option<&str>,
+                        options: Option<&[&str]>) -> i32
+    {
+        let n = CString::new(name).unwrap();
+        let t = title.map(|s| CString::new(s).unwrap());
+        let v = default_value.map(|s| CString::new(s).unwrap());
+        let o: Vec<CString> = options.unwrap_or(&[])
+                                     .iter()
+                                     .map(|s| CString::new(*s).unwrap())
+                                     .collect();
+
+        let o_ptr: Vec<*const c_char> = o.iter().map(|s| s.as_ptr()).collect();
+
+        unsafe {
+            xante_manager_run_template(self.data, n.as_ptr(),
+                                       t.as_ref().map_or(std::ptr::null(), |s| s.as_ptr()),
+                                       v.as_ref().map_or(std::ptr::null(), |s| s.as_ptr()),
+                                       if options.is_some() { o_ptr.as_ptr() } else { std::ptr::null() },
+                                       o_ptr.len() as i32)
+        }
+    }
+
     pub fn new(arguments: *const c_void) -> Result<XanteApp, i32> {
         let xpp = match arguments::retrieve_pointer_argument(arguments, "xpp") {
             Ok(value) => value,
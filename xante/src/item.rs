@@ -55,6 +55,7 @@ pub enum XanteObject {
 	Mixedform,
 	Buildlist,
 	Spreadsheet,
+	MultiProgress,
 	Clock,
 }
 
@@ -127,7 +128,8 @@ impl XanteItem {
             28 => Some(XanteObject::Mixedform),
             29 => Some(XanteObject::Buildlist),
             30 => Some(XanteObject::Spreadsheet),
-            31 => Some(XanteObject::Clock),
+            31 => Some(XanteObject::MultiProgress),
+            32 => Some(XanteObject::Clock),
             _ => None,
         }
     }